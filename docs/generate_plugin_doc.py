@@ -23,7 +23,8 @@ SHAPE_ORDERING = [
     'shapegroup',
     'instance',
     'ellipsoids',
-    'ellipsoidsmesh'
+    'ellipsoidsmesh',
+    'spheres'
 ]
 
 BSDF_ORDERING = [
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/transform.h>
+#include <drjit/quaternion.h>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Keyframed (piecewise linear) affine transformation
+ *
+ * Each keyframe is decomposed into a scale/shear matrix, a rotation
+ * quaternion and a translation. Between two keyframes, these components are
+ * interpolated linearly (using spherical linear interpolation for the
+ * rotation). Before the first and after the last keyframe, the
+ * transformation is held constant.
+ *
+ * Evaluation is vectorized over the time argument, so that e.g. a wavefront
+ * of rays with different times can be transformed at once. The cost is
+ * linear in the number of keyframes, which is assumed to be small.
+ */
+template <typename Float_> struct AnimatedTransform {
+    using Float             = Float_;
+    using ScalarFloat       = dr::scalar_t<Float>;
+    using Mask              = dr::mask_t<Float>;
+    using ScalarVector3f    = Vector<ScalarFloat, 3>;
+    using ScalarPoint3f     = Point<ScalarFloat, 3>;
+    using ScalarMatrix3f    = dr::Matrix<ScalarFloat, 3>;
+    using ScalarQuaternion4f = dr::Quaternion<ScalarFloat>;
+    using ScalarBoundingBox3f = BoundingBox<ScalarPoint3f>;
+    using ScalarAffineTransform4f = Transform<Point<ScalarFloat, 4>, true>;
+    using AffineTransform4f = Transform<Point<Float, 4>, true>;
+
+    struct Keyframe {
+        ScalarFloat time;
+        ScalarMatrix3f scale;
+        ScalarQuaternion4f rotation;
+        ScalarVector3f translation;
+        ScalarAffineTransform4f transform;
+    };
+
+    AnimatedTransform() = default;
+
+    /// Create a static (single keyframe) animation
+    AnimatedTransform(const ScalarAffineTransform4f &transform) {
+        append(0.f, transform);
+    }
+
+    /**
+     * \brief Load an animation from a set of properties
+     *
+     * Keyframes are specified as transformations named <tt>name_0</tt>,
+     * <tt>name_1</tt>, etc., along with optional times <tt>time_0</tt>,
+     * <tt>time_1</tt>, etc. (by default, the keyframes are evenly spaced
+     * over the interval [0, 1]). Without keyframes, the static
+     * transformation \c name is used.
+     */
+    static AnimatedTransform from_properties(const Properties &props,
+                                             std::string_view name = "to_world") {
+        size_t count = 0;
+        while (props.has_property(std::string(name) + "_" + std::to_string(count)))
+            ++count;
+
+        if (count == 0)
+            return AnimatedTransform(props.get<ScalarAffineTransform4f>(
+                name, ScalarAffineTransform4f()));
+
+        if (props.has_property(name))
+            Throw("\"%s\" and keyframes \"%s_0\", \"%s_1\", ... cannot be "
+                  "specified at the same time!", name, name, name);
+
+        AnimatedTransform result;
+        for (size_t i = 0; i < count; ++i) {
+            std::string index = std::to_string(i);
+            ScalarFloat default_time =
+                count > 1 ? (ScalarFloat) i / (ScalarFloat) (count - 1) : 0.f;
+            result.append(
+                props.get<ScalarFloat>("time_" + index, default_time),
+                props.get<ScalarAffineTransform4f>(std::string(name) + "_" + index));
+        }
+        return result;
+    }
+
+    /// Append a keyframe (times must be strictly increasing)
+    void append(ScalarFloat time, const ScalarAffineTransform4f &transform) {
+        if (!m_keyframes.empty() && !(time > m_keyframes.back().time))
+            Throw("AnimatedTransform::append(): keyframe times must be "
+                  "strictly increasing!");
+
+        auto [scale, rotation, translation] =
+            dr::transform_decompose(transform.matrix);
+
+        // Interpolate along the shortest arc
+        if (!m_keyframes.empty() &&
+            dr::dot(rotation, m_keyframes.back().rotation) < 0.f)
+            rotation = -rotation;
+
+        m_keyframes.push_back({ time, scale, rotation, translation, transform });
+    }
+
+    /// Number of keyframes
+    size_t size() const { return m_keyframes.size(); }
+
+    /// Does the transformation change over time?
+    bool animated() const { return m_keyframes.size() > 1; }
+
+    /// Return a keyframe
+    const Keyframe &keyframe(size_t i) const { return m_keyframes[i]; }
+
+    /// Evaluate the transformation at the given time
+    AffineTransform4f eval(const Float &time) const {
+        return eval_impl<Float>(time);
+    }
+
+    /// Evaluate the transformation at the given (scalar) time
+    ScalarAffineTransform4f eval_scalar(ScalarFloat time) const {
+        return eval_impl<ScalarFloat>(time);
+    }
+
+    /**
+     * \brief Conservative bounds of \c bbox over the whole animation
+     *
+     * Each segment is sampled \c steps times. The result is padded to cover
+     * the deviation of rotating corners from the chords between samples.
+     */
+    ScalarBoundingBox3f transform_bbox(const ScalarBoundingBox3f &bbox,
+                                       size_t steps = 16) const {
+        ScalarBoundingBox3f result;
+        if (!bbox.valid() || m_keyframes.empty())
+            return result;
+
+        for (int i = 0; i < 8; ++i)
+            result.expand(m_keyframes[0].transform * bbox.corner(i));
+
+        ScalarFloat padding = 0.f;
+        for (size_t k = 0; k + 1 < m_keyframes.size(); ++k) {
+            const Keyframe &k0 = m_keyframes[k], &k1 = m_keyframes[k + 1];
+
+            for (size_t j = 1; j <= steps; ++j) {
+                ScalarFloat t = dr::lerp(k0.time, k1.time,
+                                         (ScalarFloat) j / (ScalarFloat) steps);
+                ScalarAffineTransform4f trafo = eval_scalar(t);
+                for (int i = 0; i < 8; ++i)
+                    result.expand(trafo * bbox.corner(i));
+            }
+
+            // Largest distance of a scaled corner from the rotation center
+            ScalarFloat radius = 0.f;
+            for (int i = 0; i < 8; ++i) {
+                ScalarVector3f c(bbox.corner(i));
+                radius = dr::maximum(radius, dr::maximum(dr::norm(k0.scale * c),
+                                                         dr::norm(k1.scale * c)));
+            }
+
+            ScalarFloat angle = 2.f * dr::safe_acos(dr::abs(dr::dot(k0.rotation, k1.rotation))),
+                        half_step = .5f * angle / (ScalarFloat) steps;
+            padding = dr::maximum(padding, radius * (1.f - dr::cos(half_step)));
+        }
+
+        result.min -= padding;
+        result.max += padding;
+        return result;
+    }
+
+private:
+    template <typename T>
+    Transform<Point<T, 4>, true> eval_impl(const T &time) const {
+        using Vector3     = Vector<T, 3>;
+        using Matrix3     = dr::Matrix<T, 3>;
+        using Matrix4     = dr::Matrix<T, 4>;
+        using Quaternion4 = dr::Quaternion<T>;
+        using Transform4  = Transform<Point<T, 4>, true>;
+
+        if (m_keyframes.empty())
+            return Transform4();
+        if (m_keyframes.size() == 1)
+            return Transform4(m_keyframes[0].transform);
+
+        // Find the segment containing 'time' (first/last segment outside)
+        const Keyframe &a = m_keyframes[0], &b = m_keyframes[1];
+        T t0 = a.time, t1 = b.time;
+        Matrix3 s0(a.scale), s1(b.scale);
+        Quaternion4 q0(a.rotation), q1(b.rotation);
+        Vector3 p0(a.translation), p1(b.translation);
+
+        for (size_t i = 1; i + 1 < m_keyframes.size(); ++i) {
+            const Keyframe &k0 = m_keyframes[i], &k1 = m_keyframes[i + 1];
+            dr::mask_t<T> m = time >= k0.time;
+            t0 = dr::select(m, T(k0.time), t0);
+            t1 = dr::select(m, T(k1.time), t1);
+            s0 = dr::select(m, Matrix3(k0.scale), s0);
+            s1 = dr::select(m, Matrix3(k1.scale), s1);
+            q0 = dr::select(m, Quaternion4(k0.rotation), q0);
+            q1 = dr::select(m, Quaternion4(k1.rotation), q1);
+            p0 = dr::select(m, Vector3(k0.translation), p0);
+            p1 = dr::select(m, Vector3(k1.translation), p1);
+        }
+
+        T alpha = dr::clip((time - t0) / (t1 - t0), 0.f, 1.f);
+
+        return Transform4(dr::transform_compose<Matrix4>(
+            dr::lerp(s0, s1, alpha), dr::slerp(q0, q1, alpha),
+            dr::lerp(p0, p1, alpha)));
+    }
+
+    std::vector<Keyframe> m_keyframes;
+};
+
+template <typename Float>
+std::ostream &operator<<(std::ostream &os, const AnimatedTransform<Float> &t) {
+    os << "AnimatedTransform[" << std::endl;
+    for (size_t i = 0; i < t.size(); ++i) {
+        os << "  time = " << t.keyframe(i).time << ": "
+           << string::indent(t.keyframe(i).transform.matrix, 2);
+        if (i + 1 < t.size())
+            os << ",";
+        os << std::endl;
+    }
+    os << "]";
+    return os;
+}
+
+NAMESPACE_END(mitsuba)
@@ -22,6 +22,22 @@ template <typename T> constexpr auto RayEpsilon = dr::Epsilon<T> * 1500;
 template <typename T> constexpr auto ShadowEpsilon = RayEpsilon<T> * 10;
 template <typename T> constexpr auto ShapeEpsilon = RayEpsilon<T> / 80;
 
+/// Unit roundoff of the arithmetic used by the ray tracing backend
+#if (MI_ENABLE_EMBREE)
+template <typename T> constexpr auto TraceEpsilon = dr::Epsilon<dr::float32_array_t<T>>;
+#else
+template <typename T> constexpr auto TraceEpsilon =
+    dr::is_cuda_v<T> ? dr::Epsilon<dr::float32_array_t<T>> : dr::Epsilon<T>;
+#endif
+
+/**
+ * \brief Bound on the relative error of \c n consecutive floating point
+ * operations with unit roundoff \c eps (\f$\gamma_n\f$ in PBRT, Section 6.8)
+ */
+template <typename Scalar> constexpr Scalar error_gamma(int n, Scalar eps) {
+    return (n * eps) / (1 - n * eps);
+}
+
 //! @}
 // -----------------------------------------------------------------------
 
@@ -142,6 +142,20 @@ public:
      */
     virtual void parameters_changed(const std::vector<std::string> &/*keys*/ = {});
 
+    /**
+     * \brief Return the number of bytes of storage held by this instance
+     * that is not exposed via \ref traverse()
+     *
+     * Arrays that are reachable through \ref traverse() (e.g. mesh buffers
+     * or texture data) are accounted for by the caller, hence this function
+     * only needs to report private storage such as acceleration data
+     * structures, sampling tables or film storage. It is used to compute the
+     * memory report of a scene.
+     *
+     * \remark The default implementation returns zero.
+     */
+    virtual size_t memory_usage() const;
+
     /**
      * \brief Return a human-readable string representation of the object's
      * contents.
@@ -293,6 +293,84 @@ template <typename Scalar_> struct Resampler {
     }
 
 
+    /**
+     * \brief Resample the rows of a densely packed row-major array
+     *
+     * This is the counterpart of \ref resample() for the slow axis of an
+     * image (i.e. vertical resampling). Rather than filtering one column at a
+     * time, which accesses memory with a stride of an entire row per tap,
+     * each target row is accumulated from \ref taps() contiguous source rows.
+     * The inner loops thus stream through memory and are amenable to
+     * auto-vectorization. The work is split into tiles of columns, so that
+     * the accumulator and the touched parts of the source rows stay in cache.
+     *
+     * \param source
+     *     Source array consisting of <tt>source_resolution()</tt> rows
+     * \param target
+     *     Target array consisting of <tt>target_resolution()</tt> rows
+     * \param row_size
+     *     Number of values per row (e.g. width times channel count)
+     * \param begin
+     *     First value (column) of each row that should be processed
+     * \param end
+     *     One past the last value of each row that should be processed
+     */
+    void resample_rows(const Scalar *source, Scalar *target, size_t row_size,
+                       size_t begin, size_t end) const {
+        constexpr size_t TileSize = 512;
+        const uint32_t taps = m_taps, half_taps = m_taps / 2;
+        const Scalar min = std::get<0>(m_clamp);
+        const Scalar max = std::get<1>(m_clamp);
+        const bool clamp =
+            m_clamp != std::make_pair(-std::numeric_limits<Scalar>::infinity(),
+                                       std::numeric_limits<Scalar>::infinity());
+        Scalar accum[TileSize];
+
+        for (size_t tile = begin; tile < end; tile += TileSize) {
+            const size_t size = std::min(TileSize, end - tile);
+
+            for (uint32_t i = 0; i < m_target_res; ++i) {
+                const Scalar *weights = m_start ? m_weights.get() + i * taps
+                                                : m_weights.get();
+                const int32_t offset =
+                    m_start ? m_start[i] : ((int32_t) i - (int32_t) half_taps);
+
+                for (size_t k = 0; k < size; ++k)
+                    accum[k] = Scalar(0);
+
+                for (uint32_t j = 0; j < taps; ++j) {
+                    const Scalar weight = weights[j];
+                    int32_t pos = offset + (int32_t) j;
+
+                    if (unlikely(pos < 0 || pos >= (int32_t) m_source_res)) {
+                        if (m_bc == FilterBoundaryCondition::Zero)
+                            continue;
+                        if (m_bc == FilterBoundaryCondition::One) {
+                            for (size_t k = 0; k < size; ++k)
+                                accum[k] += weight;
+                            continue;
+                        }
+                        pos = wrap(pos);
+                    }
+
+                    const Scalar *row = source + (size_t) pos * row_size + tile;
+                    for (size_t k = 0; k < size; ++k)
+                        accum[k] += row[k] * weight;
+                }
+
+                Scalar *row = target + (size_t) i * row_size + tile;
+                if (clamp) {
+                    for (size_t k = 0; k < size; ++k)
+                        row[k] = dr::template clip<Scalar>(accum[k], min, max);
+                } else {
+                    for (size_t k = 0; k < size; ++k)
+                        row[k] = accum[k];
+                }
+            }
+        }
+    }
+
+
     /// Return a human-readable summary
     std::string to_string() const {
         return tfm::format("Resampler[source_res=%i, target_res=%i]",
@@ -378,31 +456,38 @@ private:
     Scalar lookup(const Scalar *source, int32_t pos, uint32_t stride, uint32_t ch) const {
         if (unlikely(pos < 0 || pos >= (int32_t) m_source_res)) {
             switch (m_bc) {
-                case FilterBoundaryCondition::Clamp:
-                    pos = dr::clip(pos, 0, (int32_t) m_source_res - 1);
-                    break;
-
-                case FilterBoundaryCondition::Repeat:
-                    pos = math::modulo(pos, (int32_t) m_source_res);
-                    break;
-
-                case FilterBoundaryCondition::Mirror:
-                    pos = math::modulo(pos, 2 * (int32_t) m_source_res - 2);
-                    if (pos >= (int32_t) m_source_res - 1)
-                        pos = 2 * m_source_res - 2 - pos;
-                    break;
-
                 case FilterBoundaryCondition::One:
                     return Scalar(1);
 
                 case FilterBoundaryCondition::Zero:
                     return Scalar(0);
+
+                default:
+                    pos = wrap(pos);
+                    break;
             }
         }
 
         return source[pos * stride + ch];
     }
 
+    /// Map an out-of-range position according to the Clamp/Repeat/Mirror boundary condition
+    int32_t wrap(int32_t pos) const {
+        switch (m_bc) {
+            case FilterBoundaryCondition::Repeat:
+                return math::modulo(pos, (int32_t) m_source_res);
+
+            case FilterBoundaryCondition::Mirror:
+                pos = math::modulo(pos, 2 * (int32_t) m_source_res - 2);
+                if (pos >= (int32_t) m_source_res - 1)
+                    pos = 2 * m_source_res - 2 - pos;
+                return pos;
+
+            default:
+                return dr::clip(pos, 0, (int32_t) m_source_res - 1);
+        }
+    }
+
 private:
     std::unique_ptr<int32_t[]> m_start;
     std::unique_ptr<Scalar[]> m_weights;
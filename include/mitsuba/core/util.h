@@ -18,6 +18,122 @@ NAMESPACE_BEGIN(util)
 /// Determine the number of available CPU cores (including virtual cores)
 extern MI_EXPORT_LIB int core_count();
 
+/// Placement policy of read-only scene data on NUMA machines
+enum class NumaPolicy : uint32_t {
+    /// Keep the default first-touch placement of the operating system
+    None,
+
+    /// Interleave pages across all NUMA nodes
+    Interleave,
+
+    /// Keep a per-node replica of the acceleration data structure
+    Replicate
+};
+
+/// Return the number of NUMA nodes (1 on platforms without NUMA support)
+extern MI_EXPORT_LIB int numa_node_count();
+
+/**
+ * \brief Return the NUMA node of the calling thread
+ *
+ * Threads pinned via \ref numa_pin_thread() report the node they were pinned
+ * to. Otherwise, the node of the CPU that currently executes the thread is
+ * returned (or 0 if this cannot be determined).
+ */
+extern MI_EXPORT_LIB int numa_node_current();
+
+/**
+ * \brief Return the NUMA node that the calling thread was pinned to via
+ * \ref numa_pin_thread() or \ref ScopedNumaPin, or <tt>-1</tt>
+ *
+ * Unlike \ref numa_node_current(), this only reads a thread-local variable
+ * and is therefore cheap enough to be queried for every ray.
+ */
+extern MI_EXPORT_LIB int numa_node_pinned();
+
+/**
+ * \brief Restrict the calling thread to the CPUs of the given NUMA node
+ *
+ * Returns \c false if the affinity could not be changed (e.g. on platforms
+ * without NUMA support), in which case the thread is left untouched.
+ */
+extern MI_EXPORT_LIB bool numa_pin_thread(int node);
+
+/**
+ * \brief Pin the calling thread to a NUMA node for the lifetime of this object
+ *
+ * The previous CPU affinity is restored on destruction. This is meant for
+ * parallel loops that may also run on threads outside of the thread pool
+ * (e.g. the main or Python thread), which must not stay restricted.
+ */
+class MI_EXPORT_LIB ScopedNumaPin {
+public:
+    ScopedNumaPin(int node);
+    ~ScopedNumaPin();
+
+    ScopedNumaPin(const ScopedNumaPin &) = delete;
+    ScopedNumaPin &operator=(const ScopedNumaPin &) = delete;
+
+private:
+    void *m_saved_affinity = nullptr;
+    size_t m_size = 0;
+    int m_prev_node = -1;
+};
+
+/**
+ * \brief Set the NUMA placement policy of an existing memory region
+ *
+ * Only pages that are fully contained in the region are affected. Pages that
+ * were already touched are migrated. The region must own its pages (e.g.
+ * because it was obtained from \ref alloc_pages()), since the policy would
+ * otherwise carry over to unrelated heap allocations that reuse them.
+ *
+ * \param node
+ *     When set to <tt>-1</tt>, the pages are interleaved across all NUMA
+ *     nodes. Otherwise, they are bound to the specified node.
+ *
+ * \return \c false if the policy could not be applied (e.g. on platforms
+ * without NUMA support)
+ */
+extern MI_EXPORT_LIB bool numa_place(const void *ptr, size_t size, int node = -1);
+
+/// Page size policy for large, randomly accessed allocations
+enum class HugePages : uint32_t {
+    /// Use ordinary pages
+    None,
+
+    /// Request transparent huge pages (<tt>madvise(MADV_HUGEPAGE)</tt>)
+    Transparent,
+
+    /// Use explicitly reserved huge pages (<tt>MAP_HUGETLB</tt>) and fall
+    /// back to transparent huge pages when none are available
+    Explicit
+};
+
+/**
+ * \brief Allocate a memory region of the given size in bytes
+ *
+ * The region is mapped directly rather than taken from the heap, so that it
+ * owns its pages. When \c mode is not \ref HugePages::None, it is mapped at
+ * a 2 MiB boundary so that it can be backed by huge pages. On platforms
+ * without such mappings, this falls back to an ordinary heap allocation.
+ * Throws <tt>std::bad_alloc</tt> when no memory is available.
+ */
+extern MI_EXPORT_LIB void *alloc_pages(size_t size, HugePages mode);
+
+/// Release a memory region previously obtained from \ref alloc_pages()
+extern MI_EXPORT_LIB void free_pages(void *ptr, size_t size, HugePages mode);
+
+/**
+ * \brief Request transparent huge pages for an existing memory region
+ *
+ * Only the 2 MiB-aligned interior of the region is affected.
+ *
+ * \return \c false if the request could not be applied (e.g. because the
+ * region is too small or the platform lacks huge page support)
+ */
+extern MI_EXPORT_LIB bool advise_huge_pages(const void *ptr, size_t size);
+
 /**
  * \brief Convert a time difference (in seconds) to a string representation
  * \param time Time difference in (fractional) sections
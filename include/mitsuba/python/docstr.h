@@ -3882,6 +3882,28 @@ static const char *__doc_mitsuba_Film_put_block =
 R"doc(Merge an image block into the film. This methods should be thread-
 safe.)doc";
 
+static const char *__doc_mitsuba_Film_put_sample =
+R"doc(Accumulate a sample into an image block created by this film
+
+Integrators use this method to splat samples when the Film has the
+``Special`` flag enabled. The default implementation converts the
+sample using prepare_sample() and accumulates all channels of the
+image block. Films whose samples only touch a few of their channels
+can override it to splat just those channels.
+
+Parameter ``block``:
+    Image block created using create_block()
+
+Parameter ``pos``:
+    Sample position in fractional pixel coordinates
+
+Parameter ``aovs``:
+    Points to an array of length ImageBlock::channel_count(). The AOV
+    entries must be filled in by the caller, the remaining entries are
+    used as scratch space.
+
+The remaining parameters are as in prepare_sample().)doc";
+
 static const char *__doc_mitsuba_Film_rfilter = R"doc(Return the image reconstruction filter (const version))doc";
 
 static const char *__doc_mitsuba_Film_sample_border =
@@ -3941,6 +3963,15 @@ static const char *__doc_mitsuba_Film_variant_name = R"doc()doc";
 
 static const char *__doc_mitsuba_Film_write = R"doc(Write the developed contents of the film to a file on disk)doc";
 
+static const char *__doc_mitsuba_Film_write_bitmap =
+R"doc(Convert and write a bitmap returned by bitmap() to a file on disk,
+using the file and component format of the film
+
+Unlike write(), this function does not access the film storage. It
+can therefore run on a background thread while the film (or another
+film) is used for the next render. The default implementation writes
+the bitmap as-is.)doc";
+
 static const char *__doc_mitsuba_FilterBoundaryCondition =
 R"doc(When resampling data to a different resolution using
 Resampler::resample(), this enumeration specifies how lookups
@@ -4428,8 +4459,30 @@ Parameter ``values``:
     Points to an array of length channel_count(), which specifies the
     sample value for each channel.)doc";
 
+static const char *__doc_mitsuba_ImageBlock_put_3 =
+R"doc(Accumulate a single sample or a wavefront of samples into a subset of
+the channels of the image block.
+
+This is useful when a sample only touches a few of many channels (e.g.
+the spectral bins of a film), since the remaining channels are neither
+evaluated nor splatted.
+
+Parameter ``pos``:
+    Denotes the sample position in fractional pixel coordinates
+
+Parameter ``values``:
+    Points to an array of length ``count`` with the sample values
+
+Parameter ``channels``:
+    Points to an array of length ``count``, whose entry ``k``
+    specifies the channel receiving ``values[k]``. In vectorized
+    variants, this index may differ between the entries of a
+    wavefront. The remaining channels are left unchanged.)doc";
+
 static const char *__doc_mitsuba_ImageBlock_put_block = R"doc(Accumulate another image block into this one)doc";
 
+static const char *__doc_mitsuba_ImageBlock_put_impl = R"doc()doc";
+
 static const char *__doc_mitsuba_ImageBlock_read =
 R"doc(Fetch a single sample or a wavefront of samples from the image block.
 
@@ -4787,7 +4840,15 @@ static const char *__doc_mitsuba_Interaction_offset_p =
 R"doc(Compute an offset position, used when spawning a ray from this
 interaction. When the interaction is on the surface of a shape, the
 position is offset along the surface normal to prevent self
-intersection.)doc";
+intersection.
+
+When the shape provided an error bound for the position, the offset is
+at least the projection of that bound onto the normal (plus the
+rounding error of the offset itself). This matters in double precision
+variants, where the ray tracing backend may intersect in single
+precision and the epsilon-based offset is then too small. The offset
+never drops below the epsilon-based one, since the intersection
+routines don't reject hits within their own error bounds.)doc";
 
 static const char *__doc_mitsuba_Interaction_operator_assign = R"doc(//! @})doc";
 
@@ -4795,6 +4856,13 @@ static const char *__doc_mitsuba_Interaction_operator_assign_2 = R"doc(//! @})do
 
 static const char *__doc_mitsuba_Interaction_p = R"doc(Position of the interaction in world coordinates)doc";
 
+static const char *__doc_mitsuba_Interaction_p_error =
+R"doc(Conservative bound on the floating point error of ``p``
+
+Bounds the error of each component of the position, including the
+rounding performed by the ray tracing backend. Only computed by
+triangle meshes in double precision variants, and zero otherwise.)doc";
+
 static const char *__doc_mitsuba_Interaction_spawn_ray = R"doc(Spawn a semi-infinite ray towards the given direction)doc";
 
 static const char *__doc_mitsuba_Interaction_spawn_ray_to = R"doc(Spawn a finite ray towards the given position)doc";
@@ -6170,6 +6238,19 @@ supported by any Mitsuba object, hence it is located this level.)doc";
 
 static const char *__doc_mitsuba_Object_id = R"doc(Return an identifier of the current instance (or empty if none))doc";
 
+static const char *__doc_mitsuba_Object_memory_usage =
+R"doc(Return the number of bytes of storage held by this instance that is
+not exposed via traverse()
+
+Arrays that are reachable through traverse() (e.g. mesh buffers or
+texture data) are accounted for by the caller, hence this function
+only needs to report private storage such as acceleration data
+structures, sampling tables or film storage. It is used to compute the
+memory report of a scene.
+
+Remark:
+    The default implementation returns zero.)doc";
+
 static const char *__doc_mitsuba_Object_parameters_changed =
 R"doc(Update internal state after applying changes to parameters
 
@@ -7860,6 +7941,33 @@ Parameter ``channels``:
 
 static const char *__doc_mitsuba_Resampler_resample_internal = R"doc()doc";
 
+static const char *__doc_mitsuba_Resampler_resample_rows =
+R"doc(Resample the rows of a densely packed row-major array
+
+This is the counterpart of resample() for the slow axis of an image
+(i.e. vertical resampling). Rather than filtering one column at a
+time, which accesses memory with a stride of an entire row per tap,
+each target row is accumulated from taps() contiguous source rows. The
+inner loops thus stream through memory and are amenable to
+auto-vectorization. The work is split into tiles of columns, so that
+the accumulator and the touched parts of the source rows stay in
+cache.
+
+Parameter ``source``:
+    Source array consisting of ``source_resolution()`` rows
+
+Parameter ``target``:
+    Target array consisting of ``target_resolution()`` rows
+
+Parameter ``row_size``:
+    Number of values per row (e.g. width times channel count)
+
+Parameter ``begin``:
+    First value (column) of each row that should be processed
+
+Parameter ``end``:
+    One past the last value of each row that should be processed)doc";
+
 static const char *__doc_mitsuba_Resampler_set_boundary_condition =
 R"doc(Set the boundary condition that should be used when looking up samples
 outside of the defined input domain
@@ -7876,6 +7984,8 @@ static const char *__doc_mitsuba_Resampler_target_resolution = R"doc(Return the
 
 static const char *__doc_mitsuba_Resampler_to_string = R"doc(Return a human-readable summary)doc";
 
+static const char *__doc_mitsuba_Resampler_wrap = R"doc(Map an out-of-range position according to the Clamp/Repeat/Mirror boundary condition)doc";
+
 static const char *__doc_mitsuba_SGGXPhaseFunctionParams =
 R"doc(The parameters of the SGGX phase function stored as a pair of 3D
 vectors [[S_xx, S_yy, S_zz], [S_xy, S_xz, S_yz]])doc";
@@ -8184,6 +8294,14 @@ static const char *__doc_mitsuba_Scene_accel_release_gpu = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_bbox = R"doc(Return a bounding box surrounding the scene)doc";
 
+static const char *__doc_mitsuba_Scene_check_memory_budget =
+R"doc(Raise an exception with a breakdown of the memory report if the scene
+storage exceeds ``budget`` bytes
+
+This is invoked by the constructor when the ``memory_budget`` property
+(in MiB) is specified, so that jobs which would run out of memory fail
+before rendering starts.)doc";
+
 static const char *__doc_mitsuba_Scene_class_name = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_clear_shapes_dirty = R"doc(Unmarks all shapes as dirty)doc";
@@ -8282,6 +8400,24 @@ static const char *__doc_mitsuba_Scene_m_silhouette_shapes_dr = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_m_thread_reordering = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_memory_budget = R"doc(Return the soft memory budget of the scene in bytes (0: unlimited))doc";
+
+static const char *__doc_mitsuba_Scene_memory_report =
+R"doc(Return the storage used by the scene, grouped by category
+
+The report accounts for the arrays that the scene objects expose via
+traverse() (mesh buffers, texture and volume data, ...), their private
+storage (see Object::memory_usage()), the acceleration data structure
+and the spectral upsampling tables. Categories are named after the
+type of the owning object (e.g. a texture nested in a BSDF counts
+towards ``"textures"``): ``"acceleration"``, ``"shapes"``,
+``"textures"``, ``"volumes"``, ``"bsdfs"``, ``"emitters"``,
+``"media"``, ``"sensors"``, ``"film"``, ``"integrator"``,
+``"spectral_tables"`` and ``"other"``. Empty categories are omitted.
+
+The film storage is only allocated when rendering starts; until then,
+its size is estimated without any AOVs.)doc";
+
 static const char *__doc_mitsuba_Scene_parameters_changed = R"doc(Update internal state following a parameter update)doc";
 
 static const char *__doc_mitsuba_Scene_pdf_emitter =
@@ -9216,6 +9352,17 @@ Parameter ``texture``:
     Texture to store. The dimensionality of the attribute is simply
     the channel count of the texture.)doc";
 
+static const char *__doc_mitsuba_Shape_attribute_id =
+R"doc(Return a compact handle that identifies the attribute ``name``
+
+Attribute names are interned in a process-wide registry, hence the
+same name always maps to the same handle. Callers that evaluate an
+attribute repeatedly (e.g. the ``mesh_attribute`` texture) should
+resolve the handle once and use the ``eval_attribute*_by_id()``
+variants, which avoid hashing the attribute name on every query.)doc";
+
+static const char *__doc_mitsuba_Shape_attribute_name = R"doc(Return the attribute name associated with a handle from attribute_id())doc";
+
 static const char *__doc_mitsuba_Shape_bbox =
 R"doc(Return an axis aligned box that bounds all shape primitives (including
 any transformations that may have been applied to them))doc";
@@ -9348,6 +9495,8 @@ Parameter ``si``:
 Returns:
     An scalar intensity or reflectance value)doc";
 
+static const char *__doc_mitsuba_Shape_eval_attribute_1_by_id = R"doc(Variant of eval_attribute_1() taking a handle from attribute_id())doc";
+
 static const char *__doc_mitsuba_Shape_eval_attribute_3 =
 R"doc(Trichromatic evaluation of a shape attribute at the given surface
 interaction
@@ -9365,6 +9514,10 @@ Parameter ``si``:
 Returns:
     A trichromatic intensity or reflectance value)doc";
 
+static const char *__doc_mitsuba_Shape_eval_attribute_3_by_id = R"doc(Variant of eval_attribute_3() taking a handle from attribute_id())doc";
+
+static const char *__doc_mitsuba_Shape_eval_attribute_by_id = R"doc(Variant of eval_attribute() taking a handle from attribute_id())doc";
+
 static const char *__doc_mitsuba_Shape_eval_attribute_x =
 R"doc(Evaluate a dynamically sized shape attribute at the given surface
 interaction.
@@ -9678,6 +9831,10 @@ This operation is used by the KDTree acceleration structure.
 Parameter ``ray``:
     The ray to be tested for an intersection
 
+Parameter ``prim_index``:
+    Index of the primitive to be intersected (only relevant for shapes
+    consisting of several non-triangle primitives)
+
 Returns:
     A tuple containing the following field: ``t``, ``uv``,
     ``shape_index``, ``prim_index``. The ``shape_index`` should be
@@ -11183,6 +11340,15 @@ Parameter ``si``:
 Returns:
     An trichromatic intensity or reflectance value)doc";
 
+static const char *__doc_mitsuba_Texture_is_constant =
+R"doc(Does this texture evaluate to the same value everywhere?
+
+This requires that the value neither depends on the surface position
+nor on the wavelengths of the current variant. Objects using such a
+texture can evaluate it once (with an arbitrary interaction record)
+and fold the result into their own parameters. The default
+implementation conservatively returns ``False``.)doc";
+
 static const char *__doc_mitsuba_Texture_is_spatially_varying = R"doc(Does this texture evaluation depend on the UV coordinates)doc";
 
 static const char *__doc_mitsuba_Texture_max =
@@ -77,6 +77,17 @@ public:
     /// Write the developed contents of the film to a file on disk
     virtual void write(const fs::path &path) const = 0;
 
+    /**
+     * \brief Convert and write a bitmap returned by \ref bitmap() to a file
+     * on disk, using the file and component format of the film
+     *
+     * Unlike \ref write(), this function does not access the film storage.
+     * It can therefore run on a background thread while the film (or another
+     * film) is used for the next render. The default implementation writes
+     * the bitmap as-is.
+     */
+    virtual void write_bitmap(const Bitmap *bitmap, const fs::path &path) const;
+
     /// dr::schedule() variables that represent the internal film storage
     virtual void schedule_storage() = 0;
 
@@ -117,6 +128,34 @@ public:
                                 Float alpha = 1.f,
                                 Mask active = true) const;
 
+    /**
+     * \brief Accumulate a sample into an image block created by this film
+     *
+     * Integrators use this method to splat samples when the Film has the
+     * ``Special`` flag enabled. The default implementation converts the
+     * sample using \ref prepare_sample() and accumulates all channels of the
+     * image block. Films whose samples only touch a few of their channels
+     * can override it to splat just those channels.
+     *
+     * \param block
+     *    Image block created using \ref create_block()
+     *
+     * \param pos
+     *    Sample position in fractional pixel coordinates
+     *
+     * \param aovs
+     *    Points to an array of length \ref ImageBlock::channel_count(). The
+     *    AOV entries must be filled in by the caller, the remaining entries
+     *    are used as scratch space.
+     *
+     * The remaining parameters are as in \ref prepare_sample().
+     */
+    virtual void put_sample(ImageBlock *block, const Point2f &pos,
+                            const UnpolarizedSpectrum &spec,
+                            const Wavelength &wavelengths, Float *aovs,
+                            Float weight = 1.f, Float alpha = 1.f,
+                            Mask active = true) const;
+
     /**
      * \brief Return an \ref ImageBlock instance, whose internal representation
      * is compatible with that of the film.
@@ -203,6 +242,13 @@ public:
     void traverse(TraversalCallback *callback) override;
     void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override;
 
+    /**
+     * \brief Return an estimate of the film storage, i.e. the base channels
+     * and a weight channel for each pixel of the crop window (AOVs are only
+     * known once \ref prepare() is called)
+     */
+    size_t memory_usage() const override;
+
     //! @}
     // =============================================================
 
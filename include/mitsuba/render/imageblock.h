@@ -227,6 +227,29 @@ public:
      */
     void put(const Point2f &pos, const Float *values, Mask active = true);
 
+    /**
+     * \brief Accumulate a single sample or a wavefront of samples into a
+     * subset of the channels of the image block.
+     *
+     * This is useful when a sample only touches a few of many channels
+     * (e.g. the spectral bins of a film), since the remaining channels are
+     * neither evaluated nor splatted.
+     *
+     * \param pos
+     *    Denotes the sample position in fractional pixel coordinates
+     *
+     * \param values
+     *    Points to an array of length \c count with the sample values
+     *
+     * \param channels
+     *    Points to an array of length \c count, whose entry \c k specifies
+     *    the channel receiving <tt>values[k]</tt>. In vectorized variants,
+     *    this index may differ between the entries of a wavefront. The
+     *    remaining channels are left unchanged.
+     */
+    void put(const Point2f &pos, const Float *values, const UInt32 *channels,
+             uint32_t count, Mask active = true);
+
     /**
      * \brief Fetch a single sample or a wavefront of samples from the image
      * block.
@@ -333,6 +356,10 @@ protected:
     // Implementation detail to atomically accumulate a value into the image block
     void accum(Float value, UInt32 index, Bool active);
 
+    // Shared implementation of the two put() variants above
+    void put_impl(const Point2f &pos, const Float *values,
+                  const UInt32 *channels, uint32_t count, Mask active);
+
 protected:
     ScalarPoint2i m_offset;
     ScalarVector2u m_size;
@@ -565,6 +565,19 @@ public:
                         Sampler *sampler, ImageBlock *block,
                         ScalarFloat sample_scale) const = 0;
 
+    /**
+     * \brief Variant of \ref sample() that also receives the index of the
+     * sample, counted over all passes of the current render.
+     *
+     * The scalar rendering loop calls this function. The default
+     * implementation ignores \c index and forwards to \ref sample().
+     * Integrators that also trace paths starting at the sensor can override
+     * it to stratify their film positions over the pixels.
+     */
+    virtual void sample_indexed(const Scene *scene, const Sensor *sensor,
+                                Sampler *sampler, ImageBlock *block,
+                                ScalarFloat sample_scale, size_t index) const;
+
     // =========================================================================
     //! @{ \name Integrator interface implementation
     // =========================================================================
@@ -103,6 +103,15 @@ struct Interaction {
     /// Geometric normal (only valid for \c SurfaceInteraction)
     Normal3f n;
 
+    /**
+     * \brief Conservative bound on the floating point error of \c p
+     *
+     * Bounds the error of each component of the position, including the
+     * rounding performed by the ray tracing backend. Only computed by
+     * triangle meshes in double precision variants, and zero otherwise.
+     */
+    Float p_error = 0.f;
+
     //! @}
     // =============================================================
 
@@ -129,6 +138,7 @@ struct Interaction {
         wavelengths = dr::zeros<Wavelength>(size);
         p           = dr::zeros<Point3f>(size);
         n           = dr::zeros<Normal3f>(size);
+        p_error     = dr::zeros<Float>(size);
     }
 
     /// Is the current interaction valid?
@@ -154,16 +164,28 @@ struct Interaction {
     //! @}
     // =============================================================
 
-    DRJIT_STRUCT(Interaction, t, time, wavelengths, p, n);
+    DRJIT_STRUCT(Interaction, t, time, wavelengths, p, n, p_error);
 
 private:
     /**
      * Compute an offset position, used when spawning a ray from this
      * interaction. When the interaction is on the surface of a shape, the
      * position is offset along the surface normal to prevent self intersection.
+     *
+     * When the shape provided an error bound for the position, the offset
+     * is at least the projection of that bound onto the normal (plus the
+     * rounding error of the offset itself). This matters in double precision
+     * variants, where the ray tracing backend may intersect in single
+     * precision and the epsilon-based offset is then too small. The offset
+     * never drops below the epsilon-based one, since the intersection
+     * routines don't reject hits within their own error bounds.
      */
     Point3f offset_p(const Vector3f &d) const {
-        Float mag = (1.f + dr::max(dr::abs(p))) * math::RayEpsilon<Float>;
+        Float p_max = dr::max(dr::abs(p));
+        Float mag = dr::maximum(
+            (1.f + p_max) * math::RayEpsilon<Float>,
+            dr::fmadd(p_error, dr::sum(dr::abs(n)),
+                      p_max * (2 * dr::Epsilon<ScalarFloat>)));
         mag = dr::detach(dr::mulsign(mag, dr::dot(n, d)));
         return dr::fmadd(mag, dr::detach(n), p);
     }
@@ -524,7 +546,7 @@ struct SurfaceInteraction : Interaction<Float_, Spectrum_> {
     //! @}
     // =============================================================
 
-    DRJIT_STRUCT(SurfaceInteraction, t, time, wavelengths, p, n, shape, uv,
+    DRJIT_STRUCT(SurfaceInteraction, t, time, wavelengths, p, n, p_error, shape, uv,
                  sh_frame, dp_du, dp_dv, dn_du, dn_dv, duv_dx,
                  duv_dy, wi, prim_index, instance)
 };
@@ -609,7 +631,7 @@ struct MediumInteraction : Interaction<Float_, Spectrum_> {
     //! @}
     // =============================================================
 
-    DRJIT_STRUCT(MediumInteraction, t, time, wavelengths, p, n, medium,
+    DRJIT_STRUCT(MediumInteraction, t, time, wavelengths, p, n, p_error, medium,
                  sh_frame, wi, sigma_s, sigma_n, sigma_t,
                  combined_extinction, mint)
 };
@@ -25,6 +25,17 @@
 /// Grain size for parallelization
 #define MI_KD_GRAIN_SIZE 10240u
 
+/// Edge event lists with more entries than this are sorted in parallel
+#define MI_KD_PARALLEL_SORT_SIZE 65536u
+
+/**
+ * By default, kd-trees over double precision geometry are built from edge
+ * events with conservatively rounded single precision positions, which
+ * reduces the memory traffic of the O(N log N) builder. Define this macro to
+ * build from the exact double precision positions instead.
+ */
+// #define MI_KD_EXACT_DOUBLE_BUILD
+
 /**
  * Temporary scratch space that is used to cache intersection information
  * (# of floats)
@@ -34,6 +45,58 @@
 NAMESPACE_BEGIN(mitsuba)
 
 NAMESPACE_BEGIN(detail)
+/// Deleter for arrays that were allocated via \ref util::alloc_pages()
+template <typename T> struct PageDeleter {
+    size_t size = 0;
+    util::HugePages mode = util::HugePages::None;
+
+    void operator()(T *ptr) const { util::free_pages(ptr, size, mode); }
+};
+
+/// Array of trivially copyable elements backed by (potentially huge) pages
+template <typename T> using PageArray = std::unique_ptr<T[], PageDeleter<T>>;
+
+/// Allocate an uninitialized \ref PageArray with \c count entries
+template <typename T>
+PageArray<T> make_page_array(size_t count, util::HugePages mode) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "make_page_array(): elements are left uninitialized!");
+    size_t size = count * sizeof(T);
+    return PageArray<T>((T *) util::alloc_pages(size, mode),
+                        PageDeleter<T>{ size, mode });
+}
+
+/**
+ * \brief Joins an asynchronous task when leaving the enclosing scope
+ *
+ * Build tasks capture references to the stack frame that spawned them. If
+ * that frame is unwound by an exception, the task must be waited for before
+ * its captured state goes away; its own exception (if any) is then dropped in
+ * favor of the one in flight. On the regular path, \ref wait() propagates
+ * exceptions raised by the task.
+ */
+struct TaskGuard {
+    Task *task;
+
+    explicit TaskGuard(Task *task) : task(task) { }
+    TaskGuard(const TaskGuard &) = delete;
+    TaskGuard &operator=(const TaskGuard &) = delete;
+
+    void wait() {
+        Task *t = task;
+        task = nullptr;
+        task_wait_and_release(t);
+    }
+
+    ~TaskGuard() {
+        if (task) {
+            try {
+                task_wait_and_release(task);
+            } catch (...) { }
+        }
+    }
+};
+
 /**
  * During kd-tree construction, large amounts of memory are required to
  * temporarily hold index and edge event lists. When not implemented
@@ -57,6 +120,9 @@ public:
         m_chunks.clear();
     }
 
+    /// Set the page size policy of chunks that are allocated from now on
+    void set_huge_pages(util::HugePages mode) { m_huge_pages = mode; }
+
     /**
      * \brief Request a block of memory from the allocator
      *
@@ -77,7 +143,7 @@ public:
         /* No chunk had enough free memory */
         size_t alloc_size = std::max(size, m_min_allocation);
 
-        std::unique_ptr<uint8_t[]> data(new uint8_t[alloc_size]);
+        PageArray<uint8_t> data = make_page_array<uint8_t>(alloc_size, m_huge_pages);
         uint8_t *start = data.get(), *cur = start + size;
         m_chunks.emplace_back(std::move(data), cur, alloc_size);
 
@@ -160,11 +226,11 @@ public:
 
 private:
     struct Chunk {
-        std::unique_ptr<uint8_t[]> start;
+        PageArray<uint8_t> start;
         uint8_t *cur;
         size_t size;
 
-        Chunk(std::unique_ptr<uint8_t[]> &&start, uint8_t *cur, size_t size)
+        Chunk(PageArray<uint8_t> &&start, uint8_t *cur, size_t size)
             : start(std::move(start)), cur(cur), size(size) { }
 
         size_t used() const { return (size_t) (cur - start.get()); }
@@ -182,6 +248,7 @@ private:
     };
 
     size_t m_min_allocation;
+    util::HugePages m_huge_pages = util::HugePages::None;
     std::vector<Chunk> m_chunks;
 };
 
@@ -383,6 +450,16 @@ public:
     using SizedInt    = dr::uint_array_t<Scalar>;
     using IndexVector = std::vector<Index>;
 
+#if defined(MI_KD_EXACT_DOUBLE_BUILD)
+    using EventScalar = Scalar;
+#else
+    /// Precision of the edge event positions used by the O(N log N) builder
+    using EventScalar = std::conditional_t<sizeof(Scalar) == 8, float, Scalar>;
+#endif
+
+    /// Are edge event positions stored with a reduced precision?
+    static constexpr bool ReducedEvents = !std::is_same_v<EventScalar, Scalar>;
+
     static constexpr size_t Dimension     = Vector::Size;
     static constexpr int MantissaBits     = sizeof(Scalar) == 4 ? 23: 52;
     static constexpr int ExponentSignBits = sizeof(Scalar) == 4 ? 9 : 12;
@@ -460,12 +537,39 @@ public:
         m_exact_prim_threshold = value;
     }
 
+    /**
+     * \brief Return the number of primitives, above which both children of
+     * a node built by the O(n log n) method are constructed in parallel.
+     */
+    Size parallel_nlogn_threshold() const { return m_parallel_nlogn_threshold; }
+
+    /**
+     * \brief Specify the number of primitives, above which both children of
+     * a node built by the O(n log n) method are constructed in parallel.
+     *
+     * A value of zero builds each O(n log n) subtree on a single thread.
+     */
+    void set_parallel_nlogn_threshold(Size value) {
+        m_parallel_nlogn_threshold = value;
+    }
+
     /// Return the log level of kd-tree status messages
     LogLevel log_level() const { return m_log_level; }
 
     /// Return the log level of kd-tree status messages
     void set_log_level(LogLevel level) { m_log_level = level; }
 
+    /// Return the page size policy of the node/index arrays and build buffers
+    util::HugePages huge_pages() const { return m_huge_pages; }
+
+    /**
+     * \brief Specify the page size policy of the node/index arrays and of
+     * the temporary buffers used during the build
+     *
+     * Huge pages reduce TLB misses when traversing very large trees.
+     */
+    void set_huge_pages(util::HugePages mode) { m_huge_pages = mode; }
+
     bool ready() const { return (bool) m_nodes; }
 
     /// Return the bounding box of the entire kd-tree
@@ -626,36 +730,51 @@ protected:
      * When classifying primitives with respect to a split plane, a data structure
      * is needed to hold the tertiary result of this operation. This class
      * implements a compact storage (2 bits per entry) in the spirit of the
-     * std::vector<bool> specialization.
+     * std::vector<bool> specialization. Entries sharing a byte can be updated
+     * by several threads via \ref set_concurrent().
      */
     class ClassificationStorage {
     public:
         void resize(Size count) {
             if (count != m_count) {
-                m_buffer.reset(new uint8_t[(count + 3) / 4]);
+                m_buffer.reset(new std::atomic<uint8_t>[(count + 3) / 4]);
                 m_count = count;
             }
         }
 
         void set(Index index, PrimClassification value) {
             Assert(index < m_count);
-            uint8_t *ptr = m_buffer.get() + (index >> 2);
-            uint8_t shift = (index & 3) << 1;
-            *ptr = (*ptr & ~(3 << shift)) | ((uint8_t) value << shift);
+            std::atomic<uint8_t> &entry = m_buffer[index >> 2];
+            uint8_t shift = (index & 3) << 1,
+                    old_value = entry.load(std::memory_order_relaxed);
+            entry.store((old_value & ~(3 << shift)) | ((uint8_t) value << shift),
+                        std::memory_order_relaxed);
+        }
+
+        /// Like \ref set(), but safe when other threads update neighboring entries
+        void set_concurrent(Index index, PrimClassification value) {
+            Assert(index < m_count);
+            std::atomic<uint8_t> &entry = m_buffer[index >> 2];
+            uint8_t shift = (index & 3) << 1,
+                    old_value = entry.load(std::memory_order_relaxed);
+            while (!entry.compare_exchange_weak(
+                old_value, (old_value & ~(3 << shift)) | ((uint8_t) value << shift),
+                std::memory_order_relaxed))
+                ;
         }
 
         PrimClassification get(Index index) const {
             Assert(index < m_count);
-            uint8_t *ptr = m_buffer.get() + (index >> 2);
             uint8_t shift = (index & 3) << 1;
-            return PrimClassification((*ptr >> shift) & 3);
+            return PrimClassification(
+                (m_buffer[index >> 2].load(std::memory_order_relaxed) >> shift) & 3);
         }
 
         /// Return the size (in bytes)
         size_t size() const { return (m_count + 3) / 4; }
 
     private:
-        std::unique_ptr<uint8_t[]> m_buffer;
+        std::unique_ptr<std::atomic<uint8_t>[]> m_buffer;
         Size m_count = 0;
     };
 
@@ -671,6 +790,10 @@ protected:
         detail::OrderedChunkAllocator left_alloc;
         detail::OrderedChunkAllocator right_alloc;
         BuildContext *ctx = nullptr;
+        /// Classification storage of the running O(N log N) build
+        ClassificationStorage *classification = nullptr;
+        /// Is a parallel step waiting for the current classification?
+        bool classification_busy = false;
 
         ~LocalBuildContext() {
             Assert(left_alloc.used() == 0);
@@ -699,6 +822,7 @@ protected:
         Size nonempty_leaf_count = 0;
         Size max_depth = 0;
         Size prim_buckets[16] { };
+        util::HugePages huge_pages = util::HugePages::None;
 
         BuildContext(const Derived &derived) : derived(derived) { }
     };
@@ -742,7 +866,7 @@ protected:
         EdgeEvent() { }
 
         /// Create a new edge event
-        EdgeEvent(Type type, int axis, Scalar pos, Index index)
+        EdgeEvent(Type type, int axis, EventScalar pos, Index index)
          : pos(pos), index(index), type(type), axis((uint16_t) axis) { }
 
         /// Return a string representation
@@ -777,7 +901,7 @@ protected:
         bool valid() const { return axis != 7; }
 
         /// Plane position
-        Scalar pos;
+        EventScalar pos;
         /// Primitive index
         Index index;
         /// Event type: end/planar/start
@@ -788,9 +912,40 @@ protected:
 
     using EdgeEventVector = std::vector<EdgeEvent>;
 
-    static_assert(sizeof(Scalar) + sizeof(Index) + sizeof(uint32_t) ==
+    static_assert(sizeof(EventScalar) + sizeof(Index) + sizeof(uint32_t) ==
                   sizeof(EdgeEvent), "EdgeEvent has an unexpected size!");
 
+    /**
+     * \brief Write the edge events of the interval <tt>[min, max]</tt> of
+     * primitive \c index along \c axis to \c out, and return the new end
+     *
+     * When event positions have a reduced precision, the interval is rounded
+     * outwards. Splits are only ever placed on event positions, hence the
+     * resulting tree remains conservative with respect to the original
+     * geometry. A planar interval that can't be represented exactly turns
+     * into a start and end event.
+     */
+    static EdgeEvent *put_events(EdgeEvent *out, int axis, Scalar min,
+                                 Scalar max, Index index) {
+        EventScalar min_e = EventScalar(min), max_e = EventScalar(max);
+
+        if constexpr (ReducedEvents) {
+            if (Scalar(min_e) > min)
+                min_e = std::nextafter(min_e, -dr::Infinity<EventScalar>);
+            if (Scalar(max_e) < max)
+                max_e = std::nextafter(max_e, dr::Infinity<EventScalar>);
+        }
+
+        if (min_e == max_e) {
+            *out++ = EdgeEvent(EdgeEvent::Type::EdgePlanar, axis, min_e, index);
+        } else {
+            *out++ = EdgeEvent(EdgeEvent::Type::EdgeStart, axis, min_e, index);
+            *out++ = EdgeEvent(EdgeEvent::Type::EdgeEnd,   axis, max_e, index);
+        }
+
+        return out;
+    }
+
     /**
      * \brief Min-max binning data structure with parallel binning & partitioning steps
      *
@@ -1077,8 +1232,9 @@ protected:
      * At the top of the tree, it uses min-max-binning and parallel reductions
      * to create sufficient parallelism. When the number of elements is
      * sufficiently small, it switches to a more accurate O(N log N) builder
-     * which uses normal recursion on the stack (i.e. it does not spawn further
-     * parallel pieces of work).
+     * which mostly uses normal recursion on the stack. Only large subtrees of
+     * the O(N log N) builder spawn further parallel pieces of work, so that a
+     * few big subtrees of a spatially clustered scene don't serialize the build.
      */
     class BuildTask {
     public:
@@ -1239,10 +1395,10 @@ protected:
                 right_bounds, partition.right_bounds, m_depth + 1,
                 m_bad_refines, &right_cost);
 
-            Task *left_dr_task =
-                dr::do_async([&]() { left_task.execute(); });
+            TaskGuard left_dr_task(
+                dr::do_async([&]() { left_task.execute(); }));
             right_task.execute();
-            task_wait_and_release(left_dr_task);
+            left_dr_task.wait();
 
             /* ==================================================================== */
             /*                           Final decision                             */
@@ -1263,11 +1419,18 @@ protected:
             }
         }
 
-        /// Recursively run the O(N log N builder)
+        /**
+         * \brief Recursively run the O(N log N builder)
+         *
+         * The left child partitions the event list of its parent in place.
+         * When \c shared_events is set, this list belongs to the allocator of
+         * another thread (see \ref build_nlogn_detached()) and is not resized.
+         */
         Scalar build_nlogn(Index node, Size prim_count,
                            EdgeEvent *events_start, EdgeEvent *events_end,
                            const BoundingBox &bbox, Size depth,
-                           Size bad_refines, bool left_child = true) {
+                           Size bad_refines, bool left_child = true,
+                           bool shared_events = false) {
             const Derived &derived = m_ctx.derived;
 
             /* Initialize the tree cost model */
@@ -1332,8 +1495,9 @@ protected:
                 right_count[axis] -= num_planar + num_end;
 
                 /* Check if the edge event is out of bounds -- when primitive
-                   clipping is active, this should never happen! */
-                Assert(!(derived.clip_primitives() &&
+                   clipping is active, this should never happen! (except for
+                   the outward rounding of reduced precision events) */
+                Assert(ReducedEvents || !(derived.clip_primitives() &&
                          (pos < bbox.min[axis] || pos > bbox.max[axis])));
 
                 /* Calculate a score using the tree construction heuristic */
@@ -1405,45 +1569,38 @@ protected:
             /*                      Primitive Classification                        */
             /* ==================================================================== */
 
-            auto &classification = m_local.classification_storage;
+            auto &classification = *m_local.classification;
+            EdgeEvent *axis_start = events_by_dimension[best.axis],
+                      *axis_end   = events_by_dimension[best.axis + 1];
 
-            /* Initially mark all prims as being located on both sides */
-            for (auto event = events_by_dimension[best.axis];
-                 event != events_by_dimension[best.axis + 1]; ++event)
-                classification.set(event->index, PrimClassification::Both);
+            /* Large nodes are classified and partitioned by several threads */
+            Size parallel_threshold = derived.parallel_nlogn_threshold();
+            bool parallel = parallel_threshold > 0 && prim_count >= parallel_threshold &&
+                            Size(events_end - events_start) > MI_KD_GRAIN_SIZE;
 
             Size prims_left = 0, prims_right = 0;
-            for (auto event = events_by_dimension[best.axis];
-                 event != events_by_dimension[best.axis + 1]; ++event) {
+            if (parallel) {
+                /* Keep build tasks that this thread runs while waiting from
+                   overwriting the classification (see ClassificationScope) */
+                m_local.classification_busy = true;
+                classify_parallel(axis_start, axis_end, best, prims_left,
+                                  prims_right);
+            } else {
+                /* Initially mark all prims as being located on both sides */
+                for (auto event = axis_start; event != axis_end; ++event)
+                    classification.set(event->index, PrimClassification::Both);
+
+                for (auto event = axis_start; event != axis_end; ++event) {
+                    PrimClassification value = classify(*event, best);
+                    if (value == PrimClassification::Both)
+                        continue;
 
-                if (event->type == EdgeEvent::Type::EdgeEnd &&
-                    event->pos <= best.split) {
-                    /* Fully on the left side (the primitive's interval ends
-                       before (or on) the split plane) */
-                    Assert(classification.get(event->index) == PrimClassification::Both);
-                    classification.set(event->index, PrimClassification::Left);
-                    prims_left++;
-                } else if (event->type == EdgeEvent::Type::EdgeStart &&
-                           event->pos >= best.split) {
-                    /* Fully on the right side (the primitive's interval
-                       starts after (or on) the split plane) */
-                    Assert(classification.get(event->index) == PrimClassification::Both);
-                    classification.set(event->index, PrimClassification::Right);
-                    prims_right++;
-                } else if (event->type == EdgeEvent::Type::EdgePlanar) {
-                    /* If the planar primitive is not on the split plane,
-                       the classification is easy. Otherwise, place it on
-                       the side with the lower cost */
                     Assert(classification.get(event->index) == PrimClassification::Both);
-                    if (event->pos < best.split ||
-                        (event->pos == best.split && best.planar_left)) {
-                        classification.set(event->index, PrimClassification::Left);
+                    classification.set(event->index, value);
+                    if (value == PrimClassification::Left)
                         prims_left++;
-                    } else if (event->pos > best.split ||
-                               (event->pos == best.split && !best.planar_left)) {
-                        classification.set(event->index, PrimClassification::Right);
+                    else
                         prims_right++;
-                    }
                 }
             }
 
@@ -1486,26 +1643,34 @@ protected:
 
             if (prims_both == 0 || !derived.clip_primitives()) {
                 /* Fast path: no clipping needed. */
-                for (auto it = events_start; it != events_end; ++it) {
-                    auto event = *it;
-
-                    /* Fetch the classification of the current event */
-                    switch (classification.get(event.index)) {
-                        case PrimClassification::Left:
-                            *left_events_end++ = event;
-                            break;
-
-                        case PrimClassification::Right:
-                            *right_events_end++ = event;
-                            break;
-
-                        case PrimClassification::Both:
-                            *left_events_end++ = event;
-                            *right_events_end++ = event;
-                            break;
-
-                        default:
-                            Assert(false);
+                if (parallel) {
+                    std::tie(left_events_end, right_events_end) =
+                        partition_parallel(events_start, events_end,
+                                           left_events_start,
+                                           right_events_start, true);
+                    m_local.classification_busy = false;
+                } else {
+                    for (auto it = events_start; it != events_end; ++it) {
+                        auto event = *it;
+
+                        /* Fetch the classification of the current event */
+                        switch (classification.get(event.index)) {
+                            case PrimClassification::Left:
+                                *left_events_end++ = event;
+                                break;
+
+                            case PrimClassification::Right:
+                                *right_events_end++ = event;
+                                break;
+
+                            case PrimClassification::Both:
+                                *left_events_end++ = event;
+                                *right_events_end++ = event;
+                                break;
+
+                            default:
+                                Assert(false);
+                        }
                     }
                 }
 
@@ -1531,78 +1696,49 @@ protected:
                 new_right_events_start = new_right_events_end =
                     right_alloc.template allocate<EdgeEvent>(prims_both * 2 * Dimension);
 
-                for (auto it = events_start; it != events_end; ++it) {
-                    auto event = *it;
-
-                    /* Fetch the classification of the current event */
-                    switch (classification.get(event.index)) {
-                        case PrimClassification::Left:
-                            *temp_left_events_end++ = event;
-                            break;
-
-                        case PrimClassification::Right:
-                            *temp_right_events_end++ = event;
-                            break;
-
-                        case PrimClassification::Ignore:
-                            break;
-
-                        case PrimClassification::Both: {
-                                BoundingBox clippedLeft  = derived.bbox(event.index, left_bbox);
-                                BoundingBox clippedRight = derived.bbox(event.index, right_bbox);
-
-                                Assert(left_bbox.contains(clippedLeft) || !clippedLeft.valid());
-                                Assert(right_bbox.contains(clippedRight) || !clippedRight.valid());
-
-                                if (clippedLeft.valid() &&
-                                    clippedLeft.surface_area() > 0) {
-                                    for (Index axis = 0; axis < Dimension; ++axis) {
-                                        Scalar min = clippedLeft.min[axis],
-                                               max = clippedLeft.max[axis];
-
-                                        if (min != max) {
-                                            *new_left_events_end++ = EdgeEvent(
-                                                EdgeEvent::Type::EdgeStart, axis, min, event.index);
-                                            *new_left_events_end++ = EdgeEvent(
-                                                EdgeEvent::Type::EdgeEnd, axis, max, event.index);
-                                        } else {
-                                            *new_left_events_end++ = EdgeEvent(
-                                                EdgeEvent::Type::EdgePlanar, axis, min, event.index);
-                                        }
-                                    }
-                                } else {
-                                    pruned_left++;
-                                }
-
-                                if (clippedRight.valid() &&
-                                    clippedRight.surface_area() > 0) {
-                                    for (Index axis = 0; axis < Dimension; ++axis) {
-                                        Scalar min = clippedRight.min[axis],
-                                               max = clippedRight.max[axis];
-
-                                        if (min != max) {
-                                            *new_right_events_end++ = EdgeEvent(
-                                                EdgeEvent::Type::EdgeStart, axis, min, event.index);
-                                            *new_right_events_end++ = EdgeEvent(
-                                                EdgeEvent::Type::EdgeEnd, axis, max, event.index);
-                                        } else {
-                                            *new_right_events_end++ = EdgeEvent(
-                                                EdgeEvent::Type::EdgePlanar, axis, min, event.index);
-                                        }
-                                    }
-                                } else {
-                                    pruned_right++;
-                                }
+                if (parallel) {
+                    std::tie(temp_left_events_end, temp_right_events_end) =
+                        partition_parallel(events_start, events_end,
+                                           temp_left_events_start,
+                                           temp_right_events_start, false);
+                    std::tie(new_left_events_end, new_right_events_end) =
+                        clip_parallel(axis_start, axis_end, left_bbox,
+                                      right_bbox, new_left_events_start,
+                                      new_right_events_start, pruned_left,
+                                      pruned_right);
+                    m_local.classification_busy = false;
+                } else {
+                    for (auto it = events_start; it != events_end; ++it) {
+                        auto event = *it;
+
+                        /* Fetch the classification of the current event */
+                        switch (classification.get(event.index)) {
+                            case PrimClassification::Left:
+                                *temp_left_events_end++ = event;
+                                break;
+
+                            case PrimClassification::Right:
+                                *temp_right_events_end++ = event;
+                                break;
+
+                            case PrimClassification::Ignore:
+                                break;
+
+                            case PrimClassification::Both:
+                                clip_primitive(event.index, left_bbox, right_bbox,
+                                               new_left_events_end,
+                                               new_right_events_end, pruned_left,
+                                               pruned_right);
 
                                 /* Set classification to 'EIgnore' to ensure that
                                    clipping occurs only once */
                                 classification.set(
                                     event.index, PrimClassification::Ignore);
-                            }
-                            break;
+                                break;
 
-                        default:
-                            Assert(false);
+                            default:
+                                Assert(false);
+                        }
                     }
                 }
 
@@ -1614,8 +1750,8 @@ protected:
                 m_ctx.pruned += pruned_left + pruned_right;
 
                 /* Sort the events due to primitives which overlap the split plane */
-                std::sort(new_left_events_start, new_left_events_end);
-                std::sort(new_right_events_start, new_right_events_end);
+                sort_events(new_left_events_start, new_left_events_end);
+                sort_events(new_right_events_start, new_right_events_end);
 
                 /* Merge the left list */
                 left_events_end = std::merge(temp_left_events_start,
@@ -1636,8 +1772,9 @@ protected:
 
             /* Shrink the edge event storage now that we know exactly how
                many events are on each side */
-            left_alloc.shrink_allocation(left_events_start,
-                                        left_events_end - left_events_start);
+            if (!(left_child && shared_events))
+                left_alloc.shrink_allocation(left_events_start,
+                                             left_events_end - left_events_start);
             right_alloc.shrink_allocation(right_events_start,
                                          right_events_end - right_events_start);
 
@@ -1653,15 +1790,38 @@ protected:
                       "to store overly large offset to left child node (%i)",
                       left_offset);
 
-            Scalar left_cost =
-                build_nlogn(children, best.left_count - pruned_left,
-                            left_events_start, left_events_end, left_bbox,
-                            depth + 1, bad_refines, true);
-
-            Scalar right_cost =
-                build_nlogn(children + 1, best.right_count - pruned_right,
-                            right_events_start, right_events_end, right_bbox,
-                            depth + 1, bad_refines, false);
+            Size left_prims  = best.left_count - pruned_left,
+                 right_prims = best.right_count - pruned_right;
+
+            Scalar left_cost, right_cost;
+            if (parallel_threshold > 0 && left_prims >= parallel_threshold &&
+                right_prims >= parallel_threshold) {
+                /* Both subtrees are large: build the left one in a separate
+                   task. It partitions its events in place, which stay valid
+                   until the task has been joined below */
+                TaskGuard left_dr_task(dr::do_async([&]() {
+                    left_cost = build_nlogn_detached(
+                        children, left_prims, left_events_start,
+                        left_events_end, left_bbox, depth + 1, bad_refines);
+                }));
+
+                right_cost =
+                    build_nlogn(children + 1, right_prims, right_events_start,
+                                right_events_end, right_bbox, depth + 1,
+                                bad_refines, false);
+
+                left_dr_task.wait();
+            } else {
+                left_cost =
+                    build_nlogn(children, left_prims, left_events_start,
+                                left_events_end, left_bbox, depth + 1,
+                                bad_refines, true, shared_events);
+
+                right_cost =
+                    build_nlogn(children + 1, right_prims, right_events_start,
+                                right_events_end, right_bbox, depth + 1,
+                                bad_refines, false);
+            }
 
             /* Release the index lists not needed by the children anymore */
             if (left_child)
@@ -1697,6 +1857,367 @@ protected:
             return final_cost;
         }
 
+        /// Classify the primitive of an event on the split axis (\c Both: undecided)
+        static PrimClassification classify(const EdgeEvent &event,
+                                           const SplitCandidate &split) {
+            if (event.type == EdgeEvent::Type::EdgeEnd && event.pos <= split.split) {
+                /* Fully on the left side (the primitive's interval ends
+                   before (or on) the split plane) */
+                return PrimClassification::Left;
+            } else if (event.type == EdgeEvent::Type::EdgeStart &&
+                       event.pos >= split.split) {
+                /* Fully on the right side (the primitive's interval
+                   starts after (or on) the split plane) */
+                return PrimClassification::Right;
+            } else if (event.type == EdgeEvent::Type::EdgePlanar) {
+                /* If the planar primitive is not on the split plane,
+                   the classification is easy. Otherwise, place it on
+                   the side with the lower cost */
+                if (event.pos < split.split ||
+                    (event.pos == split.split && split.planar_left))
+                    return PrimClassification::Left;
+                else if (event.pos > split.split ||
+                         (event.pos == split.split && !split.planar_left))
+                    return PrimClassification::Right;
+            }
+            return PrimClassification::Both;
+        }
+
+        /// Clip a primitive straddling the split plane and append its new events
+        void clip_primitive(Index index, const BoundingBox &left_bbox,
+                            const BoundingBox &right_bbox,
+                            EdgeEvent *&left_events_end,
+                            EdgeEvent *&right_events_end, Size &pruned_left,
+                            Size &pruned_right) const {
+            const Derived &derived = m_ctx.derived;
+            BoundingBox clippedLeft  = derived.bbox(index, left_bbox);
+            BoundingBox clippedRight = derived.bbox(index, right_bbox);
+
+            Assert(left_bbox.contains(clippedLeft) || !clippedLeft.valid());
+            Assert(right_bbox.contains(clippedRight) || !clippedRight.valid());
+
+            if (clippedLeft.valid() && clippedLeft.surface_area() > 0) {
+                for (Index axis = 0; axis < Dimension; ++axis)
+                    left_events_end = put_events(
+                        left_events_end, axis, clippedLeft.min[axis],
+                        clippedLeft.max[axis], index);
+            } else {
+                pruned_left++;
+            }
+
+            if (clippedRight.valid() && clippedRight.surface_area() > 0) {
+                for (Index axis = 0; axis < Dimension; ++axis)
+                    right_events_end = put_events(
+                        right_events_end, axis, clippedRight.min[axis],
+                        clippedRight.max[axis], index);
+            } else {
+                pruned_right++;
+            }
+        }
+
+        /**
+         * \brief Invoke \c func(chunk, start, end) in parallel for consecutive
+         * chunks of \ref MI_KD_GRAIN_SIZE events
+         */
+        template <typename Func>
+        static void for_each_chunk(EdgeEvent *events_start,
+                                   EdgeEvent *events_end, Func &&func) {
+            Size chunk_count =
+                (Size(events_end - events_start) + MI_KD_GRAIN_SIZE - 1) /
+                MI_KD_GRAIN_SIZE;
+
+            dr::parallel_for(
+                dr::blocked_range<Size>(0u, chunk_count, 1u),
+                [&](const dr::blocked_range<Size> &range) {
+                    for (Size chunk = range.begin(); chunk != range.end(); ++chunk) {
+                        EdgeEvent *start = events_start + chunk * MI_KD_GRAIN_SIZE,
+                                  *end = start + std::min(
+                                      (size_t) MI_KD_GRAIN_SIZE,
+                                      (size_t) (events_end - start));
+                        func(chunk, start, end);
+                    }
+                }
+            );
+        }
+
+        /// Parallel version of the primitive classification of large nodes
+        void classify_parallel(EdgeEvent *axis_start, EdgeEvent *axis_end,
+                               const SplitCandidate &split, Size &prims_left,
+                               Size &prims_right) {
+            /* Neighboring entries may be updated by other threads, and the
+               workers must use the storage of the calling thread */
+            auto &classification = *m_local.classification;
+
+            for_each_chunk(axis_start, axis_end,
+                [&](Size, EdgeEvent *start, EdgeEvent *end) {
+                    for (auto event = start; event != end; ++event)
+                        classification.set_concurrent(event->index,
+                                                      PrimClassification::Both);
+                });
+
+            std::atomic<Size> left_count { 0 }, right_count { 0 };
+            for_each_chunk(axis_start, axis_end,
+                [&](Size, EdgeEvent *start, EdgeEvent *end) {
+                    Size left_local = 0, right_local = 0;
+                    for (auto event = start; event != end; ++event) {
+                        PrimClassification value = classify(*event, split);
+                        if (value == PrimClassification::Both)
+                            continue;
+
+                        Assert(classification.get(event->index) == PrimClassification::Both);
+                        classification.set_concurrent(event->index, value);
+                        if (value == PrimClassification::Left)
+                            left_local++;
+                        else
+                            right_local++;
+                    }
+                    left_count += left_local;
+                    right_count += right_local;
+                });
+
+            prims_left = left_count;
+            prims_right = right_count;
+        }
+
+        /**
+         * \brief Parallel version of the partitioning step of large nodes
+         *
+         * Copies the events to the left and right lists according to the
+         * classification of their primitive, preserving their order. Events
+         * of straddling primitives go to both lists when \c keep_both is set
+         * and are skipped otherwise. One of the lists may start at \c
+         * events_start, in which case it is partitioned in place.
+         *
+         * \return The ends of the left and right lists
+         */
+        std::pair<EdgeEvent *, EdgeEvent *>
+        partition_parallel(EdgeEvent *events_start, EdgeEvent *events_end,
+                           EdgeEvent *left_start, EdgeEvent *right_start,
+                           bool keep_both) {
+            const auto &classification = *m_local.classification;
+            Size chunk_count =
+                (Size(events_end - events_start) + MI_KD_GRAIN_SIZE - 1) /
+                MI_KD_GRAIN_SIZE;
+            bool left_in_place  = left_start == events_start,
+                 right_in_place = right_start == events_start;
+
+            /* Count the events of each chunk on either side.. */
+            std::vector<Size> left_offset(chunk_count + 1, 0),
+                              right_offset(chunk_count + 1, 0);
+            for_each_chunk(events_start, events_end,
+                [&](Size chunk, EdgeEvent *start, EdgeEvent *end) {
+                    Size left_count = 0, right_count = 0;
+                    for (auto it = start; it != end; ++it) {
+                        switch (classification.get(it->index)) {
+                            case PrimClassification::Left:  left_count++;  break;
+                            case PrimClassification::Right: right_count++; break;
+                            case PrimClassification::Both:
+                                if (keep_both) {
+                                    left_count++;
+                                    right_count++;
+                                }
+                                break;
+                            default:
+                                Assert(false);
+                        }
+                    }
+                    left_offset[chunk + 1] = left_count;
+                    right_offset[chunk + 1] = right_count;
+                });
+
+            /* .. and turn the counts into output offsets */
+            for (Size chunk = 0; chunk < chunk_count; ++chunk) {
+                left_offset[chunk + 1] += left_offset[chunk];
+                right_offset[chunk + 1] += right_offset[chunk];
+            }
+
+            /* The list that is partitioned in place is compacted within each
+               chunk first, since its final location may still hold events
+               that other chunks have yet to read */
+            for_each_chunk(events_start, events_end,
+                [&](Size chunk, EdgeEvent *start, EdgeEvent *end) {
+                    EdgeEvent *left  = left_in_place  ? start : left_start  + left_offset[chunk],
+                              *right = right_in_place ? start : right_start + right_offset[chunk];
+                    for (auto it = start; it != end; ++it) {
+                        auto event = *it;
+                        switch (classification.get(event.index)) {
+                            case PrimClassification::Left:  *left++ = event;  break;
+                            case PrimClassification::Right: *right++ = event; break;
+                            case PrimClassification::Both:
+                                if (keep_both) {
+                                    *left++ = event;
+                                    *right++ = event;
+                                }
+                                break;
+                            default:
+                                Assert(false);
+                        }
+                    }
+                });
+
+            /* Every compacted piece moves towards the front. Processing them
+               in order thus never overwrites a piece that is yet to move */
+            if (left_in_place || right_in_place) {
+                const std::vector<Size> &offset =
+                    left_in_place ? left_offset : right_offset;
+                for (Size chunk = 0; chunk < chunk_count; ++chunk) {
+                    memmove(events_start + offset[chunk],
+                            events_start + chunk * MI_KD_GRAIN_SIZE,
+                            (offset[chunk + 1] - offset[chunk]) * sizeof(EdgeEvent));
+                }
+            }
+
+            return { left_start + left_offset[chunk_count],
+                     right_start + right_offset[chunk_count] };
+        }
+
+        /**
+         * \brief Parallel version of the clipping step of large nodes
+         *
+         * A straddling primitive has exactly one \c EdgeStart event on the
+         * split axis, which is where it gets clipped.
+         *
+         * \return The ends of the (unsorted) new left and right lists
+         */
+        std::pair<EdgeEvent *, EdgeEvent *>
+        clip_parallel(EdgeEvent *axis_start, EdgeEvent *axis_end,
+                      const BoundingBox &left_bbox,
+                      const BoundingBox &right_bbox,
+                      EdgeEvent *left_start, EdgeEvent *right_start,
+                      Size &pruned_left, Size &pruned_right) {
+            const auto &classification = *m_local.classification;
+            Size chunk_count =
+                (Size(axis_end - axis_start) + MI_KD_GRAIN_SIZE - 1) /
+                MI_KD_GRAIN_SIZE;
+
+            auto straddles = [&](const EdgeEvent &event) {
+                return event.type == EdgeEvent::Type::EdgeStart &&
+                       classification.get(event.index) == PrimClassification::Both;
+            };
+
+            /* Reserve 2 * Dimension events per straddling primitive and side */
+            std::vector<Size> offset(chunk_count + 1, 0);
+            for_each_chunk(axis_start, axis_end,
+                [&](Size chunk, EdgeEvent *start, EdgeEvent *end) {
+                    offset[chunk + 1] = (Size) std::count_if(start, end, straddles);
+                });
+            for (Size chunk = 0; chunk < chunk_count; ++chunk)
+                offset[chunk + 1] += offset[chunk];
+
+            std::vector<Size> left_count(chunk_count), right_count(chunk_count);
+            std::atomic<Size> pruned_left_total { 0 }, pruned_right_total { 0 };
+            for_each_chunk(axis_start, axis_end,
+                [&](Size chunk, EdgeEvent *start, EdgeEvent *end) {
+                    EdgeEvent *left_base  = left_start  + offset[chunk] * 2 * Dimension,
+                              *right_base = right_start + offset[chunk] * 2 * Dimension,
+                              *left = left_base, *right = right_base;
+                    Size pruned_left_local = 0, pruned_right_local = 0;
+                    for (auto event = start; event != end; ++event) {
+                        if (straddles(*event))
+                            clip_primitive(event->index, left_bbox, right_bbox,
+                                           left, right, pruned_left_local,
+                                           pruned_right_local);
+                    }
+                    left_count[chunk] = Size(left - left_base);
+                    right_count[chunk] = Size(right - right_base);
+                    pruned_left_total += pruned_left_local;
+                    pruned_right_total += pruned_right_local;
+                });
+
+            pruned_left += pruned_left_total;
+            pruned_right += pruned_right_total;
+
+            /* Close the gaps between the pieces of the chunks (in order, as
+               each piece moves towards the front) */
+            EdgeEvent *left_end = left_start, *right_end = right_start;
+            for (Size chunk = 0; chunk < chunk_count; ++chunk) {
+                EdgeEvent *left_base  = left_start  + offset[chunk] * 2 * Dimension,
+                          *right_base = right_start + offset[chunk] * 2 * Dimension;
+                memmove(left_end, left_base, left_count[chunk] * sizeof(EdgeEvent));
+                memmove(right_end, right_base, right_count[chunk] * sizeof(EdgeEvent));
+                left_end += left_count[chunk];
+                right_end += right_count[chunk];
+            }
+
+            return { left_end, right_end };
+        }
+
+        /**
+         * \brief Provides the classification storage of the calling thread
+         * to one O(N log N) build
+         *
+         * A thread waiting for a parallel step of this builder may pick up
+         * another build task in the meantime. Such nested builds receive
+         * separate storage, so that the classification of the waiting node
+         * stays intact.
+         */
+        struct ClassificationScope {
+            LocalBuildContext &local;
+            ClassificationStorage *outer;
+            bool outer_busy;
+            ClassificationStorage nested_storage;
+
+            ClassificationScope(LocalBuildContext &local, BuildContext &ctx)
+                : local(local), outer(local.classification),
+                  outer_busy(local.classification_busy) {
+                ClassificationStorage &storage =
+                    outer_busy ? nested_storage : local.classification_storage;
+                storage.resize(ctx.derived.primitive_count());
+                local.classification = &storage;
+                local.classification_busy = false;
+                local.ctx = &ctx;
+            }
+
+            ~ClassificationScope() {
+                local.classification = outer;
+                local.classification_busy = outer_busy;
+            }
+        };
+
+        /**
+         * \brief Sort an edge event list, splitting long lists into halves
+         * that are sorted in parallel and merged afterwards
+         */
+        static void sort_events(EdgeEvent *start, EdgeEvent *end) {
+            size_t size = (size_t) (end - start);
+            if (size <= MI_KD_PARALLEL_SORT_SIZE) {
+                std::sort(start, end);
+                return;
+            }
+
+            EdgeEvent *middle = start + size / 2;
+            TaskGuard left_dr_task(
+                dr::do_async([=]() { sort_events(start, middle); }));
+            sort_events(middle, end);
+            left_dr_task.wait();
+            std::inplace_merge(start, middle, end);
+        }
+
+        /**
+         * \brief Run the O(N log N) builder on a subtree whose event list
+         * is owned by another thread
+         *
+         * The events are partitioned where they are, which avoids a copy.
+         * Their storage is never resized or released here, so that the
+         * allocation order of every thread-local allocator stays intact.
+         */
+        Scalar build_nlogn_detached(Index node, Size prim_count,
+                                    EdgeEvent *events_start,
+                                    EdgeEvent *events_end,
+                                    const BoundingBox &bbox, Size depth,
+                                    Size bad_refines) {
+            FTZGuard g;
+            m_ctx.work_units++;
+
+            m_local.left_alloc.set_huge_pages(m_ctx.huge_pages);
+            m_local.right_alloc.set_huge_pages(m_ctx.huge_pages);
+
+            ClassificationScope scope(m_local, m_ctx);
+
+            return build_nlogn(node, prim_count, events_start, events_end,
+                               bbox, depth, bad_refines, true, true);
+        }
+
         /// Create an initial sorted edge event list and start the O(N log N) builder
         Scalar transition_to_nlogn() {
             const auto &derived = m_ctx.derived;
@@ -1708,6 +2229,9 @@ protected:
                conservative amount and shrink the buffer later on. */
             Size initial_size = prim_count * 2 * Dimension;
 
+            m_local.left_alloc.set_huge_pages(m_ctx.huge_pages);
+            m_local.right_alloc.set_huge_pages(m_ctx.huge_pages);
+
             EdgeEvent *events_start =
                 m_local.left_alloc.template allocate<EdgeEvent>(initial_size),
                 *events_end = events_start + initial_size;
@@ -1723,18 +2247,14 @@ protected:
                 }
 
                 for (Index axis = 0; axis < Dimension; ++axis) {
-                    Scalar min = prim_bbox.min[axis], max = prim_bbox.max[axis];
-                    Index offset = (Index) (axis * prim_count + i) * 2;
+                    EdgeEvent *event = events_start + (axis * prim_count + i) * 2;
 
                     if (unlikely(!valid)) {
-                        events_start[offset  ].set_invalid();
-                        events_start[offset+1].set_invalid();
-                    } else if (min == max) {
-                        events_start[offset  ] = EdgeEvent(EdgeEvent::Type::EdgePlanar, axis, min, prim_index);
-                        events_start[offset+1].set_invalid();
-                    } else {
-                        events_start[offset  ] = EdgeEvent(EdgeEvent::Type::EdgeStart, axis, min, prim_index);
-                        events_start[offset+1] = EdgeEvent(EdgeEvent::Type::EdgeEnd,   axis, max, prim_index);
+                        event[0].set_invalid();
+                        event[1].set_invalid();
+                    } else if (put_events(event, axis, prim_bbox.min[axis],
+                                          prim_bbox.max[axis], prim_index) == event + 1) {
+                        event[1].set_invalid();
                     }
                 }
             }
@@ -1743,14 +2263,13 @@ protected:
             IndexVector().swap(m_indices);
 
             /* Sort the events list and remove invalid ones from the end */
-            std::sort(events_start, events_end);
+            sort_events(events_start, events_end);
             while (events_start != events_end && !(events_end-1)->valid())
                 --events_end;
 
             m_local.left_alloc.template shrink_allocation<EdgeEvent>(
                 events_start, events_end - events_start);
-            m_local.classification_storage.resize(derived.primitive_count());
-            m_local.ctx = &m_ctx;
+            ClassificationScope scope(m_local, m_ctx);
 
             Scalar cost = build_nlogn(m_node, final_prim_count, events_start,
                                       events_end, m_bbox, m_depth, 0);
@@ -1879,6 +2398,7 @@ protected:
         /* ==================================================================== */
 
         BuildContext ctx(derived());
+        ctx.huge_pages = m_huge_pages;
 
         ctx.node_storage.reserve(prim_count);
         ctx.index_storage.reserve(prim_count);
@@ -1917,7 +2437,7 @@ protected:
         m_node_count  = (Index) ctx.node_storage.size();
         m_index_count = (Index) ctx.index_storage.size();
 
-        m_indices.reset(new Index[m_index_count]);
+        m_indices = detail::make_page_array<Index>(m_index_count, m_huge_pages);
         dr::parallel_for(
             dr::blocked_range<Size>(0u, m_index_count, MI_KD_GRAIN_SIZE),
             [&](const dr::blocked_range<Size> &range) {
@@ -1927,7 +2447,7 @@ protected:
         );
         ctx.index_storage.release();
 
-        m_nodes.reset(new KDNode[m_node_count]);
+        m_nodes = detail::make_page_array<KDNode>(m_node_count, m_huge_pages);
         dr::parallel_for(
             dr::blocked_range<Size>(0u, m_node_count, MI_KD_GRAIN_SIZE),
             [&](const dr::blocked_range<Size> &range) {
@@ -2012,8 +2532,8 @@ protected:
     }
 
 protected:
-    std::unique_ptr<KDNode[]> m_nodes;
-    std::unique_ptr<Index[]> m_indices;
+    detail::PageArray<KDNode> m_nodes;
+    detail::PageArray<Index> m_indices;
     Size m_node_count = 0;
     Size m_index_count = 0;
 
@@ -2024,8 +2544,10 @@ protected:
     Size m_stop_primitives = 3;
     Size m_max_bad_refines = 0;
     Size m_exact_prim_threshold = 65536;
+    Size m_parallel_nlogn_threshold = 4096;
     Size m_min_max_bins = 128;
     LogLevel m_log_level = Debug;
+    util::HugePages m_huge_pages = util::HugePages::None;
     BoundingBox m_bbox;
 };
 
@@ -2146,12 +2668,15 @@ public:
     using Base::ready;
     using Base::set_clip_primitives;
     using Base::set_exact_primitive_threshold;
+    using Base::set_parallel_nlogn_threshold;
     using Base::set_max_depth;
     using Base::set_min_max_bins;
     using Base::set_retract_bad_splits;
     using Base::set_stop_primitives;
+    using Base::set_huge_pages;
     using Base::bbox;
     using Base::m_bbox;
+    using Base::m_huge_pages;
     using Base::m_nodes;
     using Base::m_indices;
     using Base::m_index_count;
@@ -2169,12 +2694,43 @@ public:
     /// Build the kd-tree
     void build();
 
+    /// Return whether shadow rays first test the last occluder found by this thread
+    bool occluder_cache() const { return m_occluder_cache; }
+
+    /// Specify whether shadow rays first test the last occluder found by this thread
+    void set_occluder_cache(bool value) { m_occluder_cache = value; }
+
+    /**
+     * \brief Return whether shadow rays visit the child node covering the
+     * longer ray segment first (instead of using front-to-back order)
+     */
+    bool any_hit_larger_first() const { return m_any_hit_larger_first; }
+
+    /**
+     * \brief Specify whether shadow rays visit the child node covering the
+     * longer ray segment first (instead of using front-to-back order)
+     */
+    void set_any_hit_larger_first(bool value) { m_any_hit_larger_first = value; }
+
+    /// Return the NUMA placement policy of the node and index arrays
+    util::NumaPolicy numa_policy() const { return m_numa_policy; }
+
+    /// Set the NUMA placement policy of the node and index arrays (to be called before \ref build())
+    void set_numa_policy(util::NumaPolicy policy) { m_numa_policy = policy; }
+
     /// Return the number of registered shapes
     Size shape_count() const { return Size(m_shapes.size()); }
 
     /// Return the number of registered primitives
     Size primitive_count() const { return m_primitive_map.back(); }
 
+    /// Return the storage of the node and index arrays (including NUMA replicas)
+    size_t memory_usage() const override {
+        size_t bytes = m_node_count * sizeof(KDNode) + m_index_count * sizeof(Index);
+        return bytes * (1 + m_numa_replicas.size()) +
+               m_primitive_map.size() * sizeof(Size);
+    }
+
     /// Return the i-th shape (const version)
     const Shape *shape(size_t i) const { Assert(i < m_shapes.size()); return m_shapes[i]; }
 
@@ -2221,6 +2777,22 @@ public:
         // Resulting intersection struct
         PreliminaryIntersection<ScalarFloat, Shape> pi;
 
+        /* Shadow rays spawned from nearby shading points towards the same
+           emitter are frequently blocked by the same primitive. Test the
+           last occluder found by this thread before traversing the tree. */
+        OccluderCache *cache = nullptr;
+        if constexpr (ShadowRay) {
+            if (m_occluder_cache) {
+                cache = &occluder_cache_local(m_build_id);
+                if (cache->build_id == m_build_id) {
+                    PreliminaryIntersection<ScalarFloat, Shape> prim_pi =
+                        intersect_prim<true>(cache->prim_index, ray);
+                    if (prim_pi.is_valid())
+                        return prim_pi;
+                }
+            }
+        }
+
         // Intersect against the scene bounding box
         auto bbox_result = m_bbox.ray_intersect(ray);
 
@@ -2229,7 +2801,20 @@ public:
 
         ScalarVector3f d_rcp = dr::rcp(ray.d);
 
+        /* Use the replica of the node that the calling thread is pinned to,
+           if any. Unpinned threads traverse the primary copy. */
         const KDNode *node = m_nodes.get();
+        const Index *indices = m_indices.get();
+        if (unlikely(!m_numa_replicas.empty())) {
+            int numa_node = util::numa_node_pinned();
+            if (numa_node >= 0) {
+                const NumaReplica &replica = m_numa_replicas[
+                    (size_t) numa_node % m_numa_replicas.size()];
+                node = replica.nodes.get();
+                indices = replica.indices.get();
+            }
+        }
+
         while (mint <= maxt) {
             if (likely(!node->leaf())) { // Inner node
                 const ScalarFloat split = node->split();
@@ -2257,6 +2842,23 @@ public:
                              *n_cur  = left + node_offset,
                              *n_next = left + (1 - node_offset);
 
+                /* Any-hit queries don't need front-to-back order. Visit the
+                   child covering the longer ray segment first, since it is
+                   more likely to contain an occluder. */
+                if constexpr (ShadowRay) {
+                    if (m_any_hit_larger_first &&
+                        maxt - t_plane > t_plane - mint) {
+                        KDStackEntry& entry = stack[stack_index++];
+                        entry.mint = mint;
+                        entry.maxt = t_plane;
+                        entry.node = n_cur;
+
+                        node = n_next;
+                        mint = t_plane;
+                        continue;
+                    }
+                }
+
                 /* Postpone visit to 'n_next' */
                 KDStackEntry& entry = stack[stack_index++];
                 entry.mint = t_plane;
@@ -2271,14 +2873,19 @@ public:
                 Index prim_start = node->primitive_offset();
                 Index prim_end = prim_start + node->primitive_count();
                 for (Index i = prim_start; i < prim_end; i++) {
-                    Index prim_index = m_indices[i];
+                    Index prim_index = indices[i];
 
                     PreliminaryIntersection<ScalarFloat, Shape> prim_pi =
                         intersect_prim<ShadowRay>(prim_index, ray);
 
                     if (unlikely(prim_pi.is_valid())) {
-                        if constexpr (ShadowRay)
+                        if constexpr (ShadowRay) {
+                            if (cache) {
+                                cache->build_id = m_build_id;
+                                cache->prim_index = prim_index;
+                            }
                             return prim_pi;
+                        }
 
                         Assert(prim_pi.t >= 0.f && prim_pi.t <= ray.maxt);
                         pi = prim_pi;
@@ -2461,6 +3068,39 @@ public:
 
     MI_DECLARE_CLASS(ShapeKDTree)
 protected:
+    /// Per-thread record of the primitive that most recently blocked a shadow ray
+    struct OccluderCache {
+        /// Identifies the kd-tree build that \c prim_index refers to
+        uint64_t build_id = 0;
+        /// Global primitive index of the last occluder
+        Index prim_index = 0;
+    };
+
+    /// Copy of the node and index arrays that resides on a specific NUMA node
+    struct NumaReplica {
+        detail::PageArray<KDNode> nodes;
+        detail::PageArray<Index> indices;
+    };
+
+    /// Apply the NUMA placement policy to the node and index arrays
+    void apply_numa_policy();
+
+    /// Number of per-thread occluder cache slots, see \ref occluder_cache_local()
+    static constexpr size_t OccluderCacheSlots = 8;
+
+    /**
+     * \brief Return the occluder cache associated with the calling thread
+     * and the given kd-tree build
+     *
+     * Each thread holds a few slots indexed by the build ID, so that nested
+     * kd-trees (e.g. of shape groups traversed while visiting an instance)
+     * don't evict the entry of the top-level tree.
+     */
+    static OccluderCache &occluder_cache_local(uint64_t build_id) {
+        static thread_local OccluderCache cache[OccluderCacheSlots];
+        return cache[build_id % OccluderCacheSlots];
+    }
+
     /**
      * \brief Map an abstract \ref TShapeKDTree primitive index to a specific
      * shape managed by the \ref ShapeKDTree.
@@ -2508,7 +3148,7 @@ protected:
             if (shape->is_mesh())
                 hit = mesh->ray_intersect_triangle_scalar(prim_index, ray).first != dr::Infinity<ScalarFloat>;
             else
-                hit = shape->ray_test_scalar(ray);
+                hit = shape->ray_test_scalar(ray, prim_index);
             pi.t = dr::select(hit, 0.f , pi.t);
         } else {
             uint32_t inst_index = (uint32_t) -1;
@@ -2516,7 +3156,7 @@ protected:
                 std::tie(pi.t, pi.prim_uv) = mesh->ray_intersect_triangle_scalar(prim_index, ray);
             else
                 std::tie(pi.t, pi.prim_uv, inst_index, prim_index) =
-                    shape->ray_intersect_preliminary_scalar(ray);
+                    shape->ray_intersect_preliminary_scalar(ray, prim_index);
             pi.prim_index = prim_index;
 
             bool hit_inst  = (inst_index != (uint32_t) -1);
@@ -2531,6 +3171,12 @@ protected:
 protected:
     std::vector<ref<Shape>> m_shapes;
     std::vector<Size> m_primitive_map;
+    std::vector<NumaReplica> m_numa_replicas;
+    util::NumaPolicy m_numa_policy = util::NumaPolicy::None;
+    bool m_occluder_cache = false;
+    bool m_any_hit_larger_first = false;
+    /// Unique identifier of the current build (0 == not built)
+    uint64_t m_build_id = 0;
 };
 
 MI_EXTERN_CLASS(ShapeKDTree)
@@ -282,6 +282,18 @@ public:
                              const SurfaceInteraction3f &si,
                              Mask active = true) const override;
 
+    UnpolarizedSpectrum eval_attribute_by_id(uint32_t id,
+                                             const SurfaceInteraction3f &si,
+                                             Mask active = true) const override;
+
+    Float eval_attribute_1_by_id(uint32_t id,
+                                 const SurfaceInteraction3f &si,
+                                 Mask active = true) const override;
+
+    Color3f eval_attribute_3_by_id(uint32_t id,
+                                   const SurfaceInteraction3f &si,
+                                   Mask active = true) const override;
+
     SurfaceInteraction3f eval_parameterization(const Point2f &uv,
                                                uint32_t ray_flags = +RayFlags::All,
                                                Mask active = true) const override;
@@ -414,6 +426,9 @@ public:
     void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override;
     bool parameters_grad_enabled() const override;
 
+    /// Return the storage of the adjacency information and sampling tables
+    size_t memory_usage() const override;
+
     /// Return a human-readable string representation of the shape contents.
     std::string to_string() const override;
 
@@ -523,6 +538,27 @@ protected:
         DRJIT_STRUCT_NODEF(MeshAttribute, buf);
     };
 
+    /// Rebuild \ref m_attribute_slots after attributes were added or removed
+    void update_attribute_slots();
+
+    /// Return the (name, attribute) entry with the given handle, or \c nullptr
+    const std::pair<std::string, MeshAttribute> *attribute_slot(uint32_t id) const {
+        return id < m_attribute_slots.size() ? m_attribute_slots[id] : nullptr;
+    }
+
+    UnpolarizedSpectrum eval_mesh_attribute(const MeshAttribute &attr,
+                                            std::string_view name,
+                                            const SurfaceInteraction3f &si,
+                                            Mask active) const;
+    Float eval_mesh_attribute_1(const MeshAttribute &attr,
+                                std::string_view name,
+                                const SurfaceInteraction3f &si,
+                                Mask active) const;
+    Color3f eval_mesh_attribute_3(const MeshAttribute &attr,
+                                  std::string_view name,
+                                  const SurfaceInteraction3f &si,
+                                  Mask active) const;
+
     template <uint32_t Size, bool Raw>
     auto interpolate_attribute(MeshAttributeType type,
                                const FloatStorage &buf,
@@ -597,6 +633,10 @@ protected:
     tsl::robin_map<std::string, MeshAttribute, std::hash<std::string_view>,
                    std::equal_to<>> m_mesh_attributes;
 
+    /* Mesh attributes indexed by their handle (\ref Shape::attribute_id()),
+       so that handle-based lookups avoid hashing the attribute name */
+    std::vector<const std::pair<std::string, MeshAttribute> *> m_attribute_slots;
+
 #if defined(MI_ENABLE_CUDA)
     mutable void* m_vertex_buffer_ptr = nullptr;
 #endif
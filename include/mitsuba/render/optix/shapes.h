@@ -23,6 +23,7 @@ struct MiOptixAccelData {
     struct HandleData {
         OptixTraversableHandle handle = 0ull;
         void* buffer = nullptr;
+        size_t size = 0;
         uint32_t count = 0u;
     };
     HandleData meshes;
@@ -31,6 +32,12 @@ struct MiOptixAccelData {
     HandleData linear_curves;
     HandleData custom_shapes;
 
+    /// Return the storage used by the geometry acceleration structures
+    size_t memory_usage() const {
+        return meshes.size + ellipsoids_meshes.size + bspline_curves.size +
+               linear_curves.size + custom_shapes.size;
+    }
+
     ~MiOptixAccelData() {
         if (meshes.buffer) jit_free(meshes.buffer);
         if (ellipsoids_meshes.buffer) jit_free(ellipsoids_meshes.buffer);
@@ -159,6 +166,7 @@ void build_gas(const OptixDeviceContext &context,
             jit_free(handle.buffer);
             handle.handle = 0ull;
             handle.buffer = nullptr;
+            handle.size = 0;
             handle.count = 0;
         }
 
@@ -201,7 +209,7 @@ void build_gas(const OptixDeviceContext &context,
 
         jit_free(d_temp_buffer);
 
-        size_t compact_size;
+        size_t output_size = buffer_sizes.outputSizeInBytes, compact_size;
         jit_memcpy(JitBackend::CUDA,
                    &compact_size,
                    (void*) emit_property.result,
@@ -221,10 +229,12 @@ void build_gas(const OptixDeviceContext &context,
             ));
             jit_free(output_buffer);
             output_buffer = compact_buffer;
+            output_size = compact_size;
         }
 
         handle.handle = accel;
         handle.buffer = output_buffer;
+        handle.size = output_size;
         handle.count = (uint32_t) shapes_count;
     };
 
@@ -6,6 +6,7 @@
 #include <mitsuba/render/fwd.h>
 #include <mitsuba/render/sensor.h>
 #include <mitsuba/render/shapegroup.h>
+#include <map>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -726,6 +727,15 @@ public:
     /// Return the list of sensors as a Dr.Jit array
     const DynamicBuffer<SensorPtr> &sensors_dr() const { return m_sensors_dr; }
 
+    /// Return the NUMA placement policy of read-only scene data
+    util::NumaPolicy numa_policy() const { return m_numa_policy; }
+
+    /// Return the page size policy of large scene buffers
+    util::HugePages huge_pages() const { return m_huge_pages; }
+
+    /// Return the soft memory budget of the scene in bytes (0: unlimited)
+    size_t memory_budget() const { return m_memory_budget; }
+
     //! @}
     // =============================================================
 
@@ -735,6 +745,34 @@ public:
     /// Update internal state following a parameter update
     void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override;
 
+    /**
+     * \brief Return the storage used by the scene, grouped by category
+     *
+     * The report accounts for the arrays that the scene objects expose via
+     * \ref traverse() (mesh buffers, texture and volume data, ...), their
+     * private storage (see \ref Object::memory_usage()), the acceleration
+     * data structure and the spectral upsampling tables. Categories are
+     * named after the type of the owning object (e.g. a texture nested in a
+     * BSDF counts towards \c "textures"): \c "acceleration", \c "shapes",
+     * \c "textures", \c "volumes", \c "bsdfs", \c "emitters", \c
+     * "media", \c "sensors", \c "film", \c "integrator", \c
+     * "spectral_tables" and \c "other". Empty categories are omitted.
+     *
+     * The film storage is only allocated when rendering starts; until then,
+     * its size is estimated without any AOVs.
+     */
+    std::map<std::string, size_t> memory_report() const;
+
+    /**
+     * \brief Raise an exception with a breakdown of the memory report if the
+     * scene storage exceeds \c budget bytes
+     *
+     * This is invoked by the constructor when the \c memory_budget property
+     * (in MiB) is specified, so that jobs which would run out of memory fail
+     * before rendering starts.
+     */
+    void check_memory_budget(size_t budget) const;
+
     /**
      * \brief Specifies whether any of the scene's shape parameters have
      * gradient tracking enabled
@@ -799,9 +837,29 @@ protected:
     /// Updates the discrete distribution used to select an emitter
     void update_emitter_sampling_distribution();
 
+    /// Request huge pages for the storage of the scene objects
+    void apply_huge_pages();
+
+    /**
+     * \brief Merge the constant-valued BSDFs of the top-level shapes
+     *
+     * Invoked by the constructor in JIT variants when the \c coalesce_bsdfs
+     * property is set. Diffuse BSDFs with a constant reflectance are replaced
+     * by a single diffuse BSDF that looks up the reflectance of the
+     * intersected shape in a table indexed by its JIT registry ID. This
+     * reduces the number of targets of BSDF method calls in the generated
+     * kernels. The table is exposed as a parameter of the new BSDF, and the
+     * parameters of the original BSDFs are no longer part of the scene.
+     */
+    void coalesce_bsdfs();
+
     /// Updates the discrete distribution used to select a shape's silhouette
     void update_silhouette_sampling_distribution();
 
+    /// Return the storage used by the ray-intersection acceleration data structure
+    size_t accel_memory_usage_cpu() const;
+    size_t accel_memory_usage_gpu() const;
+
 protected:
     /// Acceleration data structure (IAS) (type depends on implementation)
     void *m_accel = nullptr;
@@ -833,6 +891,9 @@ protected:
 
     bool m_shapes_grad_enabled;
     bool m_thread_reordering;
+    util::NumaPolicy m_numa_policy;
+    util::HugePages m_huge_pages;
+    size_t m_memory_budget;
 
     /**
      * When the scene is defined on the CPU, traversal of the acceleration
@@ -639,14 +639,20 @@ public:
      * \param ray
      *     The ray to be tested for an intersection
      *
+     * \param prim_index
+     *     Index of the primitive to be intersected (only relevant for shapes
+     *     consisting of several non-triangle primitives)
+     *
      * \return
      *     A tuple containing the following field: \c t, \c uv, \c shape_index,
      *     \c prim_index. The \c shape_index should be only used by the
      *     \ref ShapeGroup class and be set to \c (uint32_t)-1 otherwise.
      */
     virtual std::tuple<ScalarFloat, ScalarPoint2f, ScalarUInt32, ScalarUInt32>
-    ray_intersect_preliminary_scalar(const ScalarRay3f &ray) const;
-    virtual bool ray_test_scalar(const ScalarRay3f &ray) const;
+    ray_intersect_preliminary_scalar(const ScalarRay3f &ray,
+                                     ScalarIndex prim_index = 0) const;
+    virtual bool ray_test_scalar(const ScalarRay3f &ray,
+                                 ScalarIndex prim_index = 0) const;
 
     /// Macro to declare packet versions of the scalar routine above
     #define MI_DECLARE_RAY_INTERSECT_PACKET(N)                                  \
@@ -824,6 +830,35 @@ public:
                                                      const SurfaceInteraction3f &si,
                                                      Mask active = true) const;
 
+    /**
+     * \brief Return a compact handle that identifies the attribute \c name
+     *
+     * Attribute names are interned in a process-wide registry, hence the same
+     * name always maps to the same handle. Callers that evaluate an attribute
+     * repeatedly (e.g. the \c mesh_attribute texture) should resolve the
+     * handle once and use the \c eval_attribute*_by_id() variants, which
+     * avoid hashing the attribute name on every query.
+     */
+    static uint32_t attribute_id(std::string_view name);
+
+    /// Return the attribute name associated with a handle from \ref attribute_id()
+    static const std::string &attribute_name(uint32_t id);
+
+    /// Variant of \ref eval_attribute() taking a handle from \ref attribute_id()
+    virtual UnpolarizedSpectrum eval_attribute_by_id(uint32_t id,
+                                                     const SurfaceInteraction3f &si,
+                                                     Mask active = true) const;
+
+    /// Variant of \ref eval_attribute_1() taking a handle from \ref attribute_id()
+    virtual Float eval_attribute_1_by_id(uint32_t id,
+                                         const SurfaceInteraction3f &si,
+                                         Mask active = true) const;
+
+    /// Variant of \ref eval_attribute_3() taking a handle from \ref attribute_id()
+    virtual Color3f eval_attribute_3_by_id(uint32_t id,
+                                           const SurfaceInteraction3f &si,
+                                           Mask active = true) const;
+
     /**
      * \brief Parameterize the mesh using UV values
      *
@@ -1152,11 +1187,13 @@ NAMESPACE_END(mitsuba)
     }                                                                                       \
     using typename Base::ScalarRay3f;                                                       \
     std::tuple<ScalarFloat, ScalarPoint2f, ScalarUInt32, ScalarUInt32>                      \
-    ray_intersect_preliminary_scalar(const ScalarRay3f &ray) const override {               \
-        return ray_intersect_preliminary_impl<ScalarFloat>(ray, 0, true);                   \
+    ray_intersect_preliminary_scalar(const ScalarRay3f &ray,                                \
+                                     ScalarIndex prim_index) const override {               \
+        return ray_intersect_preliminary_impl<ScalarFloat>(ray, prim_index, true);          \
     }                                                                                       \
-    ScalarMask ray_test_scalar(const ScalarRay3f &ray) const override {                     \
-        return ray_test_impl<ScalarFloat>(ray, 0, true);                                    \
+    ScalarMask ray_test_scalar(const ScalarRay3f &ray,                                      \
+                               ScalarIndex prim_index) const override {                     \
+        return ray_test_impl<ScalarFloat>(ray, prim_index, true);                           \
     }                                                                                       \
     MI_IMPLEMENT_RAY_INTERSECT_PACKET(4)                                                    \
     MI_IMPLEMENT_RAY_INTERSECT_PACKET(8)                                                    \
@@ -1173,6 +1210,9 @@ DRJIT_CALL_TEMPLATE_BEGIN(mitsuba::Shape)
     DRJIT_CALL_METHOD(eval_attribute_1)
     DRJIT_CALL_METHOD(eval_attribute_3)
     DRJIT_CALL_METHOD(eval_attribute_x)
+    DRJIT_CALL_METHOD(eval_attribute_by_id)
+    DRJIT_CALL_METHOD(eval_attribute_1_by_id)
+    DRJIT_CALL_METHOD(eval_attribute_3_by_id)
     DRJIT_CALL_METHOD(eval_parameterization)
     DRJIT_CALL_METHOD(ray_intersect_preliminary)
     DRJIT_CALL_METHOD(ray_intersect)
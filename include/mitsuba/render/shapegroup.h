@@ -21,6 +21,7 @@ public:
     MI_IMPORT_TYPES(ShapeKDTree, ShapePtr)
 
     using typename Base::ScalarSize;
+    using typename Base::ScalarIndex;
     using typename Base::ScalarRay3f;
 
     ShapeGroup(const Properties &props);
@@ -30,8 +31,10 @@ public:
     RTCGeometry embree_geometry(RTCDevice device) override;
 #else
     std::tuple<ScalarFloat, ScalarPoint2f, ScalarUInt32, ScalarUInt32>
-    ray_intersect_preliminary_scalar(const ScalarRay3f &ray) const override;
-    bool ray_test_scalar(const ScalarRay3f &ray) const override;
+    ray_intersect_preliminary_scalar(const ScalarRay3f &ray,
+                                     ScalarIndex prim_index) const override;
+    bool ray_test_scalar(const ScalarRay3f &ray,
+                         ScalarIndex prim_index) const override;
 #endif
 
     SurfaceInteraction3f compute_surface_interaction(const Ray3f &ray,
@@ -51,6 +54,12 @@ public:
     /// Returns a union of ShapeType flags denoting what is present in the ShapeGroup
     uint32_t shape_types() const { return m_shape_types; }
 
+    /**
+     * \brief Return the storage used by the acceleration data structure of
+     * the group (zero with Embree, whose storage is reported per device)
+     */
+    size_t accel_memory_usage() const;
+
     void traverse(TraversalCallback *callback) override;
     void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override;
     bool parameters_grad_enabled() const override;
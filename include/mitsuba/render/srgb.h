@@ -41,6 +41,9 @@ MI_INLINE dr::value_t<Array3f> srgb_model_mean(const Array3f &coeff) {
  */
 MI_EXPORT_LIB dr::Array<float, 3> srgb_model_fetch(const Color<float, 3> &);
 
+/// Return the storage used by the spectral upsampling model (0 if not loaded)
+MI_EXPORT_LIB size_t srgb_model_memory_usage();
+
 /// Sanity check: convert the coefficients back to sRGB
 // MI_EXPORT_LIB Color<float, 3> srgb_model_eval_rgb(const dr::Array<float, 3> &);
 
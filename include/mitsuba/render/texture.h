@@ -213,6 +213,17 @@ public:
     /// Does this texture evaluation depend on the UV coordinates
     virtual bool is_spatially_varying() const { return false; }
 
+    /**
+     * \brief Does this texture evaluate to the same value everywhere?
+     *
+     * This requires that the value neither depends on the surface position
+     * nor on the wavelengths of the current variant. Objects using such a
+     * texture can evaluate it once (with an arbitrary interaction record)
+     * and fold the result into their own parameters. The default
+     * implementation conservatively returns \c false.
+     */
+    virtual bool is_constant() const { return false; }
+
     /// Convenience function returning the standard D65 illuminant
     static ref<Texture> D65(ScalarFloat scale = 1.f);
 
@@ -248,4 +259,5 @@ DRJIT_CALL_TEMPLATE_BEGIN(mitsuba::Texture)
 
     DRJIT_CALL_GETTER(max)
     DRJIT_CALL_GETTER(is_spatially_varying)
+    DRJIT_CALL_GETTER(is_constant)
 DRJIT_CALL_END()
@@ -220,6 +220,7 @@ public:
                   " be positive!");
 
         m_eta = int_ior / ext_ior;
+        dr::make_opaque(m_eta);
 
         if (props.has_property("specular_reflectance"))
             m_specular_reflectance   = props.get_texture<Texture>("specular_reflectance", 1.f);
@@ -242,6 +243,10 @@ public:
             cb->put("specular_transmittance", m_specular_transmittance, ParamFlags::Differentiable);
     }
 
+    void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override {
+        dr::make_opaque(m_eta);
+    }
+
     std::pair<BSDFSample3f, Spectrum> sample(const BSDFContext &ctx,
                                              const SurfaceInteraction3f &si,
                                              Float sample1,
@@ -393,7 +398,7 @@ public:
 
     MI_DECLARE_CLASS(SmoothDielectric)
 private:
-    ScalarFloat m_eta;
+    Float m_eta;
     ref<Texture> m_specular_reflectance;
     ref<Texture> m_specular_transmittance;
 
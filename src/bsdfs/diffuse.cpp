@@ -90,13 +90,28 @@ public:
     SmoothDiffuse(const Properties &props) : Base(props) {
         m_reflectance = props.get_texture<Texture>("reflectance", .5f);
         m_flags = BSDFFlags::DiffuseReflection | BSDFFlags::FrontSide;
+        if (m_reflectance->is_spatially_varying())
+            m_flags |= +BSDFFlags::SpatiallyVarying;
         m_components.push_back(m_flags);
+        parameters_changed();
     }
 
     void traverse(TraversalCallback *cb) override {
         cb->put("reflectance", m_reflectance, ParamFlags::Differentiable);
     }
 
+    void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override {
+        /* Fold a constant reflectance to skip the virtual texture call in
+           scalar variants. JIT variants trace the texture into the kernel
+           anyway, and keep it to track gradients of parameters that are
+           enabled after loading. */
+        m_reflectance_constant =
+            !dr::is_jit_v<Float> && m_reflectance->is_constant();
+        if (m_reflectance_constant)
+            m_reflectance_value =
+                m_reflectance->eval(dr::zeros<SurfaceInteraction3f>());
+    }
+
     std::pair<BSDFSample3f, Spectrum> sample(const BSDFContext &ctx,
                                              const SurfaceInteraction3f &si,
                                              Float /* sample1 */,
@@ -118,7 +133,7 @@ public:
         bs.sampled_type = +BSDFFlags::DiffuseReflection;
         bs.sampled_component = 0;
 
-        UnpolarizedSpectrum value = m_reflectance->eval(si, active);
+        UnpolarizedSpectrum value = reflectance(si, active);
 
         return { bs, depolarizer<Spectrum>(value) & (active && bs.pdf > 0.f) };
     }
@@ -136,7 +151,7 @@ public:
         active &= cos_theta_i > 0.f && cos_theta_o > 0.f;
 
         UnpolarizedSpectrum value =
-            m_reflectance->eval(si, active) * dr::InvPi<Float> * cos_theta_o;
+            reflectance(si, active) * dr::InvPi<Float> * cos_theta_o;
 
         return depolarizer<Spectrum>(value) & active;
     }
@@ -171,7 +186,7 @@ public:
         active &= cos_theta_i > 0.f && cos_theta_o > 0.f;
 
         UnpolarizedSpectrum value =
-            m_reflectance->eval(si, active) * dr::InvPi<Float> * cos_theta_o;
+            reflectance(si, active) * dr::InvPi<Float> * cos_theta_o;
 
         Float pdf = warp::square_to_cosine_hemisphere_pdf(wo);
 
@@ -180,7 +195,7 @@ public:
 
     Spectrum eval_diffuse_reflectance(const SurfaceInteraction3f &si,
                                       Mask active) const override {
-        return m_reflectance->eval(si, active);
+        return reflectance(si, active);
     }
 
     std::string to_string() const override {
@@ -193,8 +208,19 @@ public:
 
     MI_DECLARE_CLASS(SmoothDiffuse)
 private:
+    UnpolarizedSpectrum reflectance(const SurfaceInteraction3f &si,
+                                    Mask active) const {
+        if (m_reflectance_constant)
+            return m_reflectance_value;
+        return m_reflectance->eval(si, active);
+    }
+
     ref<Texture> m_reflectance;
 
+    /// Folded value of 'm_reflectance' when it is constant
+    bool m_reflectance_constant;
+    UnpolarizedSpectrum m_reflectance_value;
+
     MI_TRAVERSE_CB(Base, m_reflectance)
 };
 
@@ -49,3 +49,34 @@ def test03_chi2(variants_vec_backends_once_rgb):
     )
 
     assert chi2.run()
+
+
+def test04_constant_reflectance(variant_scalar_rgb):
+    si    = mi.SurfaceInteraction3f()
+    si.p  = [0, 0, 0]
+    si.n  = [0, 0, 1]
+    si.wi = [0, 0, 1]
+    si.uv = [0.25, 0.75]
+    si.sh_frame = mi.Frame3f(si.n)
+    ctx = mi.BSDFContext()
+
+    bsdf = mi.load_dict({'type': 'diffuse',
+                         'reflectance': {'type': 'rgb', 'value': [0.2, 0.4, 0.6]}})
+    assert not mi.has_flag(bsdf.flags(), mi.BSDFFlags.SpatiallyVarying)
+    assert dr.allclose(bsdf.eval_diffuse_reflectance(si), [0.2, 0.4, 0.6])
+
+    # The folded value follows parameter updates
+    params = mi.traverse(bsdf)
+    params['reflectance.value'] = [0.6, 0.4, 0.2]
+    params.update()
+    assert dr.allclose(bsdf.eval_diffuse_reflectance(si), [0.6, 0.4, 0.2])
+    assert dr.allclose(bsdf.eval(ctx, si, [0, 0, 1]), [0.6 / dr.pi, 0.4 / dr.pi, 0.2 / dr.pi])
+
+    bsdf = mi.load_dict({'type': 'diffuse',
+                         'reflectance': {'type': 'checkerboard',
+                                         'color0': [0.1, 0.2, 0.3],
+                                         'color1': [0.7, 0.8, 0.9]}})
+    assert mi.has_flag(bsdf.flags(), mi.BSDFFlags.SpatiallyVarying)
+    assert dr.allclose(bsdf.eval_diffuse_reflectance(si), [0.7, 0.8, 0.9])
+    si.uv = [0.25, 0.25]
+    assert dr.allclose(bsdf.eval_diffuse_reflectance(si), [0.1, 0.2, 0.3])
@@ -329,16 +329,16 @@ resample(Bitmap *target, const Bitmap *source,
         r.set_boundary_condition(bc.second);
         r.set_clamp(clamp);
 
+        /* Process all rows at once, split into blocks of columns. This streams
+           through memory instead of accessing one column at a time. */
+        size_t row_size = (size_t) source->width() * channels;
+
         dr::parallel_for(
-            dr::blocked_range<size_t>(0, source->width(), 100),
+            dr::blocked_range<size_t>(0, row_size, 4096),
             [&](const dr::blocked_range<size_t> &range) {
-                for (auto x = range.begin(); x != range.end(); ++x) {
-                    const Scalar *s = (const Scalar *) source->uint8_data() +
-                                      x * channels;
-                    Scalar *t       = (Scalar *) target->uint8_data() +
-                                      x * channels;
-                    r.resample(s, source->width(), t, target->width(), (uint32_t) channels);
-                }
+                r.resample_rows((const Scalar *) source->uint8_data(),
+                                (Scalar *) target->uint8_data(), row_size,
+                                range.begin(), range.end());
             }
         );
     }
@@ -11,6 +11,8 @@ void Object::traverse(TraversalCallback * /*callback*/) { }
 
 void Object::parameters_changed(const std::vector<std::string> &/*keys*/) { }
 
+size_t Object::memory_usage() const { return 0; }
+
 std::string Object::to_string() const {
     std::ostringstream oss;
     oss << class_name() << "[" << (void *) this << "]";
@@ -69,6 +69,7 @@ MI_PY_EXPORT(Object) {
         }, D(Object, expand))
         .def_method(Object, traverse, "cb"_a)
         .def_method(Object, parameters_changed, "keys"_a = nb::list())
+        .def_method(Object, memory_usage)
         .def_prop_ro("ptr", [](Object *self) { return (uintptr_t) self; })
         .def("__repr__", &Object::to_string, D(Object, to_string));
 }
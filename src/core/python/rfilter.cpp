@@ -43,7 +43,22 @@ MI_PY_EXPORT(rfilter) {
                                     channels);
             },
             D(Resampler, resample), "source"_a, "source_stride"_a, "target"_a,
-            "target_stride"_a, "channels"_a);
+            "target_stride"_a, "channels"_a)
+        .def("resample_rows",
+            [](Resampler &resampler, const ArrayType &source,
+                ArrayType &target, size_t row_size) {
+                if (resampler.source_resolution() * row_size != (size_t) source.size())
+                    throw std::runtime_error(
+                        "'source' has an incompatible size!");
+                if (resampler.target_resolution() * row_size != (size_t) target.size())
+                    throw std::runtime_error(
+                        "'target' has an incompatible size!");
+
+                resampler.resample_rows((const float *) source.data(),
+                                        (float *) target.data(), row_size,
+                                        0, row_size);
+            },
+            D(Resampler, resample_rows), "source"_a, "target"_a, "row_size"_a);
 
     m.attr("MI_FILTER_RESOLUTION") = MI_FILTER_RESOLUTION;
 }
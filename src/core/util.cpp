@@ -13,7 +13,13 @@
 #  include <dlfcn.h>
 #  include <unistd.h>
 #  include <limits.h>
+#  include <sched.h>
 #  include <sys/ioctl.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <algorithm>
+#  include <fstream>
+#  include <mutex>
 #elif defined(__APPLE__)
 #  include <sys/sysctl.h>
 #  include <mach-o/dyld.h>
@@ -120,6 +126,301 @@ done:
 #endif
 }
 
+#if defined(__linux__)
+/* NUMA topology, parsed once from sysfs. This avoids a dependency on libnuma,
+   which is frequently not installed on render nodes. */
+struct NumaTopology {
+    /// System ID of each NUMA node (IDs may have gaps)
+    std::vector<int> node_ids;
+    /// CPU indices of each NUMA node
+    std::vector<std::vector<int>> node_cpus;
+    /// NUMA node of each CPU
+    std::vector<int> cpu_node;
+};
+
+static std::vector<int> parse_cpu_list(const std::string &str) {
+    std::vector<int> result;
+    for (const std::string &range : string::tokenize(str, ",\n")) {
+        auto bounds = string::tokenize(range, "-");
+        if (bounds.empty())
+            continue;
+        int start = std::stoi(bounds[0]),
+            end   = bounds.size() > 1 ? std::stoi(bounds[1]) : start;
+        for (int i = start; i <= end; ++i)
+            result.push_back(i);
+    }
+    return result;
+}
+
+static const NumaTopology &numa_topology() {
+    static NumaTopology topology;
+    static std::once_flag flag;
+
+    std::call_once(flag, []() {
+        // Node IDs need not be contiguous (e.g. with memory-only nodes)
+        std::ifstream online("/sys/devices/system/node/online");
+        std::string line;
+        if (!online.good() || !std::getline(online, line))
+            return;
+
+        for (int id : parse_cpu_list(line)) {
+            std::ifstream is(tfm::format(
+                "/sys/devices/system/node/node%i/cpulist", id));
+            if (!is.good())
+                continue;
+            std::getline(is, line);
+            std::vector<int> cpus = parse_cpu_list(line);
+            int node = (int) topology.node_ids.size();
+            for (int cpu : cpus) {
+                if ((size_t) cpu >= topology.cpu_node.size())
+                    topology.cpu_node.resize(cpu + 1, 0);
+                topology.cpu_node[cpu] = node;
+            }
+            topology.node_ids.push_back(id);
+            topology.node_cpus.push_back(std::move(cpus));
+        }
+    });
+
+    return topology;
+}
+
+static thread_local int numa_pinned_node = -1;
+#endif
+
+int numa_node_count() {
+#if defined(__linux__)
+    return std::max((int) numa_topology().node_cpus.size(), 1);
+#else
+    return 1;
+#endif
+}
+
+int numa_node_current() {
+#if defined(__linux__)
+    if (numa_pinned_node >= 0)
+        return numa_pinned_node;
+    const NumaTopology &topology = numa_topology();
+    int cpu = sched_getcpu();
+    if (cpu < 0 || (size_t) cpu >= topology.cpu_node.size())
+        return 0;
+    return topology.cpu_node[cpu];
+#else
+    return 0;
+#endif
+}
+
+int numa_node_pinned() {
+#if defined(__linux__)
+    return numa_pinned_node;
+#else
+    return -1;
+#endif
+}
+
+bool numa_pin_thread(int node) {
+#if defined(__linux__)
+    const NumaTopology &topology = numa_topology();
+    if (node < 0 || (size_t) node >= topology.node_cpus.size() ||
+        topology.node_cpus[node].empty())
+        return false;
+
+    int max_cpu = (int) topology.cpu_node.size();
+    cpu_set_t *cpuset = CPU_ALLOC(max_cpu);
+    if (!cpuset)
+        return false;
+    size_t size = CPU_ALLOC_SIZE(max_cpu);
+    CPU_ZERO_S(size, cpuset);
+    for (int cpu : topology.node_cpus[node])
+        CPU_SET_S(cpu, size, cpuset);
+    int retval = pthread_setaffinity_np(pthread_self(), size, cpuset);
+    CPU_FREE(cpuset);
+
+    if (retval != 0)
+        return false;
+    numa_pinned_node = node;
+    return true;
+#else
+    (void) node;
+    return false;
+#endif
+}
+
+ScopedNumaPin::ScopedNumaPin(int node) {
+#if defined(__linux__)
+    int max_cpu = std::max((int) numa_topology().cpu_node.size(), CPU_SETSIZE);
+    cpu_set_t *cpuset = CPU_ALLOC(max_cpu);
+    if (!cpuset)
+        return;
+    size_t size = CPU_ALLOC_SIZE(max_cpu);
+    int prev_node = numa_pinned_node;
+
+    if (pthread_getaffinity_np(pthread_self(), size, cpuset) != 0 ||
+        !numa_pin_thread(node)) {
+        CPU_FREE(cpuset);
+        return;
+    }
+
+    m_saved_affinity = cpuset;
+    m_size = size;
+    m_prev_node = prev_node;
+#else
+    (void) node;
+#endif
+}
+
+ScopedNumaPin::~ScopedNumaPin() {
+#if defined(__linux__)
+    if (!m_saved_affinity)
+        return;
+    cpu_set_t *cpuset = (cpu_set_t *) m_saved_affinity;
+    pthread_setaffinity_np(pthread_self(), m_size, cpuset);
+    CPU_FREE(cpuset);
+    numa_pinned_node = m_prev_node;
+#endif
+}
+
+bool numa_place(const void *ptr, size_t size, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+    /* Memory policy constants from <numaif.h> */
+    constexpr int MPOL_BIND_ = 2, MPOL_INTERLEAVE_ = 3;
+    constexpr unsigned MPOL_MF_MOVE_ = 1u << 1;
+
+    int node_count = (int) numa_topology().node_cpus.size();
+    if (node_count < 2 || node >= node_count || !ptr)
+        return false;
+
+    /* mbind() requires page-aligned addresses, only consider whole pages */
+    uintptr_t page_size = (uintptr_t) sysconf(_SC_PAGESIZE),
+              start = ((uintptr_t) ptr + page_size - 1) & ~(page_size - 1),
+              end   = ((uintptr_t) ptr + size) & ~(page_size - 1);
+    if (end <= start)
+        return false;
+
+    /* The node mask is indexed by system node IDs, which may have gaps and
+       exceed the range of a fixed-size mask */
+    const std::vector<int> &ids = numa_topology().node_ids;
+    constexpr size_t long_bits = sizeof(unsigned long) * 8;
+    int max_id = *std::max_element(ids.begin(), ids.end());
+    std::vector<unsigned long> mask(max_id / long_bits + 1, 0ul);
+    auto set_bit = [&](int id) {
+        mask[id / long_bits] |= 1ul << (id % long_bits);
+    };
+    if (node < 0) {
+        for (int id : ids)
+            set_bit(id);
+    } else {
+        set_bit(ids[node]);
+    }
+
+    long retval = syscall(SYS_mbind, (void *) start, (unsigned long) (end - start),
+                          node < 0 ? MPOL_INTERLEAVE_ : MPOL_BIND_, mask.data(),
+                          (unsigned long) (mask.size() * long_bits) + 1,
+                          MPOL_MF_MOVE_);
+    return retval == 0;
+#else
+    (void) ptr; (void) size; (void) node;
+    return false;
+#endif
+}
+
+/// Huge page granularity assumed by alloc_pages() and advise_huge_pages()
+static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+static size_t round_to_huge_pages(size_t size) {
+    return (std::max(size, (size_t) 1) + HugePageSize - 1) & ~(HugePageSize - 1);
+}
+
+#if defined(__linux__)
+static size_t round_to_pages(size_t size) {
+    static const size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    return (std::max(size, (size_t) 1) + page_size - 1) & ~(page_size - 1);
+}
+#endif
+
+void *alloc_pages(size_t size, HugePages mode) {
+#if defined(__linux__)
+    if (mode != HugePages::None) {
+        size_t size_mapped = round_to_huge_pages(size);
+
+#  if defined(MAP_HUGETLB)
+        if (mode == HugePages::Explicit) {
+            void *ptr = mmap(nullptr, size_mapped, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (ptr != MAP_FAILED)
+                return ptr;
+
+            static std::once_flag warned;
+            std::call_once(warned, []() {
+                Log(Warn, "alloc_pages(): could not map explicit huge pages "
+                          "(is /proc/sys/vm/nr_hugepages set?), falling back "
+                          "to transparent huge pages.");
+            });
+        }
+#  endif
+
+        /* Over-allocate and trim the mapping so that it starts at a huge page
+           boundary, which is required for transparent huge pages to apply */
+        size_t size_padded = size_mapped + HugePageSize;
+        void *ptr = mmap(nullptr, size_padded, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+            throw std::bad_alloc();
+
+        uintptr_t base  = (uintptr_t) ptr,
+                  start = (base + HugePageSize - 1) & ~(HugePageSize - 1),
+                  end   = start + size_mapped;
+        if (start != base)
+            munmap(ptr, start - base);
+        if (end != base + size_padded)
+            munmap((void *) end, base + size_padded - end);
+
+#  if defined(MADV_HUGEPAGE)
+        madvise((void *) start, size_mapped, MADV_HUGEPAGE);
+#  endif
+        return (void *) start;
+    }
+
+    /* Map ordinary pages as well (instead of using the heap), so that page
+       level policies like numa_place() only apply to this allocation */
+    void *ptr = mmap(nullptr, round_to_pages(size), PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED)
+        throw std::bad_alloc();
+    return ptr;
+#else
+    (void) mode;
+    void *ptr = std::malloc(std::max(size, (size_t) 1));
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+#endif
+}
+
+void free_pages(void *ptr, size_t size, HugePages mode) {
+    if (!ptr)
+        return;
+#if defined(__linux__)
+    munmap(ptr, mode != HugePages::None ? round_to_huge_pages(size)
+                                        : round_to_pages(size));
+#else
+    (void) size; (void) mode;
+    std::free(ptr);
+#endif
+}
+
+bool advise_huge_pages(const void *ptr, size_t size) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    uintptr_t start = ((uintptr_t) ptr + HugePageSize - 1) & ~(HugePageSize - 1),
+              end   = ((uintptr_t) ptr + size) & ~(HugePageSize - 1);
+    if (!ptr || end <= start)
+        return false;
+    return madvise((void *) start, end - start, MADV_HUGEPAGE) == 0;
+#else
+    (void) ptr; (void) size;
+    return false;
+#endif
+}
+
 bool detect_debugger() {
 #if defined(__linux__)
     char exePath[PATH_MAX];
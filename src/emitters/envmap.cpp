@@ -230,6 +230,7 @@ public:
         m_data = TensorXf(bitmap_2->data(), 3, shape);
 
         m_scale = props.get<ScalarFloat>("scale", 1.f);
+        dr::make_opaque(m_scale);
         m_warp = Warp(luminance_data.get(), res);
         m_d65 = Texture::D65(1.f);
         m_flags = EmitterFlags::Infinite | EmitterFlags::SpatiallyVarying;
@@ -331,6 +332,10 @@ public:
 
             m_warp = Warp(luminance_data.get(), res);
         }
+
+        if (keys.empty() || string::contains(keys, "scale"))
+            dr::make_opaque(m_scale);
+
         Base::parameters_changed(keys);
     }
 
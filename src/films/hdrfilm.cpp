@@ -64,6 +64,14 @@ High dynamic range film (:monosp:`hdrfilm`)
      in JIT variants and can make sample accumulation quite a bit more expensive.
      (Default: |false|, i.e. disabled)
 
+ * - spectral_bins
+   - |int|
+   - Only relevant in spectral variants. If set to a value of at least 3,
+     the film accumulates the sampled radiance into this many wavelength bins
+     covering the visible range (360--830 nm), instead of converting every
+     sample to RGB. The conversion to the requested pixel format then happens
+     once per pixel when the film is developed. (Default: 0, i.e. disabled)
+
  * - (Nested plugin)
    - :paramtype:`rfilter`
    - Reconstruction filter that should be used by the film. (Default: :monosp:`gaussian`, a windowed
@@ -111,6 +119,18 @@ When RGB(A) output is selected, the measured spectral power distributions are
 converted to linear RGB based on the CIE 1931 XYZ color matching curves and
 the ITU-R Rec. BT.709-3 primaries with a D65 white point.
 
+In spectral variants, this conversion normally happens for every sample before
+it is splatted onto the film. When :monosp:`spectral_bins` is set, the film
+instead stores the band-integrated radiance of each wavelength bin and applies
+the (bin-averaged) color matching curves when developing the image. This
+removes the color matching work from the per-sample path at the cost of
+additional storage per pixel, and :monosp:`develop(raw=True)` then returns the
+binned data. Each sample only updates the (at most four) bins containing its
+wavelengths. The bins are a piecewise-constant approximation of the color
+matching curves, hence a reasonably large number of bins (e.g. 32) should be
+used when color accuracy matters. Adjoint integrators such as the particle
+tracer splat RGB samples directly and do not support this mode.
+
 The following XML snippet describes a film that writes a full-HD RGBA OpenEXR file:
 
 .. tabs::
@@ -226,6 +246,17 @@ public:
 
         m_compensate = props.get<bool>("compensate", false);
 
+        m_spectral_bins = props.get<uint32_t>("spectral_bins", 0);
+        if (m_spectral_bins > 0) {
+            if constexpr (!is_spectral_v<Spectrum>)
+                Throw("The \"spectral_bins\" parameter is only supported in "
+                      "spectral variants!");
+            if (m_spectral_bins < 3)
+                Throw("The \"spectral_bins\" parameter must be at least 3!");
+            m_flags |= +FilmFlags::Special;
+            compute_bin_weights();
+        }
+
         props.mark_queried("banner"); // no banner in Mitsuba 3
     }
 
@@ -261,9 +292,9 @@ public:
             std::lock_guard<std::mutex> lock(m_mutex);
             if (m_storage ==  nullptr)
                 jit_freeze_discard(drjit::detail::backend<Float>::value, "Image Block was allocated");
-            m_storage = new ImageBlock(m_crop_size, m_crop_offset,
-                                       (uint32_t) channels.size());
             m_channels = channels;
+            m_storage = new ImageBlock(m_crop_size, m_crop_offset,
+                                       storage_channel_count());
         }
 
         std::sort(channels.begin(), channels.end());
@@ -271,7 +302,7 @@ public:
         if (it != channels.end())
             Throw("Film::prepare(): duplicate channel name \"%s\"", *it);
 
-        return m_channels.size();
+        return storage_channel_count();
     }
 
     ref<ImageBlock> create_block(const ScalarVector2u &size, bool normalize,
@@ -283,7 +314,7 @@ public:
 
         return new ImageBlock(default_config ? m_crop_size : size,
                               default_config ? m_crop_offset : ScalarPoint2u(0),
-                              (uint32_t) m_channels.size(), m_filter.get(),
+                              storage_channel_count(), m_filter.get(),
                               border /* border */,
                               normalize /* normalize */,
                               dr::is_jit_v<Float> /* coalesce */,
@@ -292,6 +323,96 @@ public:
                               warn /* warn_invalid */);
     }
 
+    void prepare_sample(const UnpolarizedSpectrum &spec,
+                        const Wavelength &wavelengths, Float *aovs,
+                        Float weight, Float alpha, Mask active) const override {
+        bool has_alpha = has_flag(m_flags, FilmFlags::Alpha);
+        if (has_alpha)
+            aovs[3] = alpha;
+        aovs[has_alpha ? 4 : 3] = weight;
+
+        if constexpr (is_spectral_v<Spectrum>) {
+            constexpr size_t Size = dr::size_v<UnpolarizedSpectrum>;
+            ScalarFloat inv_size = 1.f / (ScalarFloat) Size;
+
+            UInt32 bin[Size];
+            Mask valid[Size];
+            locate_bins(wavelengths, active, bin, valid);
+
+            if constexpr (dr::is_array_v<Float>) {
+                for (uint32_t j = 0; j < m_spectral_bins; ++j) {
+                    Float value = 0.f;
+                    for (size_t i = 0; i < Size; ++i)
+                        value += dr::select(valid[i] && bin[i] == j, spec[i], 0.f);
+                    aovs[bin_channel(j)] = value * inv_size;
+                }
+            } else {
+                for (uint32_t j = 0; j < m_spectral_bins; ++j)
+                    aovs[bin_channel(j)] = 0.f;
+                for (size_t i = 0; i < Size; ++i) {
+                    if (valid[i])
+                        aovs[bin_channel(bin[i])] += spec[i] * inv_size;
+                }
+            }
+        } else {
+            DRJIT_MARK_USED(spec);
+            DRJIT_MARK_USED(wavelengths);
+            DRJIT_MARK_USED(active);
+        }
+    }
+
+    void put_sample(ImageBlock *block, const Point2f &pos,
+                    const UnpolarizedSpectrum &spec,
+                    const Wavelength &wavelengths, Float *aovs, Float weight,
+                    Float alpha, Mask active) const override {
+        if constexpr (is_spectral_v<Spectrum>) {
+            constexpr uint32_t Size = (uint32_t) dr::size_v<UnpolarizedSpectrum>;
+            ScalarFloat inv_size = 1.f / (ScalarFloat) Size;
+
+            bool has_alpha = has_flag(m_flags, FilmFlags::Alpha);
+            if (has_alpha)
+                aovs[3] = alpha;
+            aovs[has_alpha ? 4 : 3] = weight;
+
+            /* A sample touches at most 'Size' bins. Only splat those along
+               with the [A], W and AOV channels, which follow the first three
+               bins in the image block (see \ref bin_channel()) */
+            uint32_t channel_count = (uint32_t) m_channels.size(),
+                     count = channel_count - 3 + Size;
+
+            Float *values = (Float *) alloca(sizeof(Float) * count);
+            UInt32 *channels = (UInt32 *) alloca(sizeof(UInt32) * count);
+
+            for (uint32_t k = 3; k < channel_count; ++k) {
+                new (values + k - 3) Float(aovs[k]);
+                new (channels + k - 3) UInt32(k);
+            }
+
+            UInt32 bin[Size];
+            Mask valid[Size];
+            locate_bins(wavelengths, active, bin, valid);
+
+            for (uint32_t i = 0; i < Size; ++i) {
+                uint32_t k = channel_count - 3 + i;
+                new (values + k)
+                    Float(dr::select(valid[i], spec[i] * inv_size, 0.f));
+                new (channels + k)
+                    UInt32(dr::select(bin[i] < 3, bin[i],
+                                      bin[i] + (channel_count - 3)));
+            }
+
+            block->put(pos, values, channels, count, active);
+
+            for (uint32_t k = 0; k < count; ++k) {
+                values[k].~Float();
+                channels[k].~UInt32();
+            }
+        } else {
+            Base::put_sample(block, pos, spec, wavelengths, aovs, weight,
+                             alpha, active);
+        }
+    }
+
     void put_block(const ImageBlock *block) override {
         Assert(m_storage != nullptr);
         std::lock_guard<std::mutex> lock(m_mutex);
@@ -320,9 +441,9 @@ public:
 
             /* locked */ {
                 std::lock_guard<std::mutex> lock(m_mutex);
-                data        = m_storage->tensor().array();
+                data        = resolve_bins(m_storage->tensor().array());
                 size        = m_storage->size();
-                source_ch   = (uint32_t) m_storage->channel_count();
+                source_ch   = (uint32_t) m_channels.size();
                 pixel_count = dr::prod(m_storage->size());
             }
 
@@ -424,7 +545,8 @@ public:
             Throw("No storage allocated, was prepare() called first?");
 
         std::lock_guard<std::mutex> lock(m_mutex);
-        auto &&storage = dr::migrate(m_storage->tensor().array(), AllocType::Host);
+        FloatStorage data = resolve_bins(m_storage->tensor().array());
+        auto &&storage = dr::migrate(data, AllocType::Host);
 
         if constexpr (dr::is_jit_v<Float>)
             dr::sync_thread();
@@ -440,7 +562,7 @@ public:
 
         ref<Bitmap> source = new Bitmap(
             source_fmt, struct_type_v<ScalarFloat>, m_storage->size(),
-            m_storage->channel_count(), m_channels, (uint8_t *) storage.data());
+            m_channels.size(), m_channels, (uint8_t *) storage.data());
 
         if (raw)
             return source;
@@ -455,7 +577,7 @@ public:
         uint32_t img_ch = to_y ? 1 : 3;
         uint32_t aovs_channel = has_aovs ? (img_ch + (uint32_t) alpha) : 0;
         uint32_t target_ch =
-            (uint32_t) m_storage->channel_count() - base_ch + aovs_channel;
+            (uint32_t) m_channels.size() - base_ch + aovs_channel;
 
         ref<Bitmap> target = new Bitmap(
             has_aovs ? Bitmap::PixelFormat::MultiChannel : m_pixel_format,
@@ -546,6 +668,10 @@ public:
     }
 
     void write(const fs::path &path) const override {
+        write_bitmap(bitmap(), path);
+    }
+
+    void write_bitmap(const Bitmap *source, const fs::path &path) const override {
         fs::path filename = path;
         std::string proper_extension;
         if (m_file_format == Bitmap::FileFormat::OpenEXR)
@@ -565,7 +691,6 @@ public:
             Log(Info, "Developing \"%s\" ..", filename.string());
         #endif
 
-        ref<Bitmap> source = bitmap();
         if (m_component_format != struct_type_v<ScalarFloat>) {
             // Mismatch between the current format and the one expected by the film
             // Conversion is necessary before saving to disk
@@ -590,6 +715,13 @@ public:
         dr::schedule(m_storage->tensor());
     };
 
+    size_t memory_usage() const override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_storage)
+            return Base::memory_usage();
+        return dr::width(m_storage->tensor().array()) * sizeof(ScalarFloat);
+    }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "HDRFilm[" << std::endl
@@ -602,12 +734,110 @@ public:
             << "  file_format = " << m_file_format << "," << std::endl
             << "  pixel_format = " << m_pixel_format << "," << std::endl
             << "  component_format = " << m_component_format << "," << std::endl
+            << "  spectral_bins = " << m_spectral_bins << std::endl
             << "]";
         return oss.str();
     }
 
     MI_DECLARE_CLASS(HDRFilm)
 protected:
+    using FloatStorage  = DynamicBuffer<Float>;
+    using UInt32Storage = DynamicBuffer<UInt32>;
+
+    /// Number of channels of the image block (more than \ref m_channels with bins)
+    uint32_t storage_channel_count() const {
+        uint32_t count = (uint32_t) m_channels.size();
+        return m_spectral_bins > 0 ? count + m_spectral_bins - 3 : count;
+    }
+
+    /**
+     * \brief Image block channel storing a given wavelength bin
+     *
+     * The integrators write AOVs right after the R, G, B, [A], W channels.
+     * The first three bins therefore take the place of the color channels,
+     * while the remaining ones are appended after the AOVs.
+     */
+    uint32_t bin_channel(uint32_t bin) const {
+        return bin < 3 ? bin : (uint32_t) m_channels.size() + bin - 3;
+    }
+
+    /// Locate the bin of each wavelength sample, \c valid is false outside of all bins
+    void locate_bins(const Wavelength &wavelengths, Mask active,
+                     UInt32 *bin, Mask *valid) const {
+        ScalarFloat scale = (ScalarFloat) m_spectral_bins /
+                            ((ScalarFloat) MI_CIE_MAX - (ScalarFloat) MI_CIE_MIN);
+
+        for (size_t i = 0; i < dr::size_v<Wavelength>; ++i) {
+            Float pos = (wavelengths[i] - (ScalarFloat) MI_CIE_MIN) * scale;
+            valid[i] = active && pos >= 0.f && pos < (ScalarFloat) m_spectral_bins;
+            bin[i] = dr::minimum(UInt32(dr::maximum(pos, 0.f)), m_spectral_bins - 1);
+        }
+    }
+
+    /// Average the linear sRGB color matching curves over each wavelength bin
+    void compute_bin_weights() {
+        using ScalarWavelength = dr::Array<ScalarFloat, 4>;
+        constexpr uint32_t Steps = 4; // Groups of 4 wavelengths per bin
+
+        ScalarFloat width = ((ScalarFloat) MI_CIE_MAX - (ScalarFloat) MI_CIE_MIN) /
+                            (ScalarFloat) m_spectral_bins;
+        ScalarWavelength offset = (dr::arange<ScalarWavelength>() + .5f) /
+                                  (ScalarFloat) (Steps * 4);
+
+        m_bin_rgb.resize(m_spectral_bins);
+        for (uint32_t j = 0; j < m_spectral_bins; ++j) {
+            ScalarColor3f sum(0.f);
+            for (uint32_t k = 0; k < Steps; ++k) {
+                ScalarWavelength wavelengths =
+                    (ScalarFloat) MI_CIE_MIN +
+                    width * (j + (ScalarFloat) k / (ScalarFloat) Steps + offset);
+                auto rgb = linear_rgb_rec(wavelengths);
+                sum += ScalarColor3f(dr::sum(rgb.x()), dr::sum(rgb.y()),
+                                     dr::sum(rgb.z()));
+            }
+
+            /* Bins store band-integrated radiance estimates. Using the mean of
+               the curves matches the normalization of spectrum_to_srgb() */
+            m_bin_rgb[j] = sum * (ScalarFloat) (MI_CIE_Y_NORMALIZATION / (Steps * 4));
+        }
+    }
+
+    /**
+     * \brief Convert the binned image block data into the regular channel
+     * layout (R, G, B, [A], W, AOVs). Returns the data unchanged when the
+     * film doesn't use wavelength bins.
+     */
+    FloatStorage resolve_bins(const FloatStorage &data) const {
+        if (m_spectral_bins == 0)
+            return data;
+
+        uint32_t source_ch = storage_channel_count(),
+                 target_ch = (uint32_t) m_channels.size(),
+                 pixel_count = (uint32_t) (dr::width(data) / source_ch);
+
+        UInt32Storage idx         = dr::arange<UInt32Storage>(pixel_count * target_ch),
+                      pixel_idx   = idx / target_ch,
+                      channel_idx = idx - pixel_idx * target_ch,
+                      source_idx  = pixel_idx * source_ch;
+
+        // Alpha, weight and AOV channels are at the same position in both layouts
+        auto is_color = channel_idx < 3u;
+        FloatStorage result =
+            dr::gather<FloatStorage>(data, source_idx + channel_idx, !is_color);
+
+        for (uint32_t j = 0; j < m_spectral_bins; ++j) {
+            const ScalarColor3f &w = m_bin_rgb[j];
+            FloatStorage value =
+                dr::gather<FloatStorage>(data, source_idx + bin_channel(j), is_color),
+                weight = dr::select(channel_idx == 0u, FloatStorage(w.x()),
+                                    dr::select(channel_idx == 1u, FloatStorage(w.y()),
+                                               FloatStorage(w.z())));
+            result = dr::fmadd(value, weight, result);
+        }
+
+        return result;
+    }
+
     Bitmap::FileFormat m_file_format;
     Bitmap::PixelFormat m_pixel_format;
     Struct::Type m_component_format;
@@ -615,6 +845,8 @@ protected:
     ref<ImageBlock> m_storage;
     mutable std::mutex m_mutex;
     std::vector<std::string> m_channels;
+    uint32_t m_spectral_bins;
+    std::vector<ScalarColor3f> m_bin_rgb;
 
     MI_TRAVERSE_CB(Base, m_storage)
 };
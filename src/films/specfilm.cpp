@@ -92,6 +92,11 @@ distribution with all the different SRFs using inverse transform sampling. Then
 samples across all the spectral ranges of wavelengths covered by the SRFs. These strategies greatly
 reduce the spectral noise that would appear if each channel were calculated independently.
 
+All SRFs are tabulated at load time on a common, regularly spaced wavelength grid (the one used for
+the combined sampling distribution). The per-sample weights of all channels are then interpolated
+from this packed table with direct indexing rather than by evaluating every SRF texture, which keeps
+the cost of films with many channels low.
+
 .. subfigstart::
 .. subfigure:: ../../resources/data/docs/images/films/cbox_complete.png
    :caption: ``RGB`` spectral rendering
@@ -199,36 +204,66 @@ public:
             cb->put(m_names[i], m_srfs[i], ParamFlags::NonDifferentiable);
     }
 
+    void parameters_changed(const std::vector<std::string> &keys = {}) override {
+        Base::parameters_changed(keys);
+
+        // Re-tabulate the SRFs if any of them was modified
+        bool srf_changed = keys.empty();
+        for (const std::string &key : keys)
+            for (const std::string &name : m_names)
+                srf_changed |= string::starts_with(key, name);
+        if (srf_changed)
+            compute_srf_sampling();
+    }
+
     void compute_srf_sampling() {
         ScalarFloat resolution = dr::Infinity<ScalarFloat>;
+        m_range = ScalarVector2f(dr::Infinity<ScalarFloat>, -dr::Infinity<ScalarFloat>);
+        m_srf_ranges.clear();
         // Compute full range of wavelengths and resolution in the film
         for (auto srf : m_srfs) {
-            m_range.x() = dr::minimum(m_range.x(), srf->wavelength_range().x());
-            m_range.y() = dr::maximum(m_range.y(), srf->wavelength_range().y());
+            ScalarVector2f range = srf->wavelength_range();
+            m_range.x() = dr::minimum(m_range.x(), range.x());
+            m_range.y() = dr::maximum(m_range.y(), range.y());
+            m_srf_ranges.push_back(range);
             resolution = dr::minimum(resolution, srf->spectral_resolution());
         }
 
         // Compute resolution of the discretized PDF used for sampling
-        size_t n_points = (size_t) dr::ceil((m_range.y() - m_range.x()) / resolution + 1);
+        size_t n_points = dr::maximum((size_t) 2,
+            (size_t) dr::ceil((m_range.y() - m_range.x()) / resolution + 1));
         FloatStorage mis_data = dr::zeros<FloatStorage>(n_points);
         FloatStorage mis_wavelengths = dr::linspace<FloatStorage>(m_range.x(), m_range.y(), n_points);
 
+        /* Packed table of all SRFs on the same grid, used by prepare_sample().
+           Each row holds the values of the individual channels followed by
+           their sum (i.e. the sampling density 'mis_data'). */
+        uint32_t stride = (uint32_t) m_srfs.size() + 1;
+        m_srf_table = dr::zeros<FloatStorage>(n_points * stride);
+        m_srf_points = (uint32_t) n_points;
+        m_srf_scale = (ScalarFloat) (n_points - 1) / (m_range.y() - m_range.x());
+
         SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
         // Each wavelength is duplicated with the size of the Spectrum (default
         // constructor while initialized with only a number)
         if constexpr (dr::is_jit_v<Float>) {
             si.wavelengths = mis_wavelengths;
-            for (auto srf : m_srfs) {
-                UnpolarizedSpectrum values = srf->eval(si);
+            UInt32 row = dr::arange<UInt32>((uint32_t) n_points) * stride;
+            for (uint32_t j = 0; j < m_srfs.size(); ++j) {
+                UnpolarizedSpectrum values = m_srfs[j]->eval(si);
                 mis_data += values.x();
+                dr::scatter(m_srf_table, values.x(), row + j);
             }
+            dr::scatter(m_srf_table, mis_data, row + (stride - 1));
         } else {
             for (size_t i = 0; i < n_points; ++i) {
                 si.wavelengths = mis_wavelengths[i];
-                for (auto srf : m_srfs) {
-                    UnpolarizedSpectrum values = srf->eval(si);
+                for (size_t j = 0; j < m_srfs.size(); ++j) {
+                    UnpolarizedSpectrum values = m_srfs[j]->eval(si);
                     mis_data[i] += values.x();
+                    m_srf_table[i * stride + j] = values.x();
                 }
+                m_srf_table[i * stride + stride - 1] = mis_data[i];
             }
         }
 
@@ -295,26 +330,47 @@ public:
     }
 
     void prepare_sample(const UnpolarizedSpectrum &spec, const Wavelength &wavelengths,
-                        Float* aovs, Float weight, Float /* alpha */, Mask /* active */) const override {
+                        Float* aovs, Float weight, Float /* alpha */, Mask active) const override {
         aovs[m_channels.size() - 1] = weight;   // Set sample weight
 
-        SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
-        si.wavelengths = wavelengths;
-
-        // The SRF is not necessarily normalized, cancel out multiplicative factors
-        UnpolarizedSpectrum inv_spec = m_srf->eval(si);
-        inv_spec = dr::select(inv_spec != 0.f, dr::rcp(inv_spec), 1.f);
-        UnpolarizedSpectrum values = spec * inv_spec;
+        uint32_t channels = (uint32_t) m_srfs.size(),
+                 stride   = channels + 1;
+        ScalarFloat pos_max = (ScalarFloat) (m_srf_points - 1);
 
-        for (size_t j = 0; j < m_srfs.size(); ++j) {
-            UnpolarizedSpectrum weights = m_srfs[j]->eval(si);
+        for (size_t j = 0; j < channels; ++j)
             aovs[j] = dr::zeros<Float>();
 
-            for (size_t i = 0; i<Spectrum::Size; ++i)
-                aovs[j] = dr::fmadd(weights[i], values[i], aovs[j]);
+        for (size_t i = 0; i < Spectrum::Size; ++i) {
+            // Locate the wavelength in the packed SRF table
+            Float pos = (wavelengths[i] - m_range.x()) * m_srf_scale;
+            Mask valid = active && pos >= 0.f && pos <= pos_max;
+            UInt32 index = dr::minimum(UInt32(dr::clip(pos, 0.f, pos_max)),
+                                       m_srf_points - 2);
+            Float t = pos - Float(index);
+            index *= stride;
+
+            auto lookup = [&](uint32_t channel) {
+                Float v0 = dr::gather<Float>(m_srf_table, index + channel, valid),
+                      v1 = dr::gather<Float>(m_srf_table, index + (stride + channel), valid);
+                return dr::lerp(v0, v1, t);
+            };
+
+            // The SRF is not necessarily normalized, cancel out multiplicative factors
+            Float norm = lookup(channels),
+                  value = spec[i] * dr::select(norm != 0.f, dr::rcp(norm), 1.f);
+
+            /* Grid cells may straddle the end of an SRF's range. Mask each
+               channel so that it stays zero outside of that range */
+            for (uint32_t j = 0; j < channels; ++j) {
+                Mask in_range = wavelengths[i] >= m_srf_ranges[j].x() &&
+                                wavelengths[i] <= m_srf_ranges[j].y();
+                aovs[j] = dr::fmadd(dr::select(in_range, lookup(j), 0.f),
+                                    value, aovs[j]);
+            }
+        }
 
+        for (size_t j = 0; j < channels; ++j)
             aovs[j] *= 1.f / Spectrum::Size;
-        }
     }
 
     void put_block(const ImageBlock *block) override {
@@ -426,6 +482,10 @@ public:
     }
 
     void write(const fs::path &path) const override {
+        write_bitmap(bitmap(), path);
+    }
+
+    void write_bitmap(const Bitmap *source, const fs::path &path) const override {
         fs::path filename = path;
         std::string proper_extension = ".exr";
 
@@ -439,7 +499,6 @@ public:
             Log(Info, "Developing \"%s\" ..", filename.string());
         #endif
 
-        ref<Bitmap> source = bitmap();
         if (m_component_format != struct_type_v<ScalarFloat>) {
             // Mismatch between the current format and the one expected by the film
             // Conversion is necessary before saving to disk
@@ -464,6 +523,13 @@ public:
         dr::schedule(m_storage->tensor());
     };
 
+    size_t memory_usage() const override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_storage)
+            return Base::memory_usage();
+        return dr::width(m_storage->tensor().array()) * sizeof(ScalarFloat);
+    }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "SpecFilm[" << std::endl
@@ -496,6 +562,13 @@ protected:
     std::vector<ref<Texture>> m_srfs;
     std::vector<std::string> m_names;
     ScalarVector2f m_range { dr::Infinity<ScalarFloat>, -dr::Infinity<ScalarFloat> };
+
+    /// SRFs tabulated on a regular grid over \c m_range (see compute_srf_sampling())
+    FloatStorage m_srf_table;
+    /// Wavelength range of each SRF, outside of which its channel is zero
+    std::vector<ScalarVector2f> m_srf_ranges;
+    uint32_t m_srf_points = 0;
+    ScalarFloat m_srf_scale = 0.f;
 };
 
 MI_EXPORT_PLUGIN(SpecFilm)
@@ -236,3 +236,108 @@ def test07_luminance_alpha_mono(variants_all):
     image = mi.TensorXf(film.bitmap())
 
     assert image.shape[2] == 2
+
+
+def test08_write_bitmap(variant_scalar_rgb, tmpdir):
+    # Writing a snapshot of the film is equivalent to writing the film itself
+    film = mi.load_dict({
+        'type': 'hdrfilm',
+        'width': 5,
+        'height': 4,
+        'component_format': 'float16',
+        'rfilter': {'type': 'box'}
+    })
+    film.prepare([])
+
+    block = film.create_block()
+    block.put([1.5, 2.5], [1.0, 0.5, 0.25, 1.0, 1.0])
+    film.put_block(block)
+
+    bitmap = film.bitmap()
+    film.clear()
+
+    # The film extension and component format are applied to the snapshot
+    filename = str(tmpdir.join('snapshot.png'))
+    film.write_bitmap(bitmap, filename)
+    other = mi.Bitmap(str(tmpdir.join('snapshot.exr')))
+    assert other.component_format() == mi.Struct.Type.Float16
+
+    image = mi.TensorXf(other)
+    assert dr.allclose(image[2, 1, :3], [1.0, 0.5, 0.25])
+    assert dr.all(image[0, 0, :3] == 0)
+
+
+def test09_spectral_bins(variant_scalar_spectral):
+    film = mi.load_dict({
+        'type': 'hdrfilm',
+        'width': 1,
+        'height': 1,
+        'pixel_format': 'rgba',
+        'spectral_bins': 47,
+        'rfilter': {'type': 'box'}
+    })
+    assert mi.has_flag(film.flags(), mi.FilmFlags.Special)
+    channels = film.prepare([])
+    assert channels == 5 + 47 - 3
+
+    # Each wavelength falls into its own 10nm bin
+    spec = mi.UnpolarizedSpectrum([1.0, 2.0, 3.0, 4.0])
+    wavelengths = mi.Wavelength([365, 455, 555, 825])
+    aovs = film.prepare_sample(spec, wavelengths, channels,
+                               weight=1.0, alpha=0.5)
+    assert dr.allclose(aovs[3:5], [0.5, 1.0])
+    assert dr.allclose(aovs[0], 0.25)
+    assert dr.allclose(sum(aovs[5:]) + aovs[1] + aovs[2], 2.25)
+
+    # Developing the film applies the bin-averaged color matching curves
+    block = film.create_block()
+    for i in range(400):
+        wavelengths = mi.Wavelength(360 + (dr.arange(mi.Wavelength) + i * 4 + 0.5) * 470 / 1600)
+        block.put([0.5, 0.5], film.prepare_sample(spec, wavelengths, channels))
+    film.put_block(block)
+
+    image = film.develop()
+    ref = mi.Color3f(0)
+    for i in range(400):
+        wavelengths = mi.Wavelength(360 + (dr.arange(mi.Wavelength) + i * 4 + 0.5) * 470 / 1600)
+        ref += mi.spectrum_to_srgb(spec, wavelengths) / 400
+
+    assert dr.allclose(image.array[:3], ref, rtol=2e-2)
+
+    # Raw data holds the bins
+    assert film.develop(raw=True).shape[2] == channels
+
+    with pytest.raises(RuntimeError, match='spectral_bins'):
+        mi.load_dict({'type': 'hdrfilm', 'spectral_bins': 2})
+
+
+def test10_spectral_bins_rgb_variant(variant_scalar_rgb):
+    with pytest.raises(RuntimeError, match='spectral variants'):
+        mi.load_dict({'type': 'hdrfilm', 'spectral_bins': 16})
+
+
+def test11_spectral_bins_put_sample(variants_all_spectral):
+    # Splatting only the touched bins matches the dense prepare_sample() path
+    film = mi.load_dict({
+        'type': 'hdrfilm',
+        'width': 3,
+        'height': 2,
+        'pixel_format': 'rgba',
+        'spectral_bins': 16,
+        'rfilter': {'type': 'gaussian'}
+    })
+    channels = film.prepare([])
+
+    # Two samples share a bin, one falls outside of the CIE range
+    spec = mi.UnpolarizedSpectrum([1.0, 2.0, 3.0, 4.0])
+    wavelengths = mi.Wavelength([365, 367, 555, 840])
+    pos = mi.Point2f(1.3, 0.8)
+
+    block = film.create_block()
+    film.put_sample(block, pos, spec, wavelengths, weight=1.0, alpha=0.5)
+
+    ref = film.create_block()
+    ref.put(pos, film.prepare_sample(spec, wavelengths, channels,
+                                     weight=1.0, alpha=0.5))
+
+    assert dr.allclose(block.tensor(), ref.tensor())
@@ -204,3 +204,39 @@ def test07_srf(variants_all_spectral):
 
     dr.allclose(params[key_range], [400, 800])
     dr.allclose(params[key_values], [0.1, 0.2, 0., 0.3, 0.4])
+
+
+def test08_prepare_sample(variant_scalar_spectral):
+    film = mi.load_dict({
+        'type': 'specfilm',
+        'channel1': {
+            'type': 'regular',
+            'wavelength_min': 400,
+            'wavelength_max': 500,
+            'values': "0.1, 0.2",
+        },
+        'channel2': {
+            'type': 'regular',
+            'wavelength_min': 700,
+            'wavelength_max': 800,
+            'values': "0.3, 0.4",
+        },
+    })
+    channels = film.prepare([])
+
+    # Each wavelength lies within a single band, the normalized weights are 1
+    spec = mi.UnpolarizedSpectrum(1.0)
+    wavelengths = mi.Wavelength([450, 475, 720, 790])
+    aovs = film.prepare_sample(spec, wavelengths, channels, weight=2.0)
+    assert dr.allclose(aovs, [0.5, 0.5, 2.0])
+
+    # Samples outside of the SRF range don't contribute
+    wavelengths = mi.Wavelength([350, 450, 850, 900])
+    aovs = film.prepare_sample(spec, wavelengths, channels)
+    assert dr.allclose(aovs, [0.25, 0.0, 1.0])
+
+    # Samples in the gap between the two SRFs don't contribute either, even
+    # though the tabulation grid interpolates across it
+    wavelengths = mi.Wavelength([550, 600, 650, 450])
+    aovs = film.prepare_sample(spec, wavelengths, channels)
+    assert dr.allclose(aovs, [0.25, 0.0, 1.0])
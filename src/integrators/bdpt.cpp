@@ -0,0 +1,745 @@
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/ray.h>
+#include <mitsuba/core/warp.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/records.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/sensor.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _integrator-bdpt:
+
+Bidirectional path tracer (:monosp:`bdpt`)
+------------------------------------------
+
+.. pluginparameters::
+
+ * - max_depth
+   - |int|
+   - Specifies the longest path depth in the generated output image (where -1 corresponds to
+     :math:`\infty`). A value of 1 will only render directly visible light sources. 2 will lead
+     to single-bounce (direct-only) illumination, and so on. (Default: -1)
+
+ * - rr_depth
+   - |int|
+   - Specifies the minimum path depth, after which the implementation will start to use the
+     *russian roulette* path termination criterion. (Default: 5)
+
+ * - hide_emitters
+   - |bool|
+   - Hide directly visible emitters. (Default: no, i.e. |false|)
+
+ * - samples_per_pass
+   - |bool|
+   - If specified, divides the workload in successive passes with :paramtype:`samples_per_pass`
+     samples per pixel.
+
+This integrator traces one subpath from the sensor and one from a light source per sample,
+and then connects every prefix of the two subpaths. The resulting family of estimators is
+combined using multiple importance sampling (power heuristic), which makes the technique
+robust on scenes where light reaches the visible surfaces through small openings, or via
+caustic paths that are difficult to find starting from the sensor.
+
+Light subpaths are started on area emitters. Other emitters (environment maps, point,
+spot and directional lights) are handled using emitter sampling and BSDF sampling from
+the sensor subpath, weighted in the same way as in the :ref:`path <integrator-path>` plugin.
+Connections of light subpaths to the sensor are splatted to the film, like in the
+:ref:`ptracer <integrator-ptracer>` plugin. The multiple importance sampling weights
+assume a pinhole sensor; other sensors are supported and remain unbiased, but their
+weights are less effective.
+
+This integrator does not support media (volumes), and it is only available in scalar,
+unpolarized variants. A vectorized version would have to store two subpaths of up to
+:paramtype:`max_depth` vertices per lane and evaluate a number of connections that
+differs from lane to lane, with MIS weights that walk over both subpaths. In the
+wavefront variants, this turns every vertex access into a gather from global memory,
+which defeats the purpose of the technique.
+
+.. tabs::
+    .. code-tab::  xml
+
+        <integrator type="bdpt">
+            <integer name="max_depth" value="8"/>
+        </integrator>
+
+    .. code-tab:: python
+
+        'type': 'bdpt',
+        'max_depth': 8
+
+ */
+
+template <typename Float, typename Spectrum>
+class BidirectionalPathIntegrator final : public AdjointIntegrator<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(AdjointIntegrator, m_hide_emitters, m_rr_depth, m_max_depth)
+    MI_IMPORT_TYPES(Scene, Sensor, Sampler, ImageBlock, Emitter, EmitterPtr,
+                     BSDF, BSDFPtr)
+
+    BidirectionalPathIntegrator(const Properties &props) : Base(props) {
+        if constexpr (dr::is_jit_v<Float> || is_polarized_v<Spectrum>)
+            Throw("The bidirectional path tracer (\"bdpt\") is only "
+                  "supported in scalar, unpolarized variants!");
+    }
+
+    void sample(const Scene *scene, const Sensor *sensor, Sampler *sampler,
+                ImageBlock *block, ScalarFloat sample_scale) const override {
+        sample_indexed(scene, sensor, sampler, block, sample_scale,
+                       (size_t) -1);
+    }
+
+    void sample_indexed(const Scene *scene, const Sensor *sensor,
+                        Sampler *sampler, ImageBlock *block,
+                        ScalarFloat sample_scale, size_t index) const override {
+        if constexpr (!dr::is_jit_v<Float> && !is_polarized_v<Spectrum>) {
+            sample_scalar(scene, sensor, sampler, block, sample_scale, index);
+        } else {
+            DRJIT_MARK_USED(scene);
+            DRJIT_MARK_USED(sensor);
+            DRJIT_MARK_USED(sampler);
+            DRJIT_MARK_USED(block);
+            DRJIT_MARK_USED(sample_scale);
+            DRJIT_MARK_USED(index);
+        }
+    }
+
+    std::string to_string() const override {
+        return tfm::format("BidirectionalPathIntegrator[\n"
+                           "  max_depth = %i,\n"
+                           "  rr_depth = %i\n"
+                           "]",
+                           m_max_depth, m_rr_depth);
+    }
+
+    MI_DECLARE_CLASS(BidirectionalPathIntegrator)
+
+protected:
+    /// Vertex of a sensor or light subpath
+    struct Vertex {
+        enum class Type : uint8_t { Sensor, Light, Surface };
+
+        Type type = Type::Surface;
+        TransportMode mode = TransportMode::Radiance;
+        /// Interaction at the vertex, \c si.wi points toward the previous vertex
+        SurfaceInteraction3f si;
+        BSDFPtr bsdf = nullptr;
+        EmitterPtr emitter = nullptr;
+        /// Throughput of the subpath up to (excluding) this vertex
+        Spectrum beta;
+        /// Area densities of generating this vertex along / against the subpath
+        Float pdf_fwd = 0.f, pdf_rev = 0.f;
+        /// Was the next vertex sampled from a Dirac delta BSDF lobe?
+        bool delta = false;
+
+        bool on_surface() const { return type != Type::Sensor; }
+
+        bool connectible() const {
+            return type != Type::Surface ||
+                   has_flag(bsdf->flags(), BSDFFlags::Smooth);
+        }
+    };
+
+    /// Densities of a vertex as seen by the MIS weight computation
+    struct MISRecord {
+        Float pdf_fwd, pdf_rev;
+        bool delta;
+    };
+
+    /**
+     * Traces and connects one pair of subpaths. When \c index is not
+     * <tt>(size_t) -1</tt>, consecutive samples start their sensor subpath
+     * in consecutive pixels of the crop window, like a sampling integrator
+     * would. Otherwise, the film position is uniformly distributed.
+     */
+    void sample_scalar(const Scene *scene, const Sensor *sensor,
+                       Sampler *sampler, ImageBlock *block,
+                       ScalarFloat sample_scale, size_t index) const {
+        if (m_max_depth == 0)
+            return;
+
+        // Subpath storage is reused across samples
+        static thread_local std::vector<Vertex> sensor_path, light_path;
+        sensor_path.clear();
+        light_path.clear();
+
+        size_t max_depth = m_max_depth < 0 ? (size_t) -1 : (size_t) m_max_depth,
+               max_sensor_vertices = m_max_depth < 0 ? (size_t) -1 : max_depth + 1;
+
+        // 1. Time and wavelength sampling
+        Float time = sensor->shutter_open();
+        if (sensor->shutter_open_time() > 0)
+            time += sampler->next_1d() * sensor->shutter_open_time();
+
+        Float wavelength_sample = sampler->next_1d();
+        Point2f position_sample = sampler->next_2d();
+        if (index != (size_t) -1) {
+            ScalarVector2u crop_size = sensor->film()->crop_size();
+            size_t pixel = index % ((size_t) crop_size.x() * crop_size.y());
+            Point2f pixel_pos((Float) (pixel % crop_size.x()),
+                              (Float) (pixel / crop_size.x()));
+            position_sample =
+                (pixel_pos + position_sample) / ScalarVector2f(crop_size);
+        }
+        Point2f aperture_sample(.5f);
+        if (sensor->needs_aperture_sample())
+            aperture_sample = sampler->next_2d();
+
+        auto [ray, ray_weight] = sensor->sample_ray(
+            time, wavelength_sample, position_sample, aperture_sample);
+
+        /* Light subpaths are splatted at arbitrary film positions, so they
+           need the wavelength sampling weight separately from `ray_weight` */
+        Spectrum wav_weight(1.f);
+        if constexpr (is_spectral_v<Spectrum>)
+            wav_weight = sensor->sample_wavelengths(
+                dr::zeros<SurfaceInteraction3f>(), wavelength_sample).second;
+
+        Wavelength wavelengths = ray.wavelengths;
+
+        // 2. Sensor subpath
+        Vertex z0;
+        z0.type = Vertex::Type::Sensor;
+        z0.si = dr::zeros<SurfaceInteraction3f>();
+        z0.si.p = sensor->world_transform().translation();
+        z0.si.time = time;
+        z0.si.wavelengths = wavelengths;
+        z0.beta = ray_weight;
+        sensor_path.push_back(z0);
+
+        /* The direction density of primary rays is fixed up below, since
+           it is more conveniently expressed in terms of the first vertex */
+        WalkEnd sensor_end =
+            random_walk(scene, sampler, ray, ray_weight, 0.f,
+                        TransportMode::Radiance, max_sensor_vertices,
+                        sensor_path);
+        if (sensor_path.size() > 1)
+            sensor_path[1].pdf_fwd = sensor_pdf(sensor, sensor_path[1]);
+
+        // 3. Light subpath, started on an area emitter
+        ScalarFloat weight_sum = 0.f;
+        for (const auto &emitter : scene->emitters())
+            weight_sum += emitter->sampling_weight();
+
+        if (max_depth > 1 && weight_sum > 0.f) {
+            auto [emitter_idx, emitter_weight, _] =
+                scene->sample_emitter(sampler->next_1d());
+            const Emitter *emitter = scene->emitters()[emitter_idx].get();
+
+            if (is_area_light(emitter)) {
+                auto [ps, pos_weight] =
+                    emitter->sample_position(time, sampler->next_2d());
+
+                Vertex y0;
+                y0.type = Vertex::Type::Light;
+                y0.mode = TransportMode::Importance;
+                y0.si = SurfaceInteraction3f(ps, wavelengths);
+                y0.si.wi = Vector3f(0.f, 0.f, 1.f);
+                y0.emitter = emitter;
+                y0.beta = emitter->eval(y0.si) * pos_weight * emitter_weight;
+                y0.pdf_fwd = light_origin_pdf(y0, weight_sum);
+
+                if (dr::any(unpolarized_spectrum(y0.beta) != 0.f)) {
+                    light_path.push_back(y0);
+
+                    // Cosine-weighted emission, cancels with the cosine of Le
+                    Vector3f local =
+                        warp::square_to_cosine_hemisphere(sampler->next_2d());
+                    Float pdf_dir = warp::square_to_cosine_hemisphere_pdf(local);
+                    Ray3f light_ray = y0.si.spawn_ray(y0.si.to_world(local));
+
+                    random_walk(scene, sampler, light_ray,
+                                y0.beta * dr::Pi<Float>, pdf_dir,
+                                TransportMode::Importance, max_depth,
+                                light_path);
+                }
+            }
+        }
+
+        // 4. Strategies ending on the sensor subpath (splatted at the sampled film position)
+        Spectrum result(0.f);
+
+        for (size_t t = 2; t <= sensor_path.size(); ++t) {
+            const Vertex &pt = sensor_path[t - 1];
+            size_t depth = t - 1;
+
+            // s = 0: the sensor subpath hit an emitter
+            if (pt.emitter && !(depth == 1 && m_hide_emitters))
+                result += pt.beta * connect_emitter_hit(scene, sensor, sensor_path,
+                                                        t, weight_sum);
+
+            // s = 1: emitter sampling
+            if (depth + 1 <= max_depth && pt.connectible())
+                result += connect_emitter_sample(scene, sensor, sampler,
+                                                 sensor_path, t, weight_sum);
+
+            // s >= 2: connect the two subpaths
+            for (size_t s = 2; s <= light_path.size(); ++s) {
+                if (s + t - 1 > max_depth)
+                    break;
+                result += connect_subpaths(scene, sensor, sensor_path,
+                                           light_path, s, t, weight_sum);
+            }
+        }
+
+        // Environment and other infinite emitters seen by the sensor subpath
+        if (sensor_end.escaped && sensor_path.size() <= max_depth &&
+            !(sensor_path.size() == 1 && m_hide_emitters))
+            result += escaped_radiance(scene, sensor_path, sensor_end);
+
+        Point2f film_pos =
+            position_sample * ScalarVector2f(block->size()) + block->offset();
+        Float alpha = sensor_path.size() > 1 ? 1.f : 0.f;
+        block->put(film_pos, wavelengths, result * sample_scale,
+                   alpha * sample_scale, /* weight = */ 0.f);
+
+        // 5. t = 1: connect the light subpath to the sensor
+        for (size_t s = 2; s <= light_path.size(); ++s)
+            connect_sensor(scene, sensor, sampler, block, sensor_path,
+                           light_path, s, weight_sum,
+                           wav_weight * sample_scale);
+    }
+
+    /// Result of a random walk
+    struct WalkEnd {
+        /// Did the walk leave the scene?
+        bool escaped;
+        /// Intersection record of the escaped ray
+        SurfaceInteraction3f si;
+        /// Throughput carried by the escaped ray
+        Spectrum beta;
+    };
+
+    /**
+     * Extends \c path with vertices found by BSDF sampling, starting from
+     * \c ray, until the path has \c max_vertices vertices, leaves the scene
+     * or is terminated by russian roulette.
+     *
+     * \c pdf_dir is the solid angle density of \c ray at the last vertex of
+     * \c path.
+     */
+    WalkEnd random_walk(const Scene *scene, Sampler *sampler, Ray3f ray,
+                        Spectrum beta, Float pdf_dir, TransportMode mode,
+                        size_t max_vertices, std::vector<Vertex> &path) const {
+        WalkEnd end{ false, dr::zeros<SurfaceInteraction3f>(), beta };
+        Float eta = 1.f;
+        BSDFContext ctx(mode);
+
+        while (path.size() < max_vertices) {
+            SurfaceInteraction3f si = scene->ray_intersect(ray, +RayFlags::All);
+            if (!si.is_valid()) {
+                end = { true, si, beta };
+                break;
+            }
+
+            Vertex v;
+            v.mode = mode;
+            v.si = si;
+            v.bsdf = si.bsdf(ray);
+            v.emitter = si.emitter(scene);
+            v.beta = beta;
+            v.pdf_fwd = convert_density(pdf_dir, path.back().si.p, v);
+            path.push_back(v);
+
+            if (path.size() == max_vertices)
+                break;
+
+            Vertex &cur = path[path.size() - 1], &prev = path[path.size() - 2];
+
+            auto [bs, bsdf_weight] = cur.bsdf->sample(
+                ctx, cur.si, sampler->next_1d(), sampler->next_2d());
+            Vector3f wo = cur.si.to_world(bs.wo);
+
+            if (mode == TransportMode::Importance) {
+                // Using geometric normals
+                Float wi_dot_geo_n = dr::dot(cur.si.n, -ray.d),
+                      wo_dot_geo_n = dr::dot(cur.si.n, wo);
+
+                // Prevent light leaks due to shading normals
+                if (wi_dot_geo_n * Frame3f::cos_theta(cur.si.wi) <= 0.f ||
+                    wo_dot_geo_n * Frame3f::cos_theta(bs.wo) <= 0.f)
+                    break;
+
+                // Adjoint BSDF for shading normals -- [Veach, p. 155]
+                bsdf_weight *= dr::abs(
+                    (Frame3f::cos_theta(cur.si.wi) * wo_dot_geo_n) /
+                    (Frame3f::cos_theta(bs.wo) * wi_dot_geo_n));
+            }
+
+            beta *= bsdf_weight;
+            eta *= bs.eta;
+            if (bs.pdf == 0.f || dr::all(unpolarized_spectrum(beta) == 0.f))
+                break;
+
+            cur.delta = has_flag(bs.sampled_type, BSDFFlags::Delta);
+            Float pdf_rev_dir = 0.f;
+            if (cur.delta) {
+                pdf_dir = 0.f;
+            } else {
+                pdf_dir = bs.pdf;
+                // The reverse direction is sampled in the adjoint mode
+                BSDFContext ctx_rev(mode);
+                ctx_rev.reverse();
+                SurfaceInteraction3f si_rev = cur.si;
+                si_rev.wi = bs.wo;
+                pdf_rev_dir = cur.bsdf->pdf(ctx_rev, si_rev, cur.si.wi);
+            }
+            prev.pdf_rev = convert_density(pdf_rev_dir, cur.si.p, prev);
+
+            // Russian roulette
+            if (path.size() > (size_t) m_rr_depth) {
+                Float q = dr::minimum(
+                    dr::max(unpolarized_spectrum(beta)) * dr::square(eta), .95f);
+                if (sampler->next_1d() >= q)
+                    break;
+                beta *= dr::rcp(q);
+            }
+
+            ray = cur.si.spawn_ray(wo);
+        }
+
+        return end;
+    }
+
+    // =============================================================
+    //! @{ \name Connection strategies
+    // =============================================================
+
+    /// s = 0: radiance emitted toward the sensor subpath at its vertex \c t - 1
+    Spectrum connect_emitter_hit(const Scene *scene, const Sensor *sensor,
+                                 const std::vector<Vertex> &sensor_path,
+                                 size_t t, ScalarFloat weight_sum) const {
+        const Vertex &pt = sensor_path[t - 1];
+        Spectrum value = pt.emitter->eval(pt.si);
+        if (dr::all(unpolarized_spectrum(value) == 0.f))
+            return 0.f;
+
+        Float weight = 1.f;
+        if (is_area_light(pt.emitter)) {
+            weight = bdpt_mis_weight(sensor, nullptr, 0, sensor_path, t,
+                                     nullptr, weight_sum);
+        } else if (t > 2 && !sensor_path[t - 2].delta) {
+            // Emitter without light subpaths: two-strategy MIS as in `path`
+            const Vertex &prev = sensor_path[t - 2];
+            DirectionSample3f ds(scene, pt.si, prev.si);
+            Float em_pdf = scene->pdf_emitter_direction(prev.si, ds);
+            weight = mis_weight(bsdf_solid_angle_pdf(prev, pt.si.p), em_pdf);
+        }
+
+        return value * weight;
+    }
+
+    /// s = 1: emitter sampling at vertex \c t - 1 of the sensor subpath
+    Spectrum connect_emitter_sample(const Scene *scene, const Sensor *sensor,
+                                    Sampler *sampler,
+                                    const std::vector<Vertex> &sensor_path,
+                                    size_t t, ScalarFloat weight_sum) const {
+        const Vertex &pt = sensor_path[t - 1];
+
+        auto [ds, em_weight] =
+            scene->sample_emitter_direction(pt.si, sampler->next_2d(), true);
+        if (ds.pdf == 0.f || dr::all(unpolarized_spectrum(em_weight) == 0.f))
+            return 0.f;
+
+        Spectrum value = pt.beta * eval_bsdf(pt, ds.d) * em_weight;
+        if (dr::all(unpolarized_spectrum(value) == 0.f))
+            return 0.f;
+
+        Float weight = 1.f;
+        if (is_area_light(ds.emitter)) {
+            Vertex y0;
+            y0.type = Vertex::Type::Light;
+            y0.mode = TransportMode::Importance;
+            y0.si = SurfaceInteraction3f(ds, pt.si.wavelengths);
+            y0.emitter = ds.emitter;
+            y0.pdf_fwd = light_origin_pdf(y0, weight_sum);
+            weight = bdpt_mis_weight(sensor, nullptr, 1, sensor_path, t,
+                                     &y0, weight_sum);
+        } else if (!ds.delta) {
+            weight = mis_weight(ds.pdf, bsdf_solid_angle_pdf(pt, ds.p));
+        }
+
+        return value * weight;
+    }
+
+    /// s >= 2, t >= 2: deterministic connection of the two subpaths
+    Spectrum connect_subpaths(const Scene *scene, const Sensor *sensor,
+                              const std::vector<Vertex> &sensor_path,
+                              const std::vector<Vertex> &light_path,
+                              size_t s, size_t t, ScalarFloat weight_sum) const {
+        const Vertex &qs = light_path[s - 1], &pt = sensor_path[t - 1];
+        if (!qs.connectible() || !pt.connectible())
+            return 0.f;
+
+        Vector3f d = pt.si.p - qs.si.p;
+        Float dist2 = dr::squared_norm(d);
+        if (dist2 == 0.f)
+            return 0.f;
+        d *= dr::rsqrt(dist2);
+
+        Spectrum value = qs.beta * eval_bsdf(qs, d) * eval_bsdf(pt, -d) *
+                         pt.beta * dr::rcp(dist2);
+        if (dr::all(unpolarized_spectrum(value) == 0.f) ||
+            scene->ray_test(qs.si.spawn_ray_to(pt.si.p)))
+            return 0.f;
+
+        return value * bdpt_mis_weight(sensor, &light_path, s,
+                                       sensor_path, t, nullptr, weight_sum);
+    }
+
+    /// t = 1: connect vertex \c s - 1 of the light subpath to the sensor and splat
+    void connect_sensor(const Scene *scene, const Sensor *sensor,
+                        Sampler *sampler, ImageBlock *block,
+                        const std::vector<Vertex> &sensor_path,
+                        const std::vector<Vertex> &light_path, size_t s,
+                        ScalarFloat weight_sum, const Spectrum &scale) const {
+        const Vertex &qs = light_path[s - 1];
+        if (!qs.connectible())
+            return;
+
+        auto [sensor_ds, sensor_weight] =
+            sensor->sample_direction(qs.si, sampler->next_2d());
+        if (sensor_ds.pdf == 0.f)
+            return;
+
+        Spectrum value = qs.beta * eval_bsdf(qs, sensor_ds.d) * sensor_weight;
+        if (dr::all(unpolarized_spectrum(value) == 0.f) ||
+            scene->ray_test(qs.si.spawn_ray_to(sensor_ds.p)))
+            return;
+
+        value *= bdpt_mis_weight(sensor, &light_path, s, sensor_path, 1,
+                                 nullptr, weight_sum) * scale;
+
+        /* The crop window is already accounted for in the UV positions
+           returned by the sensor, compensate for the block's offset */
+        block->put(sensor_ds.uv + block->offset(), qs.si.wavelengths, value,
+                   /* alpha = */ 0.f, /* weight = */ 0.f);
+    }
+
+    /// Infinite emitters reached by the last ray of the sensor subpath
+    Spectrum escaped_radiance(const Scene *scene,
+                              const std::vector<Vertex> &sensor_path,
+                              const WalkEnd &end) const {
+        EmitterPtr emitter = end.si.emitter(scene);
+        if (!emitter)
+            return 0.f;
+
+        Float weight = 1.f;
+        const Vertex &prev = sensor_path.back();
+        if (sensor_path.size() > 1 && !prev.delta) {
+            DirectionSample3f ds(scene, end.si, prev.si);
+            Float em_pdf = scene->pdf_emitter_direction(prev.si, ds);
+            weight = mis_weight(
+                bsdf_solid_angle_pdf(prev, prev.si.p + ds.d), em_pdf);
+        }
+
+        return end.beta * emitter->eval(end.si) * weight;
+    }
+
+    //! @}
+    // =============================================================
+
+    // =============================================================
+    //! @{ \name Densities and MIS
+    // =============================================================
+
+    /**
+     * Power heuristic weight of the strategy that connects the first \c s
+     * vertices of the light subpath with the first \c t vertices of the
+     * sensor subpath, computed from ratios of the densities of all the other
+     * strategies that could have produced the same path [Veach, Ch. 10].
+     *
+     * When \c s == 1, \c sampled replaces the first light subpath vertex.
+     */
+    Float bdpt_mis_weight(const Sensor *sensor,
+                          const std::vector<Vertex> *light_path, size_t s,
+                          const std::vector<Vertex> &sensor_path, size_t t,
+                          const Vertex *sampled, ScalarFloat weight_sum) const {
+        if (s + t == 2)
+            return 1.f;
+
+        static thread_local std::vector<MISRecord> light_rec, sensor_rec;
+        light_rec.resize(s);
+        sensor_rec.resize(t);
+
+        auto light_vertex = [&](size_t i) -> const Vertex & {
+            return (s == 1 && sampled) ? *sampled : (*light_path)[i];
+        };
+
+        for (size_t i = 0; i < s; ++i) {
+            const Vertex &v = light_vertex(i);
+            light_rec[i] = { v.pdf_fwd, v.pdf_rev, v.delta };
+        }
+        for (size_t i = 0; i < t; ++i) {
+            const Vertex &v = sensor_path[i];
+            sensor_rec[i] = { v.pdf_fwd, v.pdf_rev, v.delta };
+        }
+
+        const Vertex *qs       = s > 0 ? &light_vertex(s - 1) : nullptr,
+                     *qs_minus = s > 1 ? &light_vertex(s - 2) : nullptr,
+                     *pt       = &sensor_path[t - 1],
+                     *pt_minus = t > 1 ? &sensor_path[t - 2] : nullptr;
+
+        // The connection vertices are never sampled from a delta lobe
+        sensor_rec[t - 1].delta = false;
+        if (s > 0)
+            light_rec[s - 1].delta = false;
+
+        // Reverse densities at the connection vertices and their predecessors
+        sensor_rec[t - 1].pdf_rev =
+            s > 0 ? vertex_pdf(sensor, *qs, qs_minus, *pt, false)
+                  : light_origin_pdf(*pt, weight_sum);
+        if (pt_minus)
+            sensor_rec[t - 2].pdf_rev =
+                s > 0 ? vertex_pdf(sensor, *pt, qs, *pt_minus, true)
+                      : light_dir_pdf(*pt, *pt_minus);
+        if (qs)
+            light_rec[s - 1].pdf_rev =
+                vertex_pdf(sensor, *pt, pt_minus, *qs, false);
+        if (qs_minus)
+            light_rec[s - 2].pdf_rev =
+                vertex_pdf(sensor, *qs, pt, *qs_minus, true);
+
+        auto remap0 = [](Float f) { return f != 0.f ? f : 1.f; };
+
+        Float sum_ri = 0.f, ri = 1.f;
+        for (size_t i = t - 1; i > 0; --i) {
+            ri *= remap0(sensor_rec[i].pdf_rev) / remap0(sensor_rec[i].pdf_fwd);
+            if (!sensor_rec[i].delta && !sensor_rec[i - 1].delta)
+                sum_ri += dr::square(ri);
+        }
+
+        ri = 1.f;
+        for (size_t i = s; i-- > 0;) {
+            ri *= remap0(light_rec[i].pdf_rev) / remap0(light_rec[i].pdf_fwd);
+            bool delta_prev = i > 0 && light_rec[i - 1].delta;
+            if (!light_rec[i].delta && !delta_prev)
+                sum_ri += dr::square(ri);
+        }
+
+        return dr::rcp(1.f + sum_ri);
+    }
+
+    /**
+     * Area density of sampling \c next from \c v, whose predecessor is \c
+     * prev. When \c reverse is set, \c prev and \c next run against the
+     * direction of the subpath that contains \c v, and the BSDF density is
+     * evaluated in the adjoint transport mode.
+     */
+    Float vertex_pdf(const Sensor *sensor, const Vertex &v, const Vertex *prev,
+                     const Vertex &next, bool reverse) const {
+        switch (v.type) {
+            case Vertex::Type::Sensor:
+                return sensor_pdf(sensor, next);
+            case Vertex::Type::Light:
+                return light_dir_pdf(v, next);
+            default: {
+                SurfaceInteraction3f si = v.si;
+                si.wi = si.to_local(dr::normalize(prev->si.p - si.p));
+                BSDFContext ctx(v.mode);
+                if (reverse)
+                    ctx.reverse();
+                Float pdf = v.bsdf->pdf(
+                    ctx, si, si.to_local(dr::normalize(next.si.p - si.p)));
+                return convert_density(pdf, si.p, next);
+            }
+        }
+    }
+
+    /**
+     * Area density of the (pinhole) sensor generating \c v as its first
+     * vertex. The importance returned by \ref Sensor::sample_direction()
+     * is the directional density of primary rays over the squared distance.
+     */
+    Float sensor_pdf(const Sensor *sensor, const Vertex &v) const {
+        auto [ds, weight] = sensor->sample_direction(v.si, Point2f(.5f));
+        if (ds.pdf == 0.f)
+            return 0.f;
+        return weight[0] / ds.pdf * dr::abs(dr::dot(v.si.n, ds.d));
+    }
+
+    /// Area density of emission (cosine-weighted) from \c light toward \c next
+    Float light_dir_pdf(const Vertex &light, const Vertex &next) const {
+        Vector3f d = dr::normalize(next.si.p - light.si.p);
+        Float pdf = dr::maximum(dr::dot(light.si.n, d), 0.f) * dr::InvPi<Float>;
+        return convert_density(pdf, light.si.p, next);
+    }
+
+    /// Density (area and emitter selection) of starting a light subpath at \c v
+    Float light_origin_pdf(const Vertex &v, ScalarFloat weight_sum) const {
+        if (!is_area_light(v.emitter))
+            return 0.f;
+        PositionSample3f ps(v.si);
+        return v.emitter->sampling_weight() / weight_sum *
+               v.emitter->shape()->pdf_position(ps);
+    }
+
+    /// Solid angle density of BSDF sampling at \c v toward the point \c p
+    Float bsdf_solid_angle_pdf(const Vertex &v, const Point3f &p) const {
+        if (v.type != Vertex::Type::Surface)
+            return 0.f;
+        BSDFContext ctx(v.mode);
+        return v.bsdf->pdf(ctx, v.si, v.si.to_local(dr::normalize(p - v.si.p)));
+    }
+
+    /// Convert a solid angle density at \c from into an area density at \c to
+    static Float convert_density(Float pdf, const Point3f &from, const Vertex &to) {
+        Vector3f d = to.si.p - from;
+        Float dist2 = dr::squared_norm(d);
+        if (dist2 == 0.f)
+            return 0.f;
+        if (to.on_surface())
+            pdf *= dr::abs(dr::dot(to.si.n, d)) * dr::rsqrt(dist2);
+        return pdf / dist2;
+    }
+
+    /// Can light subpaths start on this emitter?
+    static bool is_area_light(const Emitter *emitter) {
+        return emitter && emitter->shape() &&
+               has_flag(emitter->flags(), EmitterFlags::Surface) &&
+               !has_flag(emitter->flags(), EmitterFlags::Delta);
+    }
+
+    /// Two-strategy power heuristic, as used by the `path` integrator
+    static Float mis_weight(Float pdf_a, Float pdf_b) {
+        pdf_a *= pdf_a;
+        pdf_b *= pdf_b;
+        Float w = pdf_a / (pdf_a + pdf_b);
+        return dr::select(dr::isfinite(w), w, 0.f);
+    }
+
+    //! @}
+    // =============================================================
+
+    /**
+     * BSDF (times cosine) at \c v toward the world space direction \c d. In
+     * importance transport, this includes the adjoint shading normal
+     * correction also used by the `ptracer` integrator.
+     */
+    Spectrum eval_bsdf(const Vertex &v, const Vector3f &d) const {
+        BSDFContext ctx(v.mode);
+        Vector3f wo = v.si.to_local(d);
+        Spectrum value = v.bsdf->eval(ctx, v.si, wo);
+
+        if (v.mode == TransportMode::Importance) {
+            Float wi_dot_geo_n = dr::dot(v.si.n, v.si.to_world(v.si.wi)),
+                  wo_dot_geo_n = dr::dot(v.si.n, d);
+
+            if (wi_dot_geo_n * Frame3f::cos_theta(v.si.wi) <= 0.f ||
+                wo_dot_geo_n * Frame3f::cos_theta(wo) <= 0.f)
+                return 0.f;
+
+            value *= dr::abs((Frame3f::cos_theta(v.si.wi) * wo_dot_geo_n) /
+                             (Frame3f::cos_theta(wo) * wi_dot_geo_n));
+        }
+
+        return value;
+    }
+};
+
+MI_EXPORT_PLUGIN(BidirectionalPathIntegrator)
+NAMESPACE_END(mitsuba)
@@ -1,3 +1,6 @@
+#include <atomic>
+#include <memory>
+
 #include <mitsuba/core/ray.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/render/bsdf.h>
@@ -34,6 +37,31 @@ Path tracer (:monosp:`path`)
    - |bool|
    - Hide directly visible emitters. (Default: no, i.e. |false|)
 
+ * - radiance_cache
+   - |bool|
+   - Terminate paths at diffuse surfaces using a cache of outgoing radiance (see below).
+     (Default: no, i.e. |false|)
+
+ * - cache_query_depth
+   - |int|
+   - Index of the first diffuse vertex along a path (counting from 1) at which the radiance
+     cache is queried. Must be at least 2. (Default: 2)
+
+ * - cache_min_samples
+   - |int|
+   - Number of radiance estimates that a cache cell must have received before it is used.
+     Higher values reduce the bias and the blotchiness of the cache. (Default: 32)
+
+ * - cache_resolution
+   - |int|
+   - Number of cache cells along the largest dimension of the scene's bounding box.
+     (Default: 256)
+
+ * - cache_budget
+   - |float|
+   - Memory budget of the cache in MiB. This determines the size of the hash table storing
+     the cells; collisions become more likely as the budget decreases. (Default: 32)
+
 This integrator implements a basic path tracer and is a **good default choice**
 when there is no strong reason to prefer another method.
 
@@ -66,6 +94,21 @@ relies on multiple importance sampling to combine BSDF and emitter samples. The
 main difference in comparison to the former plugin is that it considers light
 paths of arbitrary length to compute both direct and indirect illumination.
 
+**Radiance cache**: In scenes dominated by diffuse interreflection (e.g. matte interiors),
+most of the rendering time is spent on long chains of diffuse bounces. When
+:paramtype:`radiance_cache` is enabled, the path tracer records an estimate of the outgoing
+radiance at the first diffuse vertex of every path in a world-space hash grid (keyed by
+position and dominant normal direction). At the :paramtype:`cache_query_depth`-th and later
+diffuse vertices, paths are terminated using the average of the cell instead of being traced
+further, once that cell has received :paramtype:`cache_min_samples` estimates. This
+trades a small amount of bias for much shorter paths. The cache is populated by the first
+samples of a rendering and cleared at the start of every call to ``render()``. Paths that
+were cut short by :paramtype:`max_depth` or by a cache lookup are not recorded, since their
+estimates are truncated. The cache is thread-safe in scalar variants. In JIT variants, it
+is updated using atomic scatter-reductions and only becomes effective when the rendering
+is split into several passes using the ``samples_per_pass`` integrator parameter. The
+cache is not available in spectral and polarized variants.
+
 .. note:: This integrator does not handle participating media
 
 .. tabs::
@@ -89,7 +132,70 @@ public:
     MI_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, m_hide_emitters)
     MI_IMPORT_TYPES(Scene, Sampler, Medium, Emitter, EmitterPtr, BSDF, BSDFPtr)
 
-    PathIntegrator(const Properties &props) : Base(props) { }
+    PathIntegrator(const Properties &props) : Base(props) {
+        m_cache = props.get<bool>("radiance_cache", false);
+
+        m_cache_query_depth = props.get<uint32_t>("cache_query_depth", 2);
+        if (m_cache_query_depth < 2)
+            Throw("\"cache_query_depth\" must be set to a value >= 2!");
+
+        m_cache_min_samples = props.get<uint32_t>("cache_min_samples", 32);
+        if (m_cache_min_samples == 0)
+            Throw("\"cache_min_samples\" must be greater than zero!");
+
+        m_cache_resolution = props.get<uint32_t>("cache_resolution", 256);
+        if (m_cache_resolution == 0)
+            Throw("\"cache_resolution\" must be greater than zero!");
+
+        ScalarFloat budget = props.get<ScalarFloat>("cache_budget", 32.f);
+        if (budget <= 0.f)
+            Throw("\"cache_budget\" must be positive!");
+
+        if (m_cache && !CacheSupported) {
+            Log(Warn, "The radiance cache is not supported in spectral and "
+                      "polarized variants, disabling it.");
+            m_cache = false;
+        }
+
+        if constexpr (CacheSupported) {
+            if (m_cache) {
+                // Largest power of two number of cells that fits the budget
+                size_t cell_bytes = (CacheChannels + 1) * sizeof(ScalarFloat),
+                       max_cells = std::max(
+                           (size_t) (budget * 1024.f * 1024.f) / cell_bytes,
+                           (size_t) 1);
+                size_t cell_count = 1;
+                while (cell_count * 2 <= max_cells && cell_count < 0x80000000ull)
+                    cell_count *= 2;
+                m_cache_mask = (uint32_t) (cell_count - 1);
+
+                if constexpr (!dr::is_jit_v<Float>) {
+                    m_cache_sum_scalar.reset(
+                        new std::atomic<ScalarFloat>[cell_count * CacheChannels]);
+                    m_cache_count_scalar.reset(new std::atomic<uint32_t>[cell_count]);
+                }
+
+                reset_cache();
+            }
+        }
+    }
+
+    TensorXf render(Scene *scene,
+                    Sensor *sensor,
+                    UInt32 seed,
+                    uint32_t spp,
+                    bool develop,
+                    bool evaluate) override {
+        /* Cached estimates refer to the scene as it was during a previous
+           render, which may have been updated since */
+        reset_cache();
+        return Base::render(scene, sensor, seed, spp, develop, evaluate);
+    }
+
+    void parameters_changed(const std::vector<std::string> &keys) override {
+        reset_cache();
+        Base::parameters_changed(keys);
+    }
 
     std::pair<Spectrum, Bool> sample(const Scene *scene,
                                      Sampler *sampler,
@@ -111,6 +217,14 @@ public:
         PreliminaryIntersection3f pi  = dr::zeros<PreliminaryIntersection3f>();
         UInt32 depth                  = 0;
 
+        /* Radiance cache: number of diffuse vertices so far, and the cell,
+           partial result and throughput at the first diffuse vertex */
+        UInt32 diffuse_depth          = 0;
+        UInt32 cache_cell             = InvalidCell;
+        Spectrum cache_result         = 0.f;
+        Spectrum cache_throughput     = 0.f;
+        Bool cache_complete           = false;
+
         // If m_hide_emitters == false, the environment emitter will be visible
         Mask valid_ray = !m_hide_emitters && (scene->environment() != nullptr);
 
@@ -133,6 +247,11 @@ public:
             Spectrum result;
             Float eta;
             UInt32 depth;
+            UInt32 diffuse_depth;
+            UInt32 cache_cell;
+            Spectrum cache_result;
+            Spectrum cache_throughput;
+            Bool cache_complete;
             Mask valid_ray;
             Interaction3f prev_si;
             Float prev_bsdf_pdf;
@@ -141,7 +260,8 @@ public:
             Sampler* sampler;
 
             DRJIT_STRUCT(LoopState, ray, pi, throughput, result, eta, depth, \
-                valid_ray, prev_si, prev_bsdf_pdf, prev_bsdf_delta,
+                diffuse_depth, cache_cell, cache_result, cache_throughput,
+                cache_complete, valid_ray, prev_si, prev_bsdf_pdf, prev_bsdf_delta,
                 active, sampler)
         } ls = {
             ray,
@@ -150,6 +270,11 @@ public:
             result,
             eta,
             depth,
+            diffuse_depth,
+            cache_cell,
+            cache_result,
+            cache_throughput,
+            cache_complete,
             valid_ray,
             prev_si,
             prev_bsdf_pdf,
@@ -227,11 +352,45 @@ public:
             if (dr::none_or<false>(active_next)) {
                 ls.active = active_next;
                 ls.valid_ray |= (si.emitter(scene) != nullptr) && !m_hide_emitters;
+                // Paths truncated by 'max_depth' are not recorded in the cache
+                ls.cache_complete = !si.is_valid();
                 return; // early exit for scalar mode
             }
 
             BSDFPtr bsdf = si.bsdf(ls.ray);
 
+            // ---------------------- Radiance cache ----------------------
+
+            if constexpr (CacheSupported) {
+                if (m_cache) {
+                    Mask diffuse = active_next && is_cacheable(bsdf);
+                    dr::masked(ls.diffuse_depth, diffuse) += 1;
+
+                    /* Remember the first diffuse vertex. Its outgoing
+                       radiance is recorded once the path is complete */
+                    UInt32 cell = cache_cell_index(scene, si);
+                    Mask record = diffuse && (ls.diffuse_depth == 1u);
+                    dr::masked(ls.cache_cell, record) = cell;
+                    ls.cache_result[record] = ls.result;
+                    ls.cache_throughput[record] = ls.throughput;
+
+                    // Terminate the path using the cached radiance, if available
+                    Mask query = diffuse && (ls.diffuse_depth >= m_cache_query_depth);
+                    if (dr::any_or<true>(query)) {
+                        auto [cached, found] = cache_lookup(cell, query);
+                        ls.result[found] = spec_fma(ls.throughput, cached, ls.result);
+                        ls.valid_ray |= found;
+                        active_next &= !found;
+
+                        if (dr::none_or<false>(active_next)) {
+                            ls.active = active_next;
+                            ls.cache_complete = false;
+                            return; // early exit for scalar mode
+                        }
+                    }
+                }
+            }
+
             // ---------------------- Emitter sampling ----------------------
 
             // Perform emitter sampling?
@@ -330,6 +489,12 @@ public:
             ls.active = active_next && (!rr_active || rr_continue) &&
                         (throughput_max != 0.f);
 
+            /* Paths ended by 'max_depth' or by a cache lookup carry a
+               truncated or cache-dependent estimate and are not recorded in
+               the radiance cache. Russian roulette reweights the surviving
+               paths, hence paths that it ends still count as complete */
+            ls.cache_complete = !si.is_valid() || active_next;
+
             // Reorder threads based on the shape they hit
             ls.pi = scene->ray_intersect_preliminary(ls.ray,
                                                      /* coherent = */ false,
@@ -339,6 +504,20 @@ public:
                                                      ls.active);
         });
 
+        // Record the outgoing radiance at the first diffuse vertex
+        if constexpr (CacheSupported) {
+            if (m_cache) {
+                Mask record = active && ls.cache_complete &&
+                              (ls.cache_cell != InvalidCell);
+                if (dr::any_or<true>(record)) {
+                    Spectrum radiance = dr::select(
+                        ls.cache_throughput != 0.f,
+                        (ls.result - ls.cache_result) / ls.cache_throughput, 0.f);
+                    cache_record(ls.cache_cell, dr::detach(radiance), record);
+                }
+            }
+        }
+
         return {
             /* spec  = */ dr::select(ls.valid_ray, ls.result, 0.f),
             /* valid = */ ls.valid_ray
@@ -351,10 +530,121 @@ public:
     std::string to_string() const override {
         return tfm::format("PathIntegrator[\n"
             "  max_depth = %u,\n"
-            "  rr_depth = %u\n"
-            "]", m_max_depth, m_rr_depth);
+            "  rr_depth = %u,\n"
+            "  radiance_cache = %s\n"
+            "]", m_max_depth, m_rr_depth, m_cache ? "true" : "false");
+    }
+
+    // =============================================================
+    //! @{ \name Radiance cache
+    // =============================================================
+
+    /// Can the outgoing radiance at a vertex with this BSDF be cached?
+    Mask is_cacheable(const BSDFPtr &bsdf) const {
+        uint32_t non_diffuse = +BSDFFlags::Glossy | +BSDFFlags::Delta |
+                               +BSDFFlags::Null;
+        UInt32 flags = bsdf->flags();
+        return has_flag(flags, BSDFFlags::DiffuseReflection) &&
+               ((flags & non_diffuse) == 0u);
+    }
+
+    /**
+     * \brief Hash table index of the cache cell containing \c si
+     *
+     * Cells are keyed by their position on a uniform grid over the scene's
+     * bounding box and by the dominant axis of the (front-facing) shading
+     * normal, which separates the two sides of thin surfaces.
+     */
+    UInt32 cache_cell_index(const Scene *scene,
+                            const SurfaceInteraction3f &si) const {
+        ScalarBoundingBox3f bbox = scene->bbox();
+        ScalarFloat scale =
+            m_cache_resolution / dr::maximum(dr::max(bbox.extents()), (ScalarFloat) 1e-6f);
+        Vector3i c = Vector3i(dr::floor((si.p - bbox.min) * scale));
+
+        Vector3f n = dr::mulsign(si.sh_frame.n, Frame3f::cos_theta(si.wi));
+        Vector3f a = dr::abs(n);
+        Mask x_axis = (a.x() >= a.y()) && (a.x() >= a.z()),
+             y_axis = !x_axis && (a.y() >= a.z());
+        Float n_dom = dr::select(x_axis, n.x(), dr::select(y_axis, n.y(), n.z()));
+        UInt32 dir = dr::select(x_axis, 0u, dr::select(y_axis, 2u, 4u)) +
+                     dr::select(n_dom < 0.f, 1u, 0u);
+
+        UInt32 hash = (UInt32(c.x()) * 73856093u) ^ (UInt32(c.y()) * 19349663u) ^
+                      (UInt32(c.z()) * 83492791u) ^ (dir * 2654435761u);
+        return hash & m_cache_mask;
     }
 
+    /// Discard all cached radiance estimates
+    void reset_cache() {
+        if constexpr (CacheSupported) {
+            if (!m_cache)
+                return;
+            size_t cell_count = (size_t) m_cache_mask + 1;
+            if constexpr (dr::is_jit_v<Float>) {
+                m_cache_sum = dr::zeros<Float>(cell_count * CacheChannels);
+                m_cache_count = dr::zeros<Float>(cell_count);
+            } else {
+                for (size_t i = 0; i < cell_count * CacheChannels; ++i)
+                    m_cache_sum_scalar[i].store(0.f, std::memory_order_relaxed);
+                for (size_t i = 0; i < cell_count; ++i)
+                    m_cache_count_scalar[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Average radiance of a cache cell, if it received enough estimates
+    std::pair<Spectrum, Mask> cache_lookup(const UInt32 &cell, Mask active) const {
+        Spectrum value = 0.f;
+        if constexpr (dr::is_jit_v<Float>) {
+            Float count = dr::gather<Float>(m_cache_count, cell, active);
+            active &= count >= (ScalarFloat) m_cache_min_samples;
+            for (size_t ch = 0; ch < CacheChannels; ++ch)
+                value[ch] = dr::gather<Float>(
+                    m_cache_sum, cell * (uint32_t) CacheChannels + (uint32_t) ch,
+                    active) / count;
+        } else {
+            if (!active)
+                return { value, false };
+            uint32_t count =
+                m_cache_count_scalar[cell].load(std::memory_order_relaxed);
+            if (count < m_cache_min_samples)
+                return { value, false };
+            for (size_t ch = 0; ch < CacheChannels; ++ch)
+                value[ch] = m_cache_sum_scalar[cell * CacheChannels + ch].load(
+                                std::memory_order_relaxed) / (ScalarFloat) count;
+        }
+        return { value, active };
+    }
+
+    /// Add a radiance estimate to a cache cell
+    void cache_record(const UInt32 &cell, const Spectrum &value, Mask active) const {
+        active &= dr::all(dr::isfinite(value));
+        if constexpr (dr::is_jit_v<Float>) {
+            for (size_t ch = 0; ch < CacheChannels; ++ch)
+                dr::scatter_reduce(ReduceOp::Add, m_cache_sum, value[ch],
+                                   cell * (uint32_t) CacheChannels + (uint32_t) ch,
+                                   active);
+            dr::scatter_reduce(ReduceOp::Add, m_cache_count, Float(1.f), cell,
+                               active);
+        } else {
+            if (!active)
+                return;
+            for (size_t ch = 0; ch < CacheChannels; ++ch) {
+                std::atomic<ScalarFloat> &sum =
+                    m_cache_sum_scalar[cell * CacheChannels + ch];
+                ScalarFloat cur = sum.load(std::memory_order_relaxed);
+                while (!sum.compare_exchange_weak(cur, cur + value[ch],
+                                                  std::memory_order_relaxed))
+                    ;
+            }
+            m_cache_count_scalar[cell].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    //! @}
+    // =============================================================
+
     /// Compute a multiple importance sampling weight using the power heuristic
     Float mis_weight(Float pdf_a, Float pdf_b) const {
         pdf_a *= pdf_a;
@@ -376,6 +666,24 @@ public:
     }
 
     MI_DECLARE_CLASS(PathIntegrator)
+
+protected:
+    static constexpr bool CacheSupported =
+        !is_spectral_v<Spectrum> && !is_polarized_v<Spectrum>;
+    static constexpr size_t CacheChannels = dr::size_v<UnpolarizedSpectrum>;
+    static constexpr uint32_t InvalidCell = (uint32_t) -1;
+
+    bool m_cache;
+    uint32_t m_cache_query_depth;
+    uint32_t m_cache_min_samples;
+    uint32_t m_cache_resolution;
+    uint32_t m_cache_mask = 0;
+
+    /// Per cell: sum of the recorded radiance estimates, and their count
+    mutable Float m_cache_sum;
+    mutable Float m_cache_count;
+    std::unique_ptr<std::atomic<ScalarFloat>[]> m_cache_sum_scalar;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_cache_count_scalar;
 };
 
 MI_EXPORT_PLUGIN(PathIntegrator)
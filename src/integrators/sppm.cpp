@@ -0,0 +1,683 @@
+#include <atomic>
+#include <mutex>
+
+#include <mitsuba/core/math.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/progress.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/ray.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/records.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/sensor.h>
+#include <nanothread/nanothread.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _integrator-sppm:
+
+Stochastic progressive photon mapping (:monosp:`sppm`)
+------------------------------------------------------
+
+.. pluginparameters::
+
+ * - max_depth
+   - |int|
+   - Specifies the longest path depth in the generated output image (where -1 corresponds to
+     :math:`\infty`). A value of 1 will only render directly visible light sources. 2 will lead
+     to single-bounce (direct-only) illumination, and so on. (Default: -1)
+
+ * - rr_depth
+   - |int|
+   - Specifies the minimum path depth, after which the implementation will start to use the
+     *russian roulette* path termination criterion. (Default: 5)
+
+ * - photon_count
+   - |int|
+   - Number of photons emitted per iteration. (Default: 250000)
+
+ * - initial_radius
+   - |float|
+   - Initial gather radius in world space units. A value of zero selects a radius of
+     :math:`5\cdot 10^{-3}` times the diagonal of the scene's bounding box. (Default: 0)
+
+ * - alpha
+   - |float|
+   - Radius reduction parameter, which controls how quickly the gather radius shrinks
+     between iterations. Must be in :math:`(0, 1)`. (Default: 0.7)
+
+ * - hide_emitters
+   - |bool|
+   - Hide directly visible emitters. (Default: no, i.e. |false|)
+
+This integrator implements stochastic progressive photon mapping [HJ09]_. Each iteration
+traces one path per pixel from the sensor through specular (delta) surfaces up to a
+smooth surface, the *visible point*, where direct illumination is computed using emitter
+sampling. On surfaces that combine smooth and delta lobes (e.g. :ref:`plastic <bsdf-plastic>`),
+the path randomly either stops there or continues through the delta lobes, and both
+choices are reweighted by their probability. Each iteration then traces
+:paramtype:`photon_count` photons from the emitters, stores them in a hashed grid, and
+gathers the photons within the current radius of each visible point. The radii shrink from one iteration to the next, which makes the estimate consistent.
+
+The number of iterations is given by the sample count of the sensor's sampler, and both the
+photon tracing and the gathering steps run in parallel. The technique excels at caustics
+seen directly or through specular surfaces (e.g. light focused by glass onto a diffuse
+receiver), which converge very slowly with the :ref:`path <integrator-path>` integrator.
+
+This integrator does not support media (volumes), and it is only available in scalar,
+unpolarized RGB and monochromatic variants.
+
+.. tabs::
+    .. code-tab::  xml
+
+        <integrator type="sppm">
+            <integer name="photon_count" value="1000000"/>
+        </integrator>
+
+    .. code-tab:: python
+
+        'type': 'sppm',
+        'photon_count': 1000000
+
+ */
+
+template <typename Float, typename Spectrum>
+class SPPMIntegrator final : public Integrator<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Integrator, should_stop, m_stop, m_timeout, m_render_timer,
+                    m_hide_emitters)
+    MI_IMPORT_TYPES(Scene, Sensor, Film, Sampler, ImageBlock, Emitter,
+                     EmitterPtr, BSDF, BSDFPtr)
+
+    SPPMIntegrator(const Properties &props) : Base(props) {
+        if constexpr (dr::is_jit_v<Float> || is_polarized_v<Spectrum> ||
+                      is_spectral_v<Spectrum>)
+            Throw("The photon mapper (\"sppm\") is only supported in scalar, "
+                  "unpolarized RGB and monochromatic variants!");
+
+        m_max_depth = props.get<int>("max_depth", -1);
+        if (m_max_depth < 0 && m_max_depth != -1)
+            Throw("\"max_depth\" must be set to -1 (infinite) or a value >= 0");
+
+        m_rr_depth = props.get<int>("rr_depth", 5);
+        if (m_rr_depth <= 0)
+            Throw("\"rr_depth\" must be set to a value greater than zero!");
+
+        m_photon_count = props.get<uint32_t>("photon_count", 250000);
+        if (m_photon_count == 0)
+            Throw("\"photon_count\" must be greater than zero!");
+
+        m_initial_radius = props.get<ScalarFloat>("initial_radius", 0.f);
+        if (m_initial_radius < 0.f)
+            Throw("\"initial_radius\" must be >= 0!");
+
+        m_alpha = props.get<ScalarFloat>("alpha", .7f);
+        if (m_alpha <= 0.f || m_alpha >= 1.f)
+            Throw("\"alpha\" must be in the range (0, 1)!");
+    }
+
+    TensorXf render(Scene *scene, Sensor *sensor, UInt32 seed, uint32_t spp,
+                    bool develop, bool evaluate) override {
+        DRJIT_MARK_USED(evaluate);
+        ScopedPhase sp(ProfilerPhase::Render);
+        m_stop = false;
+
+        Film *film = sensor->film();
+        size_t channel_count = film->prepare({});
+
+        if constexpr (!dr::is_jit_v<Float> && !is_polarized_v<Spectrum> &&
+                      !is_spectral_v<Spectrum>) {
+            Sampler *sampler = sensor->sampler();
+            if (spp)
+                sampler->set_sample_count(spp);
+            spp = sampler->sample_count();
+
+            if (unlikely(scene->emitters().empty()))
+                Log(Info, "Rendering finished (no emitters found, returning black image).");
+            else
+                render_scalar(scene, sensor, seed, spp, channel_count);
+        } else {
+            DRJIT_MARK_USED(scene);
+            DRJIT_MARK_USED(seed);
+            DRJIT_MARK_USED(spp);
+            DRJIT_MARK_USED(channel_count);
+        }
+
+        TensorXf result;
+        if (develop)
+            result = film->develop();
+        return result;
+    }
+
+    std::string to_string() const override {
+        return tfm::format("SPPMIntegrator[\n"
+                           "  max_depth = %i,\n"
+                           "  rr_depth = %i,\n"
+                           "  photon_count = %u,\n"
+                           "  initial_radius = %f,\n"
+                           "  alpha = %f\n"
+                           "]",
+                           m_max_depth, m_rr_depth, m_photon_count,
+                           m_initial_radius, m_alpha);
+    }
+
+    MI_DECLARE_CLASS(SPPMIntegrator)
+
+protected:
+    /// Per-pixel state, carried across iterations
+    struct PixelState {
+        /// Vertex where the current sensor path ended on a smooth lobe
+        SurfaceInteraction3f si;
+        BSDFPtr bsdf = nullptr;
+        /// Throughput of the sensor path up to the visible point
+        Spectrum beta;
+        /// Number of path segments up to the visible point (0: none)
+        uint32_t depth = 0;
+
+        /// Current gather radius and accumulated photon count
+        Float radius, n = 0.f;
+        /// Accumulated (radius-scaled) photon flux
+        Spectrum tau = 0.f;
+        /// Accumulated emission and direct illumination
+        Spectrum direct = 0.f;
+        Float alpha = 0.f;
+    };
+
+    struct Photon {
+        Point3f p;
+        /// World space direction toward the previous vertex of the light path
+        Vector3f wi;
+        Spectrum power;
+        /// Number of path segments from the emitter
+        uint32_t depth;
+    };
+
+    /**
+     * Photons of one iteration, sorted by the hash of their grid cell
+     * (counting sort). The photons of bucket \c h are stored in the range
+     * <tt>[cell_start[h], cell_start[h + 1])</tt>.
+     */
+    struct PhotonGrid {
+        std::vector<Photon> photons;
+        std::vector<uint32_t> cell_start;
+        ScalarFloat cell_size = 0.f;
+        uint32_t table_mask = 0;
+
+        Point3i cell(const Point3f &p) const {
+            return Point3i(dr::floor(p / cell_size));
+        }
+
+        uint32_t hash(const Point3i &c) const {
+            return ((uint32_t) c.x() * 73856093u ^
+                    (uint32_t) c.y() * 19349663u ^
+                    (uint32_t) c.z() * 83492791u) & table_mask;
+        }
+    };
+
+    void render_scalar(const Scene *scene, Sensor *sensor, uint32_t seed,
+                       uint32_t n_iterations, size_t channel_count) {
+        Film *film = sensor->film();
+        ScalarVector2u crop_size = film->crop_size();
+        size_t n_pixels = dr::prod(crop_size),
+               n_threads = pool_size() + 1;
+
+        ScalarFloat initial_radius = m_initial_radius;
+        if (initial_radius == 0.f)
+            initial_radius = 5e-3f * dr::norm(scene->bbox().extents());
+
+        Log(Info, "Starting render job (%ux%u, %u iteration%s, %u photons "
+                  "per iteration, %u thread%s)",
+            crop_size.x(), crop_size.y(), n_iterations,
+            n_iterations == 1 ? "" : "s", m_photon_count, n_threads,
+            n_threads == 1 ? "" : "s");
+
+        if (m_timeout > 0.f)
+            Log(Info, "Timeout specified: %.2f seconds.", m_timeout);
+
+        std::vector<PixelState> pixels(n_pixels);
+        for (PixelState &ps : pixels)
+            ps.radius = initial_radius;
+
+        size_t pixel_grain = std::max(n_pixels / (4 * n_threads), (size_t) 1),
+               photon_grain = std::max((size_t) m_photon_count / (4 * n_threads),
+                                       (size_t) 1),
+               pixel_ranges = (n_pixels + pixel_grain - 1) / pixel_grain,
+               photon_ranges = ((size_t) m_photon_count + photon_grain - 1) / photon_grain;
+
+        // Every sampler clone is seeded with a distinct value
+        uint32_t seed_stride = (uint32_t) (pixel_ranges + photon_ranges);
+        seed *= seed_stride * n_iterations;
+
+        ref<ProgressReporter> progress = new ProgressReporter("Rendering");
+        m_render_timer.reset();
+
+        PhotonGrid grid;
+        uint32_t iteration = 0;
+        for (; iteration < n_iterations && !should_stop(); ++iteration) {
+            uint32_t iteration_seed = seed + iteration * seed_stride;
+
+            // 1. Trace one sensor path per pixel up to its visible point
+            dr::parallel_for(
+                dr::blocked_range<size_t>(0, n_pixels, pixel_grain),
+                [&](const dr::blocked_range<size_t> &range) {
+                    ref<Sampler> sampler = sensor->sampler()->clone();
+                    sampler->seed(iteration_seed +
+                                  (uint32_t) (range.begin() / pixel_grain));
+                    for (size_t i = range.begin(); i != range.end(); ++i) {
+                        ScalarPoint2u pixel((uint32_t) (i % crop_size.x()),
+                                            (uint32_t) (i / crop_size.x()));
+                        trace_sensor_path(scene, sensor, sampler, pixel,
+                                          pixels[i]);
+                        sampler->advance();
+                    }
+                }
+            );
+
+            // 2. Trace photons and sort them into the hashed grid
+            ScalarFloat max_radius = 0.f;
+            for (const PixelState &ps : pixels)
+                if (ps.depth > 0)
+                    max_radius = dr::maximum(max_radius, ps.radius);
+
+            if (max_radius > 0.f) {
+                trace_photons(scene, sensor, iteration_seed +
+                              (uint32_t) pixel_ranges, photon_grain, grid);
+                build_grid(grid, max_radius);
+
+                // 3. Gather photons at the visible points and shrink the radii
+                dr::parallel_for(
+                    dr::blocked_range<size_t>(0, n_pixels, pixel_grain),
+                    [&](const dr::blocked_range<size_t> &range) {
+                        for (size_t i = range.begin(); i != range.end(); ++i)
+                            gather(grid, pixels[i]);
+                    }
+                );
+            }
+
+            progress->update((iteration + 1) / (ScalarFloat) n_iterations);
+        }
+
+        if (iteration < n_iterations)
+            Log(Info, "Rendering stopped after %u of %u iterations.",
+                iteration, n_iterations);
+
+        // 4. Write the estimates to the film (one value per pixel, no filter)
+        if (iteration == 0)
+            return;
+
+        ref<ImageBlock> block = new ImageBlock(
+            crop_size, film->crop_offset(), (uint32_t) channel_count,
+            nullptr /* box filter */, false /* border */);
+        block->clear();
+
+        ScalarFloat photon_scale =
+            1.f / ((ScalarFloat) iteration * m_photon_count * dr::Pi<ScalarFloat>),
+            iteration_scale = 1.f / (ScalarFloat) iteration;
+
+        Wavelength wavelengths = dr::zeros<Wavelength>();
+        for (size_t i = 0; i < n_pixels; ++i) {
+            const PixelState &ps = pixels[i];
+            Spectrum value = ps.direct * iteration_scale;
+            if (ps.radius > 0.f)
+                value += ps.tau * photon_scale * dr::rcp(dr::square(ps.radius));
+
+            Point2f pos(Float(i % crop_size.x()) + .5f,
+                        Float(i / crop_size.x()) + .5f);
+            block->put(pos + block->offset(), wavelengths, value,
+                       ps.alpha * iteration_scale, 1.f);
+        }
+
+        film->put_block(block);
+    }
+
+    /**
+     * Traces a sensor path through \c pixel, accumulating emission and direct
+     * illumination, and records the vertex where it ends on a smooth lobe.
+     */
+    void trace_sensor_path(const Scene *scene, const Sensor *sensor,
+                           Sampler *sampler, const ScalarPoint2u &pixel,
+                           PixelState &ps) const {
+        ps.depth = 0;
+
+        Float time = sensor->shutter_open();
+        if (sensor->shutter_open_time() > 0)
+            time += sampler->next_1d() * sensor->shutter_open_time();
+
+        Float wavelength_sample = sampler->next_1d();
+        Point2f position_sample =
+            (Point2f(pixel) + sampler->next_2d()) /
+            ScalarVector2f(sensor->film()->crop_size());
+        Point2f aperture_sample(.5f);
+        if (sensor->needs_aperture_sample())
+            aperture_sample = sampler->next_2d();
+
+        auto [ray, beta] = sensor->sample_ray(time, wavelength_sample,
+                                              position_sample, aperture_sample);
+
+        BSDFContext ctx;
+        Float eta = 1.f;
+
+        for (uint32_t depth = 1;; ++depth) {
+            if (m_max_depth >= 0 && depth > (uint32_t) m_max_depth)
+                break;
+
+            SurfaceInteraction3f si = scene->ray_intersect(ray, +RayFlags::All);
+            bool visible = !(depth == 1 && m_hide_emitters);
+
+            if (!si.is_valid()) {
+                EmitterPtr env = si.emitter(scene);
+                if (env && visible)
+                    ps.direct += beta * env->eval(si);
+                break;
+            }
+
+            if (depth == 1)
+                ps.alpha += 1.f;
+
+            EmitterPtr emitter = si.emitter(scene);
+            if (emitter && visible)
+                ps.direct += beta * emitter->eval(si);
+
+            BSDFPtr bsdf = si.bsdf(ray);
+            uint32_t flags = bsdf->flags();
+            bool has_smooth = has_flag(flags, BSDFFlags::Smooth),
+                 has_delta  = has_flag(flags, BSDFFlags::Delta);
+
+            if (has_smooth) {
+                // Direct illumination via emitter sampling
+                if (m_max_depth < 0 || depth + 1 <= (uint32_t) m_max_depth) {
+                    auto [ds, em_weight] = scene->sample_emitter_direction(
+                        si, sampler->next_2d(), true);
+                    if (ds.pdf != 0.f)
+                        ps.direct += beta * em_weight *
+                                     bsdf->eval(ctx, si, si.to_local(ds.d));
+                }
+
+                ps.si = si;
+                ps.bsdf = bsdf;
+                ps.beta = beta;
+                ps.depth = depth;
+
+                if (!has_delta)
+                    break;
+            }
+
+            /* Sample the delta lobes only. For BSDFs that mix smooth and
+               delta lobes (e.g. plastic), the visible point above accounts
+               for the smooth lobes, and the path continues through the
+               delta lobes instead with probability 'q_delta' */
+            BSDFContext ctx_delta(TransportMode::Radiance, +BSDFFlags::Delta);
+            auto [bs, bsdf_weight] = bsdf->sample(
+                ctx_delta, si, sampler->next_1d(), sampler->next_2d());
+
+            if (has_smooth) {
+                if (bs.pdf == 0.f ||
+                    dr::all(unpolarized_spectrum(bsdf_weight) == 0.f))
+                    break;
+
+                Float q_delta = dr::clip(
+                    dr::max(unpolarized_spectrum(bsdf_weight)), .1f, .9f);
+                if (sampler->next_1d() >= q_delta) {
+                    ps.beta *= dr::rcp(1.f - q_delta);
+                    break;
+                }
+
+                // Only one visible point per iteration
+                ps.depth = 0;
+                bsdf_weight *= dr::rcp(q_delta);
+            }
+
+            beta *= bsdf_weight;
+            eta *= bs.eta;
+            if (bs.pdf == 0.f || dr::all(unpolarized_spectrum(beta) == 0.f))
+                break;
+
+            if (depth > (uint32_t) m_rr_depth) {
+                Float q = dr::minimum(
+                    dr::max(unpolarized_spectrum(beta)) * dr::square(eta), .95f);
+                if (sampler->next_1d() >= q)
+                    break;
+                beta *= dr::rcp(q);
+            }
+
+            ray = si.spawn_ray(si.to_world(bs.wo));
+        }
+    }
+
+    /// Emits \ref m_photon_count photons in parallel and stores them in \c grid
+    void trace_photons(const Scene *scene, const Sensor *sensor, uint32_t seed,
+                       size_t grain_size, PhotonGrid &grid) const {
+        std::mutex mutex;
+        std::vector<std::vector<Photon>> chunks;
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, m_photon_count, grain_size),
+            [&](const dr::blocked_range<size_t> &range) {
+                ref<Sampler> sampler = sensor->sampler()->clone();
+                sampler->seed(seed + (uint32_t) (range.begin() / grain_size));
+
+                std::vector<Photon> photons;
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    trace_photon(scene, sensor, sampler, photons);
+                    sampler->advance();
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                chunks.push_back(std::move(photons));
+            }
+        );
+
+        size_t photon_count = 0;
+        for (const auto &chunk : chunks)
+            photon_count += chunk.size();
+
+        grid.photons.resize(photon_count);
+        size_t offset = 0;
+        for (auto &chunk : chunks) {
+            std::copy(chunk.begin(), chunk.end(), grid.photons.begin() + offset);
+            offset += chunk.size();
+        }
+    }
+
+    /// Traces a single photon, recording its indirect interactions
+    void trace_photon(const Scene *scene, const Sensor *sensor, Sampler *sampler,
+                      std::vector<Photon> &photons) const {
+        Float time = sensor->shutter_open();
+        if (sensor->shutter_open_time() > 0)
+            time += sampler->next_1d() * sensor->shutter_open_time();
+
+        Float wavelength_sample = sampler->next_1d();
+        Point2f direction_sample = sampler->next_2d(),
+                position_sample  = sampler->next_2d();
+
+        auto [ray, beta, emitter] = scene->sample_emitter_ray(
+            time, wavelength_sample, direction_sample, position_sample);
+        DRJIT_MARK_USED(emitter);
+
+        if (dr::all(unpolarized_spectrum(beta) == 0.f))
+            return;
+
+        BSDFContext ctx(TransportMode::Importance);
+        Float eta = 1.f;
+
+        for (uint32_t depth = 1;; ++depth) {
+            /* Photons are only gathered at visible points, which are at
+               least one segment away from the sensor */
+            if (m_max_depth >= 0 && depth >= (uint32_t) m_max_depth)
+                break;
+
+            SurfaceInteraction3f si = scene->ray_intersect(ray, +RayFlags::All);
+            if (!si.is_valid())
+                break;
+
+            BSDFPtr bsdf = si.bsdf(ray);
+
+            // Direct illumination is handled by emitter sampling
+            if (depth > 1 && has_flag(bsdf->flags(), BSDFFlags::Smooth))
+                photons.push_back({ si.p, -ray.d, beta, depth });
+
+            auto [bs, bsdf_weight] =
+                bsdf->sample(ctx, si, sampler->next_1d(), sampler->next_2d());
+
+            // Using geometric normals
+            Vector3f wo = si.to_world(bs.wo);
+            Float wi_dot_geo_n = dr::dot(si.n, -ray.d),
+                  wo_dot_geo_n = dr::dot(si.n, wo);
+
+            // Prevent light leaks due to shading normals
+            if (wi_dot_geo_n * Frame3f::cos_theta(si.wi) <= 0.f ||
+                wo_dot_geo_n * Frame3f::cos_theta(bs.wo) <= 0.f)
+                break;
+
+            // Adjoint BSDF for shading normals -- [Veach, p. 155]
+            beta *= bsdf_weight *
+                    dr::abs((Frame3f::cos_theta(si.wi) * wo_dot_geo_n) /
+                            (Frame3f::cos_theta(bs.wo) * wi_dot_geo_n));
+            eta *= bs.eta;
+            if (bs.pdf == 0.f || dr::all(unpolarized_spectrum(beta) == 0.f))
+                break;
+
+            if (depth > (uint32_t) m_rr_depth) {
+                Float q = dr::minimum(
+                    dr::max(unpolarized_spectrum(beta)) * dr::square(eta), .95f);
+                if (sampler->next_1d() >= q)
+                    break;
+                beta *= dr::rcp(q);
+            }
+
+            ray = si.spawn_ray(wo);
+        }
+    }
+
+    /**
+     * Sorts the photons of \c grid by the hash of their grid cell. Cells are
+     * as large as the largest gather radius, hence a gather query visits at
+     * most 2x2x2 cells.
+     */
+    void build_grid(PhotonGrid &grid, ScalarFloat cell_size) const {
+        size_t photon_count = grid.photons.size();
+        uint32_t table_size =
+            math::round_to_power_of_two((uint32_t) std::max(photon_count, (size_t) 1));
+
+        grid.cell_size = cell_size;
+        grid.table_mask = table_size - 1;
+
+        std::unique_ptr<std::atomic<uint32_t>[]> counts(
+            new std::atomic<uint32_t>[table_size]);
+        for (uint32_t i = 0; i < table_size; ++i)
+            counts[i].store(0, std::memory_order_relaxed);
+
+        size_t grain_size =
+            std::max(photon_count / (4 * (pool_size() + 1)), (size_t) 1);
+
+        std::vector<uint32_t> keys(photon_count);
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, photon_count, grain_size),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    keys[i] = grid.hash(grid.cell(grid.photons[i].p));
+                    counts[keys[i]].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        );
+
+        // Exclusive prefix sum, 'counts' then serves as per-bucket cursor
+        grid.cell_start.resize((size_t) table_size + 1);
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < table_size; ++i) {
+            grid.cell_start[i] = sum;
+            sum += counts[i].load(std::memory_order_relaxed);
+            counts[i].store(grid.cell_start[i], std::memory_order_relaxed);
+        }
+        grid.cell_start[table_size] = sum;
+
+        std::vector<Photon> sorted(photon_count);
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, photon_count, grain_size),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i)
+                    sorted[counts[keys[i]].fetch_add(
+                        1, std::memory_order_relaxed)] = grid.photons[i];
+            }
+        );
+
+        grid.photons.swap(sorted);
+    }
+
+    /// Gathers the photons around a visible point and updates its statistics
+    void gather(const PhotonGrid &grid, PixelState &ps) const {
+        if (ps.depth == 0)
+            return;
+
+        Float radius = ps.radius, radius2 = dr::square(radius);
+        Point3i lo = grid.cell(ps.si.p - radius),
+                hi = grid.cell(ps.si.p + radius);
+
+        BSDFContext ctx;
+        Spectrum phi = 0.f;
+        uint32_t m = 0;
+
+        for (int z = lo.z(); z <= hi.z(); ++z) {
+            for (int y = lo.y(); y <= hi.y(); ++y) {
+                for (int x = lo.x(); x <= hi.x(); ++x) {
+                    Point3i c(x, y, z);
+                    uint32_t h = grid.hash(c);
+
+                    for (uint32_t j = grid.cell_start[h];
+                         j < grid.cell_start[h + 1]; ++j) {
+                        const Photon &photon = grid.photons[j];
+
+                        if (dr::squared_norm(photon.p - ps.si.p) > radius2)
+                            continue;
+
+                        // Several cells may hash to the same bucket
+                        if (dr::any(grid.cell(photon.p) != c))
+                            continue;
+
+                        if (m_max_depth >= 0 &&
+                            ps.depth + photon.depth > (uint32_t) m_max_depth)
+                            continue;
+
+                        /* The BSDF value includes the foreshortening
+                           factor, which photon density estimation omits */
+                        Vector3f wo = ps.si.to_local(photon.wi);
+                        Float cos_theta = dr::abs(Frame3f::cos_theta(wo));
+                        if (cos_theta == 0.f)
+                            continue;
+
+                        phi += photon.power *
+                               ps.bsdf->eval(ctx, ps.si, wo) / cos_theta;
+                        m++;
+                    }
+                }
+            }
+        }
+
+        if (m == 0)
+            return;
+
+        // Progressive radius reduction [Hachisuka and Jensen 2009]
+        Float n_new = ps.n + m_alpha * m,
+              radius_new = radius * dr::sqrt(n_new / (ps.n + m));
+
+        ps.tau = (ps.tau + ps.beta * phi) * dr::square(radius_new / radius);
+        ps.n = n_new;
+        ps.radius = radius_new;
+    }
+
+protected:
+    int m_max_depth;
+    int m_rr_depth;
+    uint32_t m_photon_count;
+    ScalarFloat m_initial_radius;
+    ScalarFloat m_alpha;
+};
+
+MI_EXPORT_PLUGIN(SPPMIntegrator)
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,97 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def create_test_scene(integrator, max_depth=4, hide_emitters=False):
+    return mi.load_dict({
+        'type': 'scene',
+        'integrator': {
+            'type': integrator,
+            'max_depth': max_depth,
+            'hide_emitters': hide_emitters,
+        },
+        'sensor': {
+            'type': 'perspective',
+            'to_world': mi.ScalarTransform4f().look_at(
+                origin=(2, 0, 0),
+                target=(0, 0, 0),
+                up=(0, 1, 0),
+            ),
+            'sampler': {
+                'type': 'independent'
+            },
+            'film': {
+                'type': 'hdrfilm',
+                'width': 8, 'height': 8,
+                'rfilter': {'type': 'box'}
+            },
+        },
+        'receiver': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f().look_at(
+                origin=(0, 0, 0),
+                target=(1, 0, 0),
+                up=(0, 1, 0),
+            ),
+            'bsdf': {'type': 'diffuse'},
+        },
+        'light': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f().look_at(
+                origin=(1, 1.5, 0),
+                target=(1, 0, 0),
+                up=(1, 0, 0),
+            ) @ mi.ScalarTransform4f().scale(0.5),
+            'emitter': {
+                'type': 'area',
+                'radiance': {'type': 'rgb', 'value': (4.0, 2.0, 1.0)},
+            },
+        },
+    })
+
+
+def test01_create(variant_scalar_rgb):
+    scene = create_test_scene('bdpt')
+    integrator = scene.integrator()
+    assert isinstance(integrator, mi.AdjointIntegrator)
+
+
+def test02_unsupported_variant(variants_vec_backends_once_rgb):
+    with pytest.raises(RuntimeError, match='scalar'):
+        mi.load_dict({'type': 'bdpt'})
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('max_depth', [2, 4])
+def test03_matches_path(variant_scalar_rgb, max_depth):
+    # Both integrators estimate the same image, compare the average radiance
+    means = []
+    for name in ['bdpt', 'path']:
+        scene = create_test_scene(name, max_depth=max_depth)
+        image = mi.render(scene, spp=256, seed=0)
+        means.append(dr.mean(dr.ravel(image)))
+
+    assert means[0] > 0
+    assert dr.allclose(means[0], means[1], rtol=5e-2)
+
+
+def test04_hide_emitters(variant_scalar_rgb):
+    scene = create_test_scene('bdpt', max_depth=1, hide_emitters=True)
+    image = mi.render(scene, spp=4, seed=0)
+    assert dr.all(dr.ravel(image) == 0)
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('max_depth', [2, 4])
+def test05_matches_path_per_pixel(variant_scalar_rgb, max_depth):
+    # The sensor subpaths are stratified over the pixels, hence every pixel
+    # must converge to the reference, not only the image average
+    images = []
+    for name in ['bdpt', 'path']:
+        scene = create_test_scene(name, max_depth=max_depth)
+        images.append(mi.TensorXf(mi.render(scene, spp=1024, seed=0)))
+
+    mean = dr.mean(dr.ravel(images[1]))
+    assert dr.all(dr.ravel(images[0]) > 0)
+    assert dr.allclose(images[0], images[1], rtol=0.1, atol=0.05 * mean)
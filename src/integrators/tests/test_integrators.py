@@ -51,3 +51,61 @@ def test02_path_directly_visible(variants_all_rgb):
     })
     img = mi.render(scene, integrator=integrator)
     assert dr.allclose(img.array, 0)
+
+
+def test03_path_radiance_cache(variants_all_rgb):
+    scene_description = mi.cornell_box()
+    scene_description['sensor']['film']['width'] = 16
+    scene_description['sensor']['film']['height'] = 16
+    scene = mi.load_dict(scene_description)
+
+    def render(**kwargs):
+        integrator = mi.load_dict({
+            'type': 'path',
+            'max_depth': 6,
+            'samples_per_pass': 16,
+            **kwargs
+        })
+        img = mi.render(scene, integrator=integrator, spp=128, seed=0)
+        return dr.mean(dr.ravel(img))
+
+    reference = render()
+    cached = render(radiance_cache=True, cache_min_samples=4,
+                    cache_resolution=16)
+
+    # The cache introduces a small amount of bias
+    assert dr.allclose(cached, reference, rtol=0.1)
+
+    with pytest.raises(RuntimeError, match='cache_query_depth'):
+        mi.load_dict({'type': 'path', 'cache_query_depth': 1})
+
+
+def test04_path_radiance_cache_reset(variants_all_rgb):
+    # Cached estimates must not survive a scene update between renders
+    scene_description = mi.cornell_box()
+    scene_description['sensor']['film']['width'] = 16
+    scene_description['sensor']['film']['height'] = 16
+    scene = mi.load_dict(scene_description)
+
+    integrator = mi.load_dict({
+        'type': 'path',
+        'max_depth': 6,
+        'samples_per_pass': 16,
+        'radiance_cache': True,
+        'cache_min_samples': 4,
+        'cache_resolution': 16
+    })
+
+    def render():
+        img = mi.render(scene, integrator=integrator, spp=128, seed=0)
+        return dr.mean(dr.ravel(img))
+
+    before = render()
+
+    params = mi.traverse(scene)
+    key = 'light.emitter.radiance.value'
+    params[key] = params[key] * 2
+    params.update()
+
+    # Rendering is linear in the emitted radiance
+    assert dr.allclose(render(), 2 * before, rtol=0.05)
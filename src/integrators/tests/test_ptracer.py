@@ -234,3 +234,23 @@ def test07_adjoint_integrator_trampoline(variants_all_ad_rgb):
     mi.load_dict({
         'type': 'myptracer'
     })
+
+
+def test08_reject_binned_film(variants_all_spectral):
+    # Adjoint samples cannot be splatted into the wavelength bins of a film
+    scene = mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'film': {
+                'type': 'hdrfilm',
+                'width': 4, 'height': 4,
+                'spectral_bins': 16
+            }
+        },
+        'emitter': { 'type': 'constant' }
+    })
+    integrator = mi.load_dict({ 'type': 'ptracer' })
+
+    with pytest.raises(RuntimeError, match='special sample handling'):
+        integrator.render(scene, spp=1)
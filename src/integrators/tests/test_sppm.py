@@ -0,0 +1,139 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def create_test_scene(integrator, max_depth=4, **kwargs):
+    return mi.load_dict({
+        'type': 'scene',
+        'integrator': {
+            'type': integrator,
+            'max_depth': max_depth,
+            **kwargs
+        },
+        'sensor': {
+            'type': 'perspective',
+            'to_world': mi.ScalarTransform4f().look_at(
+                origin=(2, 0, 0),
+                target=(0, 0, 0),
+                up=(0, 1, 0),
+            ),
+            'sampler': {
+                'type': 'independent'
+            },
+            'film': {
+                'type': 'hdrfilm',
+                'width': 8, 'height': 8,
+                'rfilter': {'type': 'box'}
+            },
+        },
+        'receiver': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f().look_at(
+                origin=(0, 0, 0),
+                target=(1, 0, 0),
+                up=(0, 1, 0),
+            ),
+            'bsdf': {'type': 'diffuse'},
+        },
+        'light': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f().look_at(
+                origin=(1, 1.5, 0),
+                target=(1, 0, 0),
+                up=(1, 0, 0),
+            ) @ mi.ScalarTransform4f().scale(0.5),
+            'emitter': {
+                'type': 'area',
+                'radiance': {'type': 'rgb', 'value': (4.0, 2.0, 1.0)},
+            },
+        },
+    })
+
+
+def test01_create(variant_scalar_rgb):
+    scene = create_test_scene('sppm', photon_count=1000, alpha=0.5)
+    assert isinstance(scene.integrator(), mi.Integrator)
+
+    with pytest.raises(RuntimeError, match='alpha'):
+        create_test_scene('sppm', alpha=1.0)
+
+    with pytest.raises(RuntimeError, match='photon_count'):
+        create_test_scene('sppm', photon_count=0)
+
+
+def test02_unsupported_variant(variants_vec_backends_once_rgb):
+    with pytest.raises(RuntimeError, match='scalar'):
+        mi.load_dict({'type': 'sppm'})
+
+
+def test03_direct_matches_path(variant_scalar_rgb):
+    # Without indirect illumination, no photons are gathered
+    means = []
+    for name in ['sppm', 'path']:
+        scene = create_test_scene(name, max_depth=2)
+        image = mi.render(scene, spp=64, seed=0)
+        means.append(dr.mean(dr.ravel(image)))
+
+    assert means[0] > 0
+    assert dr.allclose(means[0], means[1], rtol=5e-2)
+
+
+@pytest.mark.slow
+def test04_indirect(variant_scalar_rgb):
+    # The light reaches the receiver a second time via the (diffuse) light
+    # source geometry; the photon estimate should add a positive contribution
+    direct = create_test_scene('sppm', max_depth=2, photon_count=20000)
+    full = create_test_scene('sppm', max_depth=4, photon_count=20000)
+
+    mean_direct = dr.mean(dr.ravel(mi.render(direct, spp=16, seed=0)))
+    mean_full = dr.mean(dr.ravel(mi.render(full, spp=16, seed=0)))
+    assert mean_full >= mean_direct
+
+
+@pytest.mark.slow
+def test05_mixed_bsdf(variant_scalar_rgb):
+    # The light is only visible through the specular lobe of the plastic
+    # receiver, which sensor paths must follow past the visible point
+    means = []
+    for name in ['sppm', 'path']:
+        scene = mi.load_dict({
+            'type': 'scene',
+            'integrator': {'type': name, 'max_depth': 2},
+            'sensor': {
+                'type': 'perspective',
+                'to_world': mi.ScalarTransform4f().look_at(
+                    origin=(2, 0, 0),
+                    target=(0, 0, 0),
+                    up=(0, 1, 0),
+                ),
+                'film': {
+                    'type': 'hdrfilm',
+                    'width': 8, 'height': 8,
+                    'rfilter': {'type': 'box'}
+                },
+            },
+            'receiver': {
+                'type': 'rectangle',
+                'to_world': mi.ScalarTransform4f().look_at(
+                    origin=(0, 0, 0),
+                    target=(1, 0, 0),
+                    up=(0, 1, 0),
+                ),
+                'bsdf': {'type': 'plastic'},
+            },
+            'light': {
+                'type': 'rectangle',
+                'to_world': mi.ScalarTransform4f().look_at(
+                    origin=(3, 0, 0),
+                    target=(0, 0, 0),
+                    up=(0, 1, 0),
+                ) @ mi.ScalarTransform4f().scale(2),
+                'emitter': {'type': 'area'},
+            },
+        })
+        image = mi.render(scene, spp=256, seed=0)
+        means.append(dr.mean(dr.ravel(image)))
+
+    assert means[0] > 0
+    assert dr.allclose(means[0], means[1], rtol=5e-2)
@@ -14,7 +14,14 @@
 #include <mitsuba/render/integrator.h>
 #include <mitsuba/render/records.h>
 #include <mitsuba/render/scene.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #if !defined(_WIN32)
 #  include <signal.h>
@@ -63,6 +70,20 @@ Options:
     -o <filename>, --output <filename>
         Write the output image to the file "filename".
 
+    --write-queue <count>
+        Maximum number of images that are converted and written to disk
+        in the background while the next scene is being rendered. A value
+        of 0 writes each image before continuing. Default value: 2.
+
+    --write-memory <MiB>
+        Maximum total size of the images waiting to be written (an image
+        exceeding it on its own is still accepted). Default value: 2048.
+
+    --memory-budget <MiB>
+        Abort before rendering if the storage of the scene (acceleration
+        data structure, meshes, textures, volumes, film, ...) exceeds the
+        given budget, and print a breakdown by category.
+
  === The following options are only relevant for JIT (CUDA/LLVM) modes ===
 
     -O [0-5]
@@ -86,6 +107,15 @@ Options:
         supported width is legal and causes arithmetic operations to be
         replicated multiple times.
 
+    --warmup <filename>
+        Trace and compile the kernels of the scene without writing an
+        image. The compiled kernels are stored in the on-disk kernel cache
+        and their hashes are recorded in the signature file "filename".
+
+    --prefetch <filename>
+        Read the kernels listed in a signature file created by --warmup
+        from the on-disk kernel cache while the scene is being loaded.
+
 )";
 }
 
@@ -105,8 +135,218 @@ void scene_static_accel_shutdown() {
     Scene<Float, Spectrum>::static_accel_shutdown();
 }
 
+/// Location of Dr.Jit's on-disk kernel cache
+static fs::path kernel_cache_path() {
+#if defined(_WIN32)
+    const char *base = std::getenv("LOCALAPPDATA");
+    return fs::path(base ? base : ".") / "Temp" / "drjit";
+#else
+    const char *base = std::getenv("HOME");
+    return fs::path(base ? base : ".") / ".drjit";
+#endif
+}
+
+#if defined(MI_ENABLE_CUDA) || defined(MI_ENABLE_LLVM)
+/// Summary of the kernels launched since the kernel history was last cleared
+struct KernelStats {
+    size_t launched = 0, compiled = 0, disk_cache = 0;
+    float compile_time = 0.f;
+    std::vector<std::string> cache_files;
+};
+
+static KernelStats kernel_stats() {
+    KernelStats stats;
+    KernelHistoryEntry *history = jit_kernel_history();
+
+    for (KernelHistoryEntry *e = history; e && (uint32_t) e->backend; ++e) {
+        if (e->type == KernelType::JIT) {
+            stats.launched++;
+            if (!e->cache_hit) {
+                // Code generation and compilation (or loading from disk)
+                stats.compile_time += e->codegen_time + e->backend_time;
+                if (e->cache_disk)
+                    stats.disk_cache++;
+                else
+                    stats.compiled++;
+            }
+
+            // Name of the kernel within the on-disk cache
+            stats.cache_files.push_back(tfm::format(
+                "%016llx%016llx.%s.bin", (unsigned long long) e->hash[1],
+                (unsigned long long) e->hash[0],
+                e->backend == JitBackend::CUDA ? "cuda" : "llvm"));
+        }
+        free(e->ir);
+    }
+
+    free(history);
+    return stats;
+}
+
+/// Write the kernels needed by a scene to a signature file
+static void write_kernel_signature(const fs::path &filename,
+                                   const std::string &variant,
+                                   std::vector<std::string> cache_files) {
+    // Kernels of multi-pass renders are launched several times
+    std::sort(cache_files.begin(), cache_files.end());
+    cache_files.erase(std::unique(cache_files.begin(), cache_files.end()),
+                      cache_files.end());
+
+    std::ofstream os(filename.string());
+    if (!os.good())
+        Throw("Could not create kernel signature file \"%s\"!", filename);
+    os << "# mitsuba kernel signature (" << variant << ")" << std::endl;
+    for (const std::string &name : cache_files)
+        os << name << std::endl;
+}
+#endif
+
+/**
+ * Read the kernels listed in a signature file so that the operating system
+ * caches them before they are needed by the first frame. Returns the number
+ * of kernels found in the on-disk cache.
+ */
+static size_t prefetch_kernels(const fs::path &filename,
+                               const std::string &variant) {
+    std::ifstream is(filename.string());
+    if (!is.good())
+        Throw("Could not open kernel signature file \"%s\"!", filename);
+
+    std::string line;
+    std::getline(is, line);
+    if (line != "# mitsuba kernel signature (" + variant + ")") {
+        Log(Warn, "Kernel signature file \"%s\" was created for a different "
+                  "variant, ignoring it.", filename);
+        return 0;
+    }
+
+    fs::path cache_path = kernel_cache_path();
+    std::vector<char> buffer(1024 * 1024);
+    size_t found = 0, total = 0;
+    while (std::getline(is, line)) {
+        if (line.empty())
+            continue;
+        total++;
+        std::ifstream kernel((cache_path / line).string(), std::ios::binary);
+        if (!kernel.good())
+            continue;
+        while (kernel.read(buffer.data(), buffer.size()))
+            ;
+        found++;
+    }
+
+    Log(Info, "Prefetched %zu/%zu kernels from the on-disk cache.", found, total);
+    return found;
+}
+
+/**
+ * \brief Background worker that converts and writes the rendered images
+ *
+ * The main thread only copies the developed film contents into a bitmap and
+ * hands it to this worker, so that the next scene can be rendered while the
+ * image is being encoded. The queue is bounded both in the number of pending
+ * images and in their total size: \ref push() blocks until there is room. An
+ * exception raised while writing an image is re-thrown by the next call to
+ * \ref push() or \ref finish().
+ */
+class ImageWriter {
+public:
+    ImageWriter(size_t max_count, size_t max_bytes)
+        : m_max_count(max_count), m_max_bytes(max_bytes) {
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    ~ImageWriter() {
+        try {
+            finish();
+        } catch (...) { }
+    }
+
+    /// Enqueue a job that writes an image of size \c bytes
+    void push(std::function<void()> func, size_t bytes) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        // An image that exceeds the memory limit is accepted by an idle queue
+        m_cond.wait(lock, [&] {
+            return m_error || m_pending == 0 ||
+                   (m_pending < m_max_count && m_bytes + bytes <= m_max_bytes);
+        });
+
+        if (m_error)
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+
+        m_queue.push_back({ std::move(func), bytes });
+        m_pending++;
+        m_bytes += bytes;
+        m_cond.notify_all();
+    }
+
+    /// Wait until all pending images have been written and stop the worker
+    void finish() {
+        /* locked */ {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            m_cond.notify_all();
+        }
+
+        if (m_thread.joinable())
+            m_thread.join();
+
+        if (m_error)
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+
+private:
+    struct Job {
+        std::function<void()> func;
+        size_t bytes;
+    };
+
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_cond.wait(lock, [&] { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty())
+                break;
+
+            Job job = std::move(m_queue.front());
+            m_queue.pop_front();
+            lock.unlock();
+
+            std::exception_ptr error;
+            try {
+                job.func();
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            // Release the image before accounting for its memory
+            job.func = nullptr;
+
+            lock.lock();
+            if (error && !m_error)
+                m_error = error;
+            m_pending--;
+            m_bytes -= job.bytes;
+            m_cond.notify_all();
+        }
+    }
+
+private:
+    size_t m_max_count, m_max_bytes;
+    size_t m_pending = 0, m_bytes = 0;
+    std::deque<Job> m_queue;
+    std::exception_ptr m_error;
+    bool m_stop = false;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+};
+
 template <typename Float, typename Spectrum>
-void render(Object *scene_, size_t sensor_i, fs::path filename) {
+void render(Object *scene_, size_t sensor_i, fs::path filename,
+            fs::path warmup_filename, std::string variant,
+            size_t memory_budget, ImageWriter *writer) {
     auto *scene = dynamic_cast<Scene<Float, Spectrum> *>(scene_);
     if (!scene)
         Throw("Root element of the input file must be a <scene> tag!");
@@ -120,8 +360,29 @@ void render(Object *scene_, size_t sensor_i, fs::path filename) {
     if (!integrator)
         Throw("No integrator specified for scene: %s", scene);
 
+    std::string breakdown;
+    size_t total = 0;
+    for (auto &[name, bytes] : scene->memory_report()) {
+        breakdown += tfm::format("%s%s: %s", breakdown.empty() ? "" : ", ",
+                                 name, util::mem_string(bytes));
+        total += bytes;
+    }
+    Log(Info, "Scene storage: %s (%s).", util::mem_string(total), breakdown);
+
+    if (memory_budget > 0)
+        scene->check_memory_budget(memory_budget);
+
     develop_callback_fn = [film]() { film->develop(); };
 
+#if defined(MI_ENABLE_CUDA) || defined(MI_ENABLE_LLVM)
+    bool kernel_history = false;
+    if constexpr (dr::is_jit_v<Float>) {
+        kernel_history = jit_flag(JitFlag::KernelHistory);
+        jit_set_flag(JitFlag::KernelHistory, true);
+        jit_kernel_history_clear();
+    }
+#endif
+
     integrator->render(scene, (uint32_t) sensor_i,
                        0 /* seed */,
                        0 /* spp */,
@@ -130,7 +391,40 @@ void render(Object *scene_, size_t sensor_i, fs::path filename) {
 
     develop_callback_fn = nullptr;
 
-    film->write(filename);
+#if defined(MI_ENABLE_CUDA) || defined(MI_ENABLE_LLVM)
+    if constexpr (dr::is_jit_v<Float>) {
+        KernelStats stats = kernel_stats();
+        jit_set_flag(JitFlag::KernelHistory, kernel_history);
+
+        Log(Info, "Kernel compilation: %s (%zu of %zu kernels compiled, %zu "
+                  "loaded from the on-disk cache).",
+            util::time_string(stats.compile_time, true), stats.compiled,
+            stats.launched, stats.disk_cache);
+
+        if (!warmup_filename.empty()) {
+            write_kernel_signature(warmup_filename, variant, stats.cache_files);
+            Log(Info, "Kernel signature written to \"%s\".", warmup_filename);
+            return;
+        }
+    }
+#else
+    DRJIT_MARK_USED(warmup_filename);
+    DRJIT_MARK_USED(variant);
+#endif
+
+    if (!writer) {
+        film->write(filename);
+        return;
+    }
+
+    /* Copy the developed image to the host, and convert + encode it on the
+       writer thread. The film remains referenced until then. */
+    ref<Bitmap> bitmap = film->bitmap();
+    size_t bytes = bitmap->buffer_size();
+    writer->push([film = ref<Film<Float, Spectrum>>(film),
+                  bitmap = std::move(bitmap),
+                  filename]() { film->write_bitmap(bitmap, filename); },
+                 bytes);
 }
 
 #if !defined(_WIN32)
@@ -168,9 +462,16 @@ int main(int argc, char *argv[]) {
     auto arg_wavefront = parser.add(StringVec{ "-W" });
     auto arg_source    = parser.add(StringVec{ "-S" });
     auto arg_vec_width = parser.add(StringVec{ "-V" }, true);
+    auto arg_warmup    = parser.add(StringVec{ "--warmup" }, true);
+    auto arg_prefetch  = parser.add(StringVec{ "--prefetch" }, true);
+    auto arg_budget    = parser.add(StringVec{ "--memory-budget" }, true);
+    auto arg_wqueue    = parser.add(StringVec{ "--write-queue" }, true);
+    auto arg_wmemory   = parser.add(StringVec{ "--write-memory" }, true);
 
     parser::ParameterList params;
     std::string error_msg, mode;
+    std::thread prefetch_thread;
+    std::unique_ptr<ImageWriter> writer;
 
 #if !defined(_WIN32)
     /* Initialize signal handlers */
@@ -293,9 +594,22 @@ int main(int argc, char *argv[]) {
 #endif
 
         if (!cuda && !llvm &&
-            (*arg_optim_lev || *arg_wavefront || *arg_source || *arg_vec_width))
+            (*arg_optim_lev || *arg_wavefront || *arg_source || *arg_vec_width ||
+             *arg_warmup || *arg_prefetch))
             Throw("Specified an argument that only makes sense in a JIT (LLVM/CUDA) mode!");
 
+        // Read cached kernels in the background while the scene is loaded
+        if (*arg_prefetch) {
+            fs::path prefetch_filename(arg_prefetch->as_string());
+            prefetch_thread = std::thread([prefetch_filename, mode]() {
+                try {
+                    prefetch_kernels(prefetch_filename, mode);
+                } catch (const std::exception &e) {
+                    Log(Warn, "Kernel prefetching failed: %s", e.what());
+                }
+            });
+        }
+
         Profiler::static_initialization();
         color_management_static_initialization(cuda, llvm);
 
@@ -333,6 +647,15 @@ int main(int argc, char *argv[]) {
 
         parser::ParserConfig config(mode);
 
+        int write_queue = *arg_wqueue ? arg_wqueue->as_int() : 2;
+        float write_memory = *arg_wmemory ? arg_wmemory->as_float() : 2048.f;
+        if (write_queue < 0 || !(write_memory > 0.f))
+            Throw("The write queue size must be non-negative and its memory "
+                  "limit positive!");
+        if (write_queue > 0)
+            writer = std::make_unique<ImageWriter>(
+                (size_t) write_queue, (size_t) (write_memory * 1024.0 * 1024.0));
+
         while (arg_extra && *arg_extra) {
             fs::path filename(arg_extra->as_string());
             ref<FileResolver> fr2 = new FileResolver(*fr);
@@ -361,15 +684,49 @@ int main(int argc, char *argv[]) {
                 Throw("Root element of the input file is expanded into "
                       "multiple objects, only a single object is expected!");
 
-            MI_INVOKE_VARIANT(mode, render, objects[0].get(), sensor_i, filename);
+            if (prefetch_thread.joinable())
+                prefetch_thread.join();
+
+            fs::path warmup_filename;
+            if (*arg_warmup)
+                warmup_filename = fs::path(arg_warmup->as_string());
+
+            size_t memory_budget = 0;
+            if (*arg_budget) {
+                float budget = arg_budget->as_float();
+                if (!(budget > 0.f))
+                    Throw("The memory budget must be positive!");
+                memory_budget = (size_t) (budget * 1024.0 * 1024.0);
+            }
+
+            MI_INVOKE_VARIANT(mode, render, objects[0].get(), sensor_i,
+                              filename, warmup_filename, mode, memory_budget,
+                              writer.get());
             arg_extra = arg_extra->next();
         }
+
+        if (writer)
+            writer->finish();
     } catch (const std::exception &e) {
         error_msg = std::string("Caught a critical exception: ") + e.what();
     } catch (...) {
         error_msg = std::string("Caught a critical exception of unknown type!");
     }
 
+    if (prefetch_thread.joinable())
+        prefetch_thread.join();
+
+    // Write the remaining images (if rendering was aborted)
+    if (writer) {
+        try {
+            writer->finish();
+        } catch (const std::exception &e) {
+            if (error_msg.empty())
+                error_msg = std::string("Could not write image: ") + e.what();
+        }
+        writer.reset();
+    }
+
     if (!error_msg.empty()) {
 #if defined(_WIN32)
         HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
@@ -1,4 +1,5 @@
-from .util import traverse, SceneParameters, render, cornell_box, variant_context, scoped_set_variant
+from .util import traverse, SceneParameters, render, cornell_box, variant_context, scoped_set_variant, \
+                   kernel_diagnostics, KernelDiagnostics
 from . import chi2
 from . import ad
 from . import math_py
@@ -25,6 +25,8 @@ class SceneParameters(Mapping):
         self.hierarchy  = hierarchy  if hierarchy  is not None else {}
         self.update_candidates = {}
         self.nodes_to_update = {}
+        self.dirty_keys = set()
+        self.literal_keys = []
 
         self.set_property = mi.set_property
         self.get_property = mi.get_property
@@ -169,6 +171,8 @@ class SceneParameters(Mapping):
                 "gradients enabled, unexpected results may occur!"
             )
 
+        self.dirty_keys.add(key)
+
         node_key = key
         while node is not None:
             parent, depth = self.hierarchy[node]
@@ -231,6 +235,13 @@ class SceneParameters(Mapping):
         self.update_candidates.clear()
         dr.eval()
 
+        # Parameters that remain literal constants are baked into kernels,
+        # each new value then requires a recompilation
+        self.literal_keys = sorted(
+            k for k in self.dirty_keys
+            if k in self.properties and _has_literal(self.__get_value(k)))
+        self.dirty_keys.clear()
+
         return out
 
     def keep(self, keys: None | str | list[str]) -> None:
@@ -267,6 +278,21 @@ def _jit_id_hash(value: Any) -> int:
 
     return hash(tuple(jit_ids(value)))
 
+def _has_literal(value: Any) -> bool:
+    """
+    Returns ``True`` when the input contains a JIT variable that is a literal
+    constant (i.e., a value that is compiled into kernels).
+    """
+    if dr.is_tensor_v(value):
+        return _has_literal(value.array)
+    if dr.is_jit_v(value):
+        if dr.depth(value) == 1:
+            return value.state == dr.VarState.Literal
+        return any(_has_literal(v) for v in value)
+    if hasattr(value, 'matrix'):
+        return _has_literal(value.matrix)
+    return False
+
 def traverse(node: mi.Object) -> SceneParameters:
     """
     Traverse a node of Mitsuba's scene graph and return a dictionary-like
@@ -701,6 +727,83 @@ def cornell_box():
     }
 
 
+class KernelDiagnostics:
+    """
+    Summary of the JIT kernels launched within a
+    :py:func:`~mitsuba.kernel_diagnostics` block.
+    """
+
+    def __init__(self):
+        #: Number of launched kernels
+        self.launched = 0
+        #: Number of kernels that had to be compiled (cache misses)
+        self.compiled = 0
+        #: Number of kernels loaded from the on-disk cache
+        self.disk_cache = 0
+        #: Updated scene parameters that are compiled into kernels as literals
+        self.literal_params = []
+
+    def __repr__(self) -> str:
+        return (f'KernelDiagnostics[launched={self.launched}, '
+                f'compiled={self.compiled}, disk_cache={self.disk_cache}, '
+                f'literal_params={self.literal_params}]')
+
+@contextlib.contextmanager
+def kernel_diagnostics(params: Optional[SceneParameters] = None,
+                       log_level: mi.LogLevel = mi.LogLevel.Info):
+    """
+    Count the JIT kernels compiled within the enclosed block, which is
+    typically a single call to :py:func:`mitsuba.render`.
+
+    Scene parameters that are updated with a literal constant (as opposed to
+    an opaque variable) are compiled into the rendering kernels, and every
+    new value triggers a recompilation. When ``params`` is given, the keys of
+    such parameters from the last :py:meth:`~mitsuba.SceneParameters.update()`
+    are reported as the likely cause of cache misses.
+
+    The summary is logged at level ``log_level`` whenever a kernel had to be
+    compiled and is also available through the returned
+    :py:class:`~mitsuba.KernelDiagnostics` object:
+
+    .. code-block:: python
+
+        params['light.emitter.radiance.value'] = mi.Color3f(1, 2, 3)
+        params.update()
+
+        with mi.kernel_diagnostics(params) as diag:
+            image = mi.render(scene, params)
+
+    Note that this consumes Dr.Jit's kernel history (see
+    :py:func:`drjit.kernel_history`).
+    """
+
+    diag = KernelDiagnostics()
+    if params is not None:
+        diag.literal_params = list(params.literal_keys)
+
+    if not dr.is_jit_v(mi.Float):
+        yield diag
+        return
+
+    with dr.scoped_set_flag(dr.JitFlag.KernelHistory, True):
+        dr.kernel_history_clear()
+        yield diag
+        dr.eval()
+        history = dr.kernel_history([dr.KernelType.JIT])
+
+    diag.launched = len(history)
+    diag.disk_cache = sum(1 for e in history if e['cache_disk'])
+    diag.compiled = sum(1 for e in history
+                        if not e['cache_hit'] and not e['cache_disk'])
+
+    if diag.compiled > 0:
+        msg = (f'kernel_diagnostics(): compiled {diag.compiled} of '
+               f'{diag.launched} kernel(s)')
+        if len(diag.literal_params) > 0:
+            msg += ('; parameters compiled into kernels as literals: ' +
+                    ', '.join(diag.literal_params))
+        mi.Log(log_level, msg)
+
 @contextlib.contextmanager
 def variant_context(*args) -> None:
     '''
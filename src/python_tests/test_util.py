@@ -325,3 +325,25 @@ def test06_variant_context():
     except RuntimeError:
         pass
     assert mi.variant() == "scalar_rgb"
+
+
+def test07_kernel_diagnostics(variants_vec_rgb):
+    scene = mi.load_dict(mi.cornell_box())
+    params = mi.traverse(scene)
+    key = 'light.emitter.radiance.value'
+
+    # Warm up the kernel cache
+    mi.render(scene, spp=1)
+
+    for i in range(2):
+        params[key] = mi.Color3f(10 + i, 10, 10)
+        params.update()
+
+        # Emitter radiance is opaque, updating it must not recompile kernels
+        assert params.literal_keys == []
+        with mi.kernel_diagnostics(params) as diag:
+            mi.render(scene, spp=1)
+
+        assert diag.launched > 0
+        assert diag.compiled == 0
+        assert diag.literal_params == []
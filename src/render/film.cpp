@@ -1,4 +1,6 @@
 #include <mitsuba/render/film.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/properties.h>
 
@@ -57,6 +59,16 @@ MI_VARIANT void Film<Float, Spectrum>::traverse(TraversalCallback *cb) {
     cb->put("crop_offset", m_crop_offset, ParamFlags::NonDifferentiable);
 }
 
+MI_VARIANT void Film<Float, Spectrum>::write_bitmap(const Bitmap *bitmap,
+                                                    const fs::path &path) const {
+    bitmap->write(path);
+}
+
+MI_VARIANT size_t Film<Float, Spectrum>::memory_usage() const {
+    return (size_t) dr::prod(m_crop_size) * (base_channels_count() + 1) *
+           sizeof(ScalarFloat);
+}
+
 MI_VARIANT void Film<Float, Spectrum>::parameters_changed(const std::vector<std::string> &keys) {
     ScalarVector2u crop_size = m_crop_size;
     ScalarPoint2u crop_offset = m_crop_offset;
@@ -82,6 +94,16 @@ Film<Float, Spectrum>::prepare_sample(const UnpolarizedSpectrum & /* spec */,
     NotImplementedError("prepare_sample");
 }
 
+MI_VARIANT void
+Film<Float, Spectrum>::put_sample(ImageBlock *block, const Point2f &pos,
+                                  const UnpolarizedSpectrum &spec,
+                                  const Wavelength &wavelengths, Float *aovs,
+                                  Float weight, Float alpha,
+                                  Mask active) const {
+    prepare_sample(spec, wavelengths, aovs, weight, alpha, active);
+    block->put(pos, aovs, active);
+}
+
 MI_VARIANT const typename Film<Float, Spectrum>::Texture *
 Film<Float, Spectrum>::sensor_response_function() {
     return m_srf.get();
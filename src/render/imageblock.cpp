@@ -174,29 +174,50 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put_block(const ImageBlock *block)
 MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
                                                  const Float *values,
                                                  Mask active) {
+    put_impl(pos, values, nullptr, m_channel_count, active);
+}
+
+MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
+                                                 const Float *values,
+                                                 const UInt32 *channels,
+                                                 uint32_t value_count,
+                                                 Mask active) {
+    put_impl(pos, values, channels, value_count, active);
+}
+
+MI_VARIANT void ImageBlock<Float, Spectrum>::put_impl(const Point2f &pos,
+                                                      const Float *values,
+                                                      const UInt32 *channels,
+                                                      uint32_t value_count,
+                                                      Mask active) {
     ScopedPhase sp(ProfilerPhase::ImageBlockPut);
     constexpr bool JIT = dr::is_jit_v<Float>;
 
+    // Offset of the channel receiving values[k] relative to the pixel start
+    auto channel = [channels](uint32_t k) -> UInt32 {
+        return channels ? channels[k] : UInt32(k);
+    };
+
     // Check if all sample values are valid
     if (m_warn_negative || m_warn_invalid) {
         Mask is_valid = true;
 
         if (m_warn_negative) {
-            for (uint32_t k = 0; k < m_channel_count; ++k)
+            for (uint32_t k = 0; k < value_count; ++k)
                 is_valid &= values[k] >= -1e-5f;
         }
 
         if (m_warn_invalid) {
-            for (uint32_t k = 0; k < m_channel_count; ++k)
+            for (uint32_t k = 0; k < value_count; ++k)
                 is_valid &= dr::isfinite(values[k]);
         }
 
         if (unlikely(dr::any(active && !is_valid))) {
             std::ostringstream oss;
             oss << "Invalid sample value: [";
-            for (uint32_t i = 0; i < m_channel_count; ++i) {
+            for (uint32_t i = 0; i < value_count; ++i) {
                 oss << values[i];
-                if (i + 1 < m_channel_count) oss << ", ";
+                if (i + 1 < value_count) oss << ", ";
             }
             oss << "]";
             Log(Warn, "%s", oss.str());
@@ -222,11 +243,11 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
                 return;
 
             ScalarFloat *ptr = m_tensor.array().data() + index;
-            for (uint32_t k = 0; k < m_channel_count; ++k)
-                *ptr++ += values[k];
+            for (uint32_t k = 0; k < value_count; ++k)
+                ptr[channel(k)] += values[k];
         } else {
-            for (uint32_t k = 0; k < m_channel_count; ++k)
-                accum(values[k], index++, active);
+            for (uint32_t k = 0; k < value_count; ++k)
+                accum(values[k], index + channel(k), active);
         }
 
         return;
@@ -253,7 +274,7 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
                           !dr::grad_enabled(pos) &&
                           !dr::grad_enabled(m_tensor);
 
-            for (uint32_t k = 0; k < m_channel_count; ++k)
+            for (uint32_t k = 0; k < value_count; ++k)
                 record_loop = record_loop && !dr::grad_enabled(values[k]);
         }
     }
@@ -355,18 +376,19 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
                 for (uint32_t x = 0; x < count.x(); ++x) {
                     Mask active_2 = active_1 && x < count_u.x();
 
-                    for (uint32_t k = 0; k < m_channel_count; ++k) {
+                    for (uint32_t k = 0; k < value_count; ++k) {
                         Float weight = weights_x[x] * weights_y[y];
+                        UInt32 index_k = index + channel(k);
 
                         if constexpr (!JIT) {
                             DRJIT_MARK_USED(active_2);
-                            ptr[index] = dr::fmadd(values[k], weight, ptr[index]);
+                            ptr[index_k] = dr::fmadd(values[k], weight, ptr[index_k]);
                         } else {
-                            accum(values[k] * weight, index, active_2);
+                            accum(values[k] * weight, index_k, active_2);
                         }
-
-                        index++;
                     }
+
+                    index += m_channel_count;
                 }
 
                 index += (size.x() - count.x()) * m_channel_count;
@@ -390,8 +412,8 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
                 [count](const UInt32 &ys, const UInt32 &) {
                     return ys < count.y();
                 },
-                [this, active, count, values, pos_0_u, pos_1_u,
-                 rel_f, size](UInt32 &ys, UInt32 &index) {
+                [this, active, count, values, value_count, channel,
+                 pos_0_u, pos_1_u, rel_f, size](UInt32 &ys, UInt32 &index) {
                     Float weight_y = m_rfilter->eval(rel_f.y() + Float(ys));
                     Mask active_1 = active && (pos_0_u.y() + ys <= pos_1_u.y());
 
@@ -402,16 +424,18 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
                         [count](const UInt32 &xs, const UInt32 &) {
                             return xs < count.x();
                         },
-                        [this, values, rel_f, weight_y, pos_0_u, pos_1_u,
-                         active_1](UInt32 &xs, UInt32 &index) {
+                        [this, values, value_count, channel, rel_f, weight_y,
+                         pos_0_u, pos_1_u, active_1](UInt32 &xs, UInt32 &index) {
                             Float weight_x =
                                       m_rfilter->eval(rel_f.x() + Float(xs)),
                                   weight = weight_x * weight_y;
 
                             Mask active_2 =
                                 active_1 && (pos_0_u.x() + xs <= pos_1_u.x());
-                            for (uint32_t k = 0; k < m_channel_count; ++k)
-                                accum(values[k] * weight, index++, active_2);
+                            for (uint32_t k = 0; k < value_count; ++k)
+                                accum(values[k] * weight, index + channel(k),
+                                      active_2);
+                            index += m_channel_count;
 
                             xs++;
                         },
@@ -496,9 +520,10 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
                     Mask active_2 = active_1 && x < size.x();
                     Float weight = weights_y[ys] * weights_x[xs];
 
-                    for (uint32_t k = 0; k < m_channel_count; ++k)
-                        accum(values[k] * weight, index++, active_2);
+                    for (uint32_t k = 0; k < value_count; ++k)
+                        accum(values[k] * weight, index + channel(k), active_2);
 
+                    index += m_channel_count;
                     x++;
                 }
 
@@ -524,8 +549,8 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
                 [count](const UInt32 &ys, const UInt32 &) {
                     return ys < count;
                 },
-                [this, active, count, values, x, y, rel_f,
-                    size](UInt32 &ys, UInt32 &index) {
+                [this, active, count, values, value_count, channel, x, y,
+                    rel_f, size](UInt32 &ys, UInt32 &index) {
                     Float weight_y = m_rfilter->eval(rel_f.y() + Float(ys));
                     Mask active_1 = active && (y + ys < size.y());
 
@@ -536,15 +561,17 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
                         [count](const UInt32 &xs, const UInt32 &) {
                             return xs < count;
                         },
-                        [this, values, rel_f, weight_y, x, y, size,
-                            active_1](UInt32 &xs, UInt32 &index) {
+                        [this, values, value_count, channel, rel_f, weight_y,
+                            x, y, size, active_1](UInt32 &xs, UInt32 &index) {
                             Float weight_x =
                                     m_rfilter->eval(rel_f.x() + Float(xs)),
                                   weight = weight_x * weight_y;
 
                             Mask active_2 = active_1 && (x + xs < size.x());
-                            for (uint32_t k = 0; k < m_channel_count; ++k)
-                                accum(values[k] * weight, index++, active_2);
+                            for (uint32_t k = 0; k < value_count; ++k)
+                                accum(values[k] * weight, index + channel(k),
+                                      active_2);
+                            index += m_channel_count;
 
                             xs++;
                         },
@@ -19,6 +19,19 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
+/**
+ * NUMA node that the calling thread should run on while it processes a range
+ * of a parallel loop. Nodes are assigned round-robin, once per thread, so that
+ * a thread keeps using the same node-local data across ranges.
+ */
+static int numa_worker_node() {
+    static std::atomic<uint32_t> counter { 0 };
+    static thread_local int node = -1;
+    if (node < 0)
+        node = (int) (counter++ % (uint32_t) util::numa_node_count());
+    return node;
+}
+
 // -----------------------------------------------------------------------------
 
 MI_VARIANT Integrator<Float, Spectrum>::Integrator(const Properties &props)
@@ -230,9 +243,19 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
         // Avoid overlaps in RNG seeding RNG when a seed is manually specified
         seed *= dr::prod(film_size);
 
+        // Spread the workers over the NUMA nodes so that they use local scene data
+        bool numa_pin = scene->numa_policy() != util::NumaPolicy::None &&
+                        util::numa_node_count() > 1;
+
         dr::parallel_for(
             dr::blocked_range<uint32_t>(0, total_blocks, grain_size),
             [&](const dr::blocked_range<uint32_t> &range) {
+                /* Pin for the duration of this range only: the calling
+                   thread (e.g. the main thread) can also process ranges */
+                std::unique_ptr<util::ScopedNumaPin> pin;
+                if (numa_pin)
+                    pin = std::make_unique<util::ScopedNumaPin>(numa_worker_node());
+
                 // Fork a non-overlapping sampler for the current worker
                 ref<Sampler> sampler = sensor->sampler()->fork();
 
@@ -489,11 +512,16 @@ SamplingIntegrator<Float, Spectrum>::render_sample(const Scene *scene,
 
     UnpolarizedSpectrum spec_u = unpolarized_spectrum(ray_weight * spec);
 
+    // With box filter, ignore random offset to prevent numerical instabilities
+    Point2f splat_pos = box_filter ? pos : sample_pos;
+
     if (unlikely(has_flag(film->flags(), FilmFlags::Special))) {
-        film->prepare_sample(spec_u, ray.wavelengths, aovs,
-                             /*weight*/ 1.f,
-                             /*alpha */ dr::select(valid, Float(1.f), Float(0.f)),
-                             valid);
+        // Invalid lanes still contribute to the weight (and alpha) channels
+        film->put_sample(block, splat_pos,
+                         dr::select(valid, spec_u, 0.f), ray.wavelengths, aovs,
+                         /*weight*/ 1.f,
+                         /*alpha */ dr::select(valid, Float(1.f), Float(0.f)),
+                         active);
     } else {
         Color3f rgb;
         if constexpr (is_spectral_v<Spectrum>)
@@ -513,10 +541,9 @@ SamplingIntegrator<Float, Spectrum>::render_sample(const Scene *scene,
         } else {
             aovs[3] = 1.f;
         }
-    }
 
-    // With box filter, ignore random offset to prevent numerical instabilities
-    block->put(box_filter ? pos : sample_pos, aovs, active);
+        block->put(splat_pos, aovs, active);
+    }
 }
 
 MI_VARIANT std::pair<Spectrum, typename SamplingIntegrator<Float, Spectrum>::Mask>
@@ -570,6 +597,12 @@ MI_VARIANT AdjointIntegrator<Float, Spectrum>::AdjointIntegrator(const Propertie
 
 MI_VARIANT AdjointIntegrator<Float, Spectrum>::~AdjointIntegrator() { }
 
+MI_VARIANT void AdjointIntegrator<Float, Spectrum>::sample_indexed(
+    const Scene *scene, const Sensor *sensor, Sampler *sampler,
+    ImageBlock *block, ScalarFloat sample_scale, size_t /* index */) const {
+    sample(scene, sensor, sampler, block, sample_scale);
+}
+
 MI_VARIANT typename AdjointIntegrator<Float, Spectrum>::TensorXf
 AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
                                            Sensor *sensor,
@@ -607,6 +640,13 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
     std::vector<std::string> aovs = aov_names();
     if (!aovs.empty())
         Throw("AOVs are not supported in the AdjointIntegrator!");
+
+    /* Adjoint samples are splatted using ImageBlock::put() with the
+       standard RGB, [A], W layout, which films with a custom sample
+       treatment (e.g. "specfilm", or "hdrfilm" with "spectral_bins") lack */
+    if (has_flag(film->flags(), FilmFlags::Special))
+        Throw("Films with special sample handling are not supported in the "
+              "AdjointIntegrator!");
     film->prepare(aovs);
 
     // Special case: no emitters present in the scene.
@@ -652,32 +692,69 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
         // Start the render timer (used for timeouts & log messages)
         m_render_timer.reset();
 
+        // Spread the workers over the NUMA nodes so that they use local scene data
+        bool numa_pin = scene->numa_policy() != util::NumaPolicy::None &&
+                        util::numa_node_count() > 1;
+
+        /* Particles splat anywhere on the film, hence every worker needs a
+           crop-size block. Workers check out a persistent block from a pool
+           that never grows beyond the number of concurrently running ranges,
+           and return it (without merging) when their range is done. A block
+           is only merged into the film and cleared once it holds about one
+           pass worth of a thread's samples, which keeps the film updated
+           progressively with roughly 'n_threads' merges per pass instead of
+           one per range. Protected by 'mutex'. */
+        struct PooledBlock {
+            ref<ImageBlock> block;
+            size_t samples = 0;
+        };
+        std::vector<PooledBlock> free_blocks;
+        size_t flush_samples =
+            std::max(samples_per_pass / n_threads, (size_t) 1);
+
         dr::parallel_for(
             dr::blocked_range<size_t>(0, total_samples, grain_size),
             [&](const dr::blocked_range<size_t> &range) {
+                /* Pin for the duration of this range only: the calling
+                   thread (e.g. the main thread) can also process ranges */
+                std::unique_ptr<util::ScopedNumaPin> pin;
+                if (numa_pin)
+                    pin = std::make_unique<util::ScopedNumaPin>(numa_worker_node());
 
                 // Fork a non-overlapping sampler for the current worker
                 ref<Sampler> sampler = sensor->sampler()->clone();
 
-                ref<ImageBlock> block = film->create_block(
-                    ScalarVector2u(0) /* use crop size */,
-                    true /* normalize */,
-                    false /* border */);
+                PooledBlock pooled;
+                /* locked */ {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!free_blocks.empty()) {
+                        pooled = std::move(free_blocks.back());
+                        free_blocks.pop_back();
+                    }
+                }
+
+                if (!pooled.block) {
+                    pooled.block = film->create_block(
+                        ScalarVector2u(0) /* use crop size */,
+                        true /* normalize */,
+                        false /* border */);
 
-                block->set_offset(film->crop_offset());
+                    pooled.block->set_offset(film->crop_offset());
+                    pooled.block->clear();
+                }
 
-                // Clear block (it's being reused)
-                block->clear();
+                ImageBlock *block = pooled.block.get();
 
                 sampler->seed(seed +
                               (uint32_t) range.begin() / (uint32_t) grain_size);
 
                 size_t ctr = 0;
                 for (auto i = range.begin(); i != range.end() && !should_stop(); ++i) {
-                    sample(scene, sensor, sampler, block, sample_scale);
+                    sample_indexed(scene, sensor, sampler, block, sample_scale, i);
                     sampler->advance();
 
                     ctr++;
+                    pooled.samples++;
                     if (ctr > 10000) {
                         std::lock_guard<std::mutex> lock(mutex);
                         samples_done += ctr;
@@ -685,17 +762,30 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
                         progress->update(samples_done / (ScalarFloat) total_samples);
                     }
                 }
-                total_samples += ctr;
+                samples_done += ctr;
+
+                // Merge the block into the film once it holds enough samples
+                if (pooled.samples >= flush_samples) {
+                    film->put_block(block);
+                    block->clear();
+                    pooled.samples = 0;
+                }
 
-                // When all samples are done for this range, commit to the film
                 /* locked */ {
                     std::lock_guard<std::mutex> lock(mutex);
                     progress->update(samples_done / (ScalarFloat) total_samples);
-                    film->put_block(block);
+                    free_blocks.push_back(std::move(pooled));
                 }
             }
         );
 
+        // Merge the remaining partially filled blocks
+        for (PooledBlock &pooled : free_blocks) {
+            if (pooled.samples > 0)
+                film->put_block(pooled.block);
+        }
+        free_blocks.clear();
+
         if (develop)
             result = film->develop();
     } else {
@@ -48,6 +48,24 @@ MI_VARIANT ShapeKDTree<Float, Spectrum>::ShapeKDTree(const Properties &props)
     if (props.has_property("kd_exact_primitive_threshold"))
         set_exact_primitive_threshold(props.get<int>("kd_exact_primitive_threshold"));
 
+    /* kd-tree construction: Number of primitives, above which both children
+       of a node are built in parallel by the O(n log n) method. Zero disables
+       parallelism within O(n log n) subtrees. */
+    if (props.has_property("kd_parallel_nlogn_threshold"))
+        set_parallel_nlogn_threshold(props.get<int>("kd_parallel_nlogn_threshold"));
+
+    /* kd-tree traversal: Test the primitive that most recently blocked a
+       shadow ray on the current thread before traversing the tree.
+       Disabled by default. */
+    if (props.has_property("kd_occluder_cache"))
+        set_occluder_cache(props.get<bool>("kd_occluder_cache"));
+
+    /* kd-tree traversal: Shadow rays visit the child node covering the
+       longer ray segment first instead of using front-to-back order.
+       Disabled by default. */
+    if (props.has_property("kd_any_hit_larger_first"))
+        set_any_hit_larger_first(props.get<bool>("kd_any_hit_larger_first"));
+
     m_primitive_map.push_back(0);
 }
 
@@ -56,10 +74,12 @@ MI_VARIANT void ShapeKDTree<Float, Spectrum>::clear() {
     m_primitive_map.clear();
     m_primitive_map.push_back(0);
     m_bbox.reset();
-    m_nodes.release();
-    m_indices.release();
+    m_nodes.reset();
+    m_indices.reset();
+    m_numa_replicas.clear();
     m_node_count = 0;
     m_index_count = 0;
+    m_build_id = 0;
 }
 
 MI_VARIANT void ShapeKDTree<Float, Spectrum>::build() {
@@ -69,6 +89,14 @@ MI_VARIANT void ShapeKDTree<Float, Spectrum>::build() {
 
     Base::build();
 
+    if (m_numa_policy != util::NumaPolicy::None)
+        apply_numa_policy();
+
+    /* Invalidate the per-thread occluder caches that refer to a previous
+       build (of this or any other kd-tree) */
+    static std::atomic<uint64_t> build_counter { 0 };
+    m_build_id = ++build_counter;
+
     Log(Info, "Finished. (%s of storage, took %s)",
         util::mem_string(m_index_count * sizeof(Index) +
                         m_node_count * sizeof(KDNode)),
@@ -76,6 +104,48 @@ MI_VARIANT void ShapeKDTree<Float, Spectrum>::build() {
     );
 }
 
+MI_VARIANT void ShapeKDTree<Float, Spectrum>::apply_numa_policy() {
+    int node_count = util::numa_node_count();
+    if (node_count < 2) {
+        Log(Debug, "NUMA placement requested, but the machine only has a "
+                   "single NUMA node.");
+        return;
+    }
+
+    size_t node_bytes  = m_node_count * sizeof(KDNode),
+           index_bytes = m_index_count * sizeof(Index);
+
+    if (m_numa_policy == util::NumaPolicy::Interleave) {
+        bool success = util::numa_place(m_nodes.get(), node_bytes) &&
+                       util::numa_place(m_indices.get(), index_bytes);
+        Log(success ? Debug : Warn,
+            "Interleaving kd-tree storage across %i NUMA nodes %s", node_count,
+            success ? "succeeded." : "failed, using first-touch placement.");
+        return;
+    }
+
+    /* Replicate the node and index arrays. Each copy is migrated to its NUMA
+       node, and pinned threads then traverse the replica of their node. */
+    m_numa_replicas.resize(node_count);
+    dr::parallel_for(
+        dr::blocked_range<int>(0, node_count, 1),
+        [&](const dr::blocked_range<int> &range) {
+            for (int node = range.begin(); node != range.end(); ++node) {
+                NumaReplica &replica = m_numa_replicas[node];
+                replica.nodes = detail::make_page_array<KDNode>(m_node_count, m_huge_pages);
+                replica.indices = detail::make_page_array<Index>(m_index_count, m_huge_pages);
+                util::numa_place(replica.nodes.get(), node_bytes, node);
+                util::numa_place(replica.indices.get(), index_bytes, node);
+                memcpy(replica.nodes.get(), m_nodes.get(), node_bytes);
+                memcpy(replica.indices.get(), m_indices.get(), index_bytes);
+            }
+        }
+    );
+
+    Log(Debug, "Replicated kd-tree storage on %i NUMA nodes (%s per node).",
+        node_count, util::mem_string(node_bytes + index_bytes));
+}
+
 MI_VARIANT void ShapeKDTree<Float, Spectrum>::add_shape(Shape *shape) {
     Assert(!ready());
     m_primitive_map.push_back(m_primitive_map.back() +
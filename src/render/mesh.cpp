@@ -1560,6 +1560,22 @@ Mesh<Float, Spectrum>::compute_surface_interaction(const Ray3f &ray,
     // Re-interpolate intersection using barycentric coordinates
     si.p = dr::fmadd(p0, b0, dr::fmadd(p1, b1, p2 * b2));
 
+    /* Conservative bound on the error of the re-interpolated position (PBRT,
+       Section 6.8.5). The ray tracing backend may intersect in lower
+       precision, which adds an error relative to the vertex magnitudes that
+       spawned rays must clear as well. Single precision variants keep using
+       the epsilon-based offset, which is larger than this bound. */
+    if constexpr (std::is_same_v<ScalarFloat, double>) {
+        Vector3f p_abs = dr::fmadd(dr::abs(p0), dr::abs(b0),
+                         dr::fmadd(dr::abs(p1), dr::abs(b1),
+                                   dr::abs(p2) * dr::abs(b2)));
+        Float v_max = dr::max(dr::maximum(dr::abs(p0),
+                              dr::maximum(dr::abs(p1), dr::abs(p2))));
+        si.p_error = dr::detach(dr::fmadd(
+            v_max, math::error_gamma(16, math::TraceEpsilon<Float>),
+            dr::max(p_abs) * math::error_gamma(7, dr::Epsilon<ScalarFloat>)));
+    }
+
     // Potentially recompute the distance traveled to the surface interaction hit point
     if (IsDiff && has_flag(ray_flags, RayFlags::FollowShape))
         t = dr::sqrt(dr::squared_norm(si.p - ray.o) / dr::squared_norm(ray.d));
@@ -1704,6 +1720,7 @@ MI_VARIANT void Mesh<Float, Spectrum>::add_attribute(std::string_view name,
 
     FloatStorage buffer = dr::load<FloatStorage>(data.data(), count * dim);
     m_mesh_attributes.insert({ std::string(name), { dim, type, buffer } });
+    update_attribute_slots();
 }
 
 MI_VARIANT void
@@ -1714,6 +1731,7 @@ Mesh<Float, Spectrum>::remove_attribute(std::string_view name) {
         return Base::remove_attribute(name);
     }
     m_mesh_attributes.erase(it);
+    update_attribute_slots();
 }
 
 MI_VARIANT typename Mesh<Float, Spectrum>::Mask
@@ -1724,15 +1742,21 @@ Mesh<Float, Spectrum>::has_attribute(std::string_view name, Mask active) const {
     return true;
 }
 
-MI_VARIANT typename Mesh<Float, Spectrum>::UnpolarizedSpectrum
-Mesh<Float, Spectrum>::eval_attribute(std::string_view name,
-                                      const SurfaceInteraction3f &si,
-                                      Mask active) const {
-    const auto& it = m_mesh_attributes.find(name);
-    if (it == m_mesh_attributes.end())
-        return Base::eval_attribute(name, si, active);
+MI_VARIANT void Mesh<Float, Spectrum>::update_attribute_slots() {
+    m_attribute_slots.clear();
+    for (const auto &entry : m_mesh_attributes) {
+        uint32_t id = Base::attribute_id(entry.first);
+        if (id >= m_attribute_slots.size())
+            m_attribute_slots.resize(id + 1, nullptr);
+        m_attribute_slots[id] = &entry;
+    }
+}
 
-    const auto& attr = it->second;
+MI_VARIANT typename Mesh<Float, Spectrum>::UnpolarizedSpectrum
+Mesh<Float, Spectrum>::eval_mesh_attribute(const MeshAttribute &attr,
+                                           std::string_view name,
+                                           const SurfaceInteraction3f &si,
+                                           Mask active) const {
     if (attr.size == 1)
         return interpolate_attribute<1, false>(attr.type, attr.buf, si, active);
     else if (attr.size == 3) {
@@ -1750,14 +1774,10 @@ Mesh<Float, Spectrum>::eval_attribute(std::string_view name,
 }
 
 MI_VARIANT Float
-Mesh<Float, Spectrum>::eval_attribute_1(std::string_view name,
-                                        const SurfaceInteraction3f &si,
-                                        Mask active) const {
-    const auto& it = m_mesh_attributes.find(name);
-    if (it == m_mesh_attributes.end())
-        return Base::eval_attribute_1(name, si, active);
-
-    const auto& attr = it->second;
+Mesh<Float, Spectrum>::eval_mesh_attribute_1(const MeshAttribute &attr,
+                                             std::string_view name,
+                                             const SurfaceInteraction3f &si,
+                                             Mask active) const {
     if (attr.size == 1) {
         return interpolate_attribute<1, true>(attr.type, attr.buf, si, active);
     } else {
@@ -1769,14 +1789,10 @@ Mesh<Float, Spectrum>::eval_attribute_1(std::string_view name,
 }
 
 MI_VARIANT typename Mesh<Float, Spectrum>::Color3f
-Mesh<Float, Spectrum>::eval_attribute_3(std::string_view name,
-                                        const SurfaceInteraction3f &si,
-                                        Mask active) const {
-    const auto& it = m_mesh_attributes.find(name);
-    if (it == m_mesh_attributes.end())
-        return Base::eval_attribute_3(name, si, active);
-
-    const auto& attr = it->second;
+Mesh<Float, Spectrum>::eval_mesh_attribute_3(const MeshAttribute &attr,
+                                             std::string_view name,
+                                             const SurfaceInteraction3f &si,
+                                             Mask active) const {
     if (attr.size == 3) {
         return interpolate_attribute<3, true>(attr.type, attr.buf, si, active);
     } else {
@@ -1787,6 +1803,66 @@ Mesh<Float, Spectrum>::eval_attribute_3(std::string_view name,
     }
 }
 
+MI_VARIANT typename Mesh<Float, Spectrum>::UnpolarizedSpectrum
+Mesh<Float, Spectrum>::eval_attribute(std::string_view name,
+                                      const SurfaceInteraction3f &si,
+                                      Mask active) const {
+    const auto& it = m_mesh_attributes.find(name);
+    if (it == m_mesh_attributes.end())
+        return Base::eval_attribute(name, si, active);
+    return eval_mesh_attribute(it->second, name, si, active);
+}
+
+MI_VARIANT Float
+Mesh<Float, Spectrum>::eval_attribute_1(std::string_view name,
+                                        const SurfaceInteraction3f &si,
+                                        Mask active) const {
+    const auto& it = m_mesh_attributes.find(name);
+    if (it == m_mesh_attributes.end())
+        return Base::eval_attribute_1(name, si, active);
+    return eval_mesh_attribute_1(it->second, name, si, active);
+}
+
+MI_VARIANT typename Mesh<Float, Spectrum>::Color3f
+Mesh<Float, Spectrum>::eval_attribute_3(std::string_view name,
+                                        const SurfaceInteraction3f &si,
+                                        Mask active) const {
+    const auto& it = m_mesh_attributes.find(name);
+    if (it == m_mesh_attributes.end())
+        return Base::eval_attribute_3(name, si, active);
+    return eval_mesh_attribute_3(it->second, name, si, active);
+}
+
+MI_VARIANT typename Mesh<Float, Spectrum>::UnpolarizedSpectrum
+Mesh<Float, Spectrum>::eval_attribute_by_id(uint32_t id,
+                                            const SurfaceInteraction3f &si,
+                                            Mask active) const {
+    const auto *entry = attribute_slot(id);
+    if (!entry)
+        return Base::eval_attribute_by_id(id, si, active);
+    return eval_mesh_attribute(entry->second, entry->first, si, active);
+}
+
+MI_VARIANT Float
+Mesh<Float, Spectrum>::eval_attribute_1_by_id(uint32_t id,
+                                              const SurfaceInteraction3f &si,
+                                              Mask active) const {
+    const auto *entry = attribute_slot(id);
+    if (!entry)
+        return Base::eval_attribute_1_by_id(id, si, active);
+    return eval_mesh_attribute_1(entry->second, entry->first, si, active);
+}
+
+MI_VARIANT typename Mesh<Float, Spectrum>::Color3f
+Mesh<Float, Spectrum>::eval_attribute_3_by_id(uint32_t id,
+                                              const SurfaceInteraction3f &si,
+                                              Mask active) const {
+    const auto *entry = attribute_slot(id);
+    if (!entry)
+        return Base::eval_attribute_3_by_id(id, si, active);
+    return eval_mesh_attribute_3(entry->second, entry->first, si, active);
+}
+
 //! @}
 // =============================================================
 
@@ -1988,6 +2064,12 @@ MI_VARIANT bool Mesh<Float, Spectrum>::parameters_grad_enabled() const {
     return dr::grad_enabled(m_vertex_positions);
 }
 
+MI_VARIANT size_t Mesh<Float, Spectrum>::memory_usage() const {
+    size_t count = dr::width(m_area_pmf.pmf()) + dr::width(m_area_pmf.cdf()) +
+                   dr::width(m_sil_dedge_pmf.pmf()) + dr::width(m_sil_dedge_pmf.cdf());
+    return count * sizeof(ScalarFloat) + dr::width(m_E2E) * sizeof(ScalarUInt32);
+}
+
 MI_IMPLEMENT_TRAVERSE_CB(Mesh, Base)
 MI_INSTANTIATE_CLASS(Mesh)
 NAMESPACE_END(mitsuba)
@@ -17,7 +17,7 @@
 MI_VARIANT class PyFilm : public Film<Float, Spectrum> {
 public:
     MI_IMPORT_TYPES(Film, ImageBlock)
-    NB_TRAMPOLINE(Film, 11);
+    NB_TRAMPOLINE(Film, 12);
 
     PyFilm(const Properties &props) : Film(props) { }
 
@@ -49,6 +49,10 @@ public:
         NB_OVERRIDE_PURE(write, path);
     }
 
+    void write_bitmap(const Bitmap *bitmap, const fs::path &path) const override {
+        NB_OVERRIDE(write_bitmap, bitmap, path);
+    }
+
     void schedule_storage() override {
         NB_OVERRIDE_PURE(schedule_storage);
     }
@@ -97,6 +101,7 @@ MI_PY_EXPORT(Film) {
         .def_method(Film, develop, "raw"_a = false)
         .def_method(Film, bitmap, "raw"_a = false)
         .def_method(Film, write, "path"_a)
+        .def_method(Film, write_bitmap, "bitmap"_a, "path"_a)
         .def_method(Film, sample_border)
         .def_method(Film, base_channels_count)
         // Make sure to return a copy of those members as they might also be
@@ -123,6 +128,17 @@ MI_PY_EXPORT(Film) {
             "spec"_a, "wavelengths"_a, "nChannels"_a,
             "weight"_a = 1.f, "alpha"_a = 1.f, "active"_a = true,
             D(Film, prepare_sample))
+        .def("put_sample",
+            [] (const Film *film, ImageBlock *block, const Point2f &pos,
+                const UnpolarizedSpectrum &spec, const Wavelength &wavelengths,
+                Float weight, Float alpha, Mask active) {
+                std::vector<Float> aovs(block->channel_count(), Float(0.f));
+                film->put_sample(block, pos, spec, wavelengths, aovs.data(),
+                                 weight, alpha, active);
+            },
+            "block"_a, "pos"_a, "spec"_a, "wavelengths"_a,
+            "weight"_a = 1.f, "alpha"_a = 1.f, "active"_a = true,
+            D(Film, put_sample))
         .def_method(Film, create_block, "size"_a = ScalarVector2u(0, 0),
                     "normalize"_a = false, "borders"_a = false)
         .def_method(Film, schedule_storage)
@@ -38,6 +38,16 @@ MI_PY_EXPORT(ImageBlock) {
                      throw std::runtime_error("Incompatible channel count!");
                  ib.put(pos, values.data(), active);
              }, "pos"_a, "values"_a, "active"_a = true)
+        .def("put",
+             [](ImageBlock &ib, const Point2f &pos,
+                const std::vector<Float> &values,
+                const std::vector<UInt32> &channels, Mask active) {
+                 if (values.size() != channels.size())
+                     throw std::runtime_error("Incompatible channel count!");
+                 ib.put(pos, values.data(), channels.data(),
+                        (uint32_t) values.size(), active);
+             }, "pos"_a, "values"_a, "channels"_a, "active"_a = true,
+             D(ImageBlock, put, 3))
         .def("read",
              [](ImageBlock &ib, const Point2f &pos, Mask active) {
                  std::vector<Float> values(ib.channel_count());
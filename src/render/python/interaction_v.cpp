@@ -17,6 +17,7 @@ MI_PY_EXPORT(Interaction) {
         .def_field(Interaction3f, wavelengths, D(Interaction, wavelengths))
         .def_field(Interaction3f, p,           D(Interaction, p))
         .def_field(Interaction3f, n,           D(Interaction, n))
+        .def_field(Interaction3f, p_error,     D(Interaction, p_error))
         // Methods
         .def(nb::init<>(), D(Interaction, Interaction))
         .def(nb::init<const Interaction3f &>(), "Copy constructor")
@@ -30,7 +31,7 @@ MI_PY_EXPORT(Interaction) {
         .def("zero_",        &Interaction3f::zero_, D(Interaction, zero))
         .def_repr(Interaction3f);
 
-    MI_PY_DRJIT_STRUCT(it, Interaction3f, t, time, wavelengths, p, n)
+    MI_PY_DRJIT_STRUCT(it, Interaction3f, t, time, wavelengths, p, n, p_error)
 }
 
 MI_PY_EXPORT(SurfaceInteraction) {
@@ -91,7 +92,7 @@ MI_PY_EXPORT(SurfaceInteraction) {
             D(SurfaceInteraction, has_n_partials))
         .def_repr(SurfaceInteraction3f);
 
-    MI_PY_DRJIT_STRUCT(si, SurfaceInteraction3f, t, time, wavelengths, p, n,
+    MI_PY_DRJIT_STRUCT(si, SurfaceInteraction3f, t, time, wavelengths, p, n, p_error,
                        shape, uv, sh_frame, dp_du, dp_dv, dn_du, dn_dv, duv_dx,
                        duv_dy, wi, prim_index, instance)
 }
@@ -118,7 +119,7 @@ MI_PY_EXPORT(MediumInteraction) {
         .def("to_local", &MediumInteraction3f::to_local, "v"_a, D(MediumInteraction, to_local))
         .def_repr(MediumInteraction3f);
 
-    MI_PY_DRJIT_STRUCT(mi, MediumInteraction3f, t, time, wavelengths, p, n,
+    MI_PY_DRJIT_STRUCT(mi, MediumInteraction3f, t, time, wavelengths, p, n, p_error,
                        medium, sh_frame, wi, sigma_s, sigma_n, sigma_t,
                        combined_extinction, mint)
 }
@@ -7,6 +7,7 @@
 #include <mitsuba/render/scene.h>
 #include <mitsuba/render/sensor.h>
 #include <mitsuba/python/python.h>
+#include <nanobind/stl/map.h>
 #include <nanobind/stl/string.h>
 #include <nanobind/stl/vector.h>
 #include <nanobind/stl/tuple.h>
@@ -158,6 +159,9 @@ MI_PY_EXPORT(Scene) {
              },
              D(Scene, integrator))
         .def_method(Scene, shapes_grad_enabled)
+        .def_method(Scene, memory_budget)
+        .def_method(Scene, memory_report)
+        .def_method(Scene, check_memory_budget, "budget"_a)
         .def("__repr__", &Scene::to_string);
 
     dr::bind_traverse(scene);
@@ -144,6 +144,24 @@ template <typename Ptr, typename Cls> void bind_shape_generic(Cls &cls) {
                 return shape->eval_attribute_x(name, si, active);
             },
             "name"_a, "si"_a, "active"_a = true, D(Shape, eval_attribute_x))
+       .def("eval_attribute_by_id",
+            [](Ptr shape, uint32_t id,
+               const SurfaceInteraction3f &si, const Mask &active) {
+                return shape->eval_attribute_by_id(id, si, active);
+            },
+            "id"_a, "si"_a, "active"_a = true, D(Shape, eval_attribute_by_id))
+       .def("eval_attribute_1_by_id",
+            [](Ptr shape, uint32_t id,
+               const SurfaceInteraction3f &si, const Mask &active) {
+                return shape->eval_attribute_1_by_id(id, si, active);
+            },
+            "id"_a, "si"_a, "active"_a = true, D(Shape, eval_attribute_1_by_id))
+       .def("eval_attribute_3_by_id",
+            [](Ptr shape, uint32_t id,
+               const SurfaceInteraction3f &si, const Mask &active) {
+                return shape->eval_attribute_3_by_id(id, si, active);
+            },
+            "id"_a, "si"_a, "active"_a = true, D(Shape, eval_attribute_3_by_id))
        .def("ray_intersect_preliminary",
             [](Ptr shape, const Ray3f &ray, uint32_t prim_index, const Mask &active) {
                 return shape->ray_intersect_preliminary(ray, prim_index, active);
@@ -332,6 +350,8 @@ MI_PY_EXPORT(Shape) {
         .def("texture_attribute", nb::overload_cast<std::string_view>(
             &Shape::texture_attribute), D(Shape, texture_attribute), "name"_a)
         .def_method(Shape, remove_attribute, "name"_a)
+        .def_static("attribute_id", &Shape::attribute_id, "name"_a, D(Shape, attribute_id))
+        .def_static("attribute_name", &Shape::attribute_name, "id"_a, D(Shape, attribute_name))
         .def_method(Shape, is_mesh)
         .def_method(Shape, parameters_grad_enabled)
         .def_method(Shape, set_bsdf, "bsdf"_a)
@@ -83,6 +83,10 @@ public:
         NB_OVERRIDE(is_spatially_varying);
     }
 
+    bool is_constant() const override {
+        NB_OVERRIDE(is_constant);
+    }
+
     std::string to_string() const override {
         NB_OVERRIDE(to_string);
     }
@@ -150,7 +154,10 @@ template <typename Ptr, typename Cls> void bind_texture_generic(Cls &cls) {
              D(Texture, max))
         .def("is_spatially_varying",
              [](Ptr texture) { return texture->is_spatially_varying(); },
-             D(Texture, is_spatially_varying));
+             D(Texture, is_spatially_varying))
+        .def("is_constant",
+             [](Ptr texture) { return texture->is_constant(); },
+             D(Texture, is_constant));
 }
 
 MI_PY_EXPORT(Texture) {
@@ -1,3 +1,6 @@
+#include <sstream>
+#include <unordered_set>
+
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/render/bsdf.h>
@@ -5,6 +8,8 @@
 #include <mitsuba/render/mesh.h>
 #include <mitsuba/render/scene.h>
 #include <mitsuba/render/integrator.h>
+#include <mitsuba/render/srgb.h>
+#include <mitsuba/render/texture.h>
 
 #if defined(MI_ENABLE_EMBREE)
 #  include "scene_embree.inl"
@@ -23,6 +28,34 @@ MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props)
     : JitObject<Scene>(props.id()) {
     m_thread_reordering = props.get<bool>("allow_thread_reordering", true);
 
+    std::string numa_policy(props.get<std::string_view>("numa_policy", "none"));
+    if (numa_policy == "none")
+        m_numa_policy = util::NumaPolicy::None;
+    else if (numa_policy == "interleave")
+        m_numa_policy = util::NumaPolicy::Interleave;
+    else if (numa_policy == "replicate")
+        m_numa_policy = util::NumaPolicy::Replicate;
+    else
+        Throw("Invalid \"numa_policy\" value \"%s\", must be one of: "
+              "\"none\", \"interleave\", or \"replicate\"!", numa_policy);
+
+    std::string huge_pages(props.get<std::string_view>("huge_pages", "none"));
+    if (huge_pages == "none")
+        m_huge_pages = util::HugePages::None;
+    else if (huge_pages == "transparent")
+        m_huge_pages = util::HugePages::Transparent;
+    else if (huge_pages == "explicit")
+        m_huge_pages = util::HugePages::Explicit;
+    else
+        Throw("Invalid \"huge_pages\" value \"%s\", must be one of: "
+              "\"none\", \"transparent\", or \"explicit\"!", huge_pages);
+
+    // Soft limit on the scene storage (in MiB), checked once it is loaded
+    double memory_budget = props.get<double>("memory_budget", 0.0);
+    if (memory_budget < 0.0)
+        Throw("\"memory_budget\" must be non-negative!");
+    m_memory_budget = (size_t) (memory_budget * 1024.0 * 1024.0);
+
     for (auto &prop : props.objects()) {
         ref<Object> v = prop.get<ref<Object>>();
 
@@ -73,6 +106,9 @@ MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props)
     for (Sensor *sensor: m_sensors)
         sensor->set_scene(this);
 
+    if (props.get<bool>("coalesce_bsdfs", false))
+        coalesce_bsdfs();
+
     // Mark backend-specific properties as queried
     props.mark_queried("embree_use_robust_intersections");
     props.mark_queried("kd_intersection_cost");
@@ -84,12 +120,18 @@ MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props)
     props.mark_queried("kd_clip");
     props.mark_queried("kd_retract_bad_splits");
     props.mark_queried("kd_exact_primitive_threshold");
+    props.mark_queried("kd_parallel_nlogn_threshold");
+    props.mark_queried("kd_occluder_cache");
+    props.mark_queried("kd_any_hit_larger_first");
 
     if constexpr (dr::is_cuda_v<Float>)
         accel_init_gpu(props);
     else
         accel_init_cpu(props);
 
+    if (m_huge_pages != util::HugePages::None)
+        apply_huge_pages();
+
     if (!m_emitters.empty()) {
         // Inform environment emitters etc. about the scene bounds
         for (Emitter *emitter: m_emitters)
@@ -111,6 +153,9 @@ MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props)
     update_silhouette_sampling_distribution();
 
     m_shapes_grad_enabled = false;
+
+    if (m_memory_budget > 0)
+        check_memory_budget(m_memory_budget);
 }
 
 MI_VARIANT
@@ -140,6 +185,314 @@ void Scene<Float, Spectrum>::update_emitter_sampling_distribution() {
         e->set_dirty(false);
 }
 
+/**
+ * Texture that looks up a constant value per shape, indexed by the shape's JIT
+ * registry ID. Used by the BSDF that \ref Scene::coalesce_bsdfs() creates.
+ */
+template <typename Float, typename Spectrum>
+class ShapeTableTexture final : public Texture<Float, Spectrum> {
+public:
+    MI_IMPORT_TYPES(Texture)
+
+    ShapeTableTexture(const UnpolarizedSpectrum &values, ScalarFloat max_value)
+        : Texture(Properties()), m_values(values), m_max(max_value) { }
+
+    void traverse(TraversalCallback *cb) override {
+        cb->put("values", m_values, ParamFlags::Differentiable);
+    }
+
+    void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override {
+        dr::make_opaque(m_values);
+    }
+
+    UnpolarizedSpectrum eval(const SurfaceInteraction3f &si,
+                             Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        UInt32 index = dr::reinterpret_array<UInt32>(si.shape);
+        UnpolarizedSpectrum result;
+        for (size_t i = 0; i < dr::size_v<UnpolarizedSpectrum>; ++i)
+            result[i] = dr::gather<Float>(m_values[i], index, active);
+        return result;
+    }
+
+    Float eval_1(const SurfaceInteraction3f &si, Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+        return dr::mean(eval(si, active));
+    }
+
+    // Only used for diagnostics: unused table entries are included
+    Float mean() const override { return dr::mean(dr::mean(m_values)); }
+
+    ScalarFloat max() const override { return m_max; }
+
+    bool is_spatially_varying() const override { return true; }
+
+    std::string to_string() const override {
+        return tfm::format("ShapeTableTexture[size=%zu]",
+                           dr::width(m_values));
+    }
+
+    MI_DECLARE_CLASS(ShapeTableTexture)
+private:
+    UnpolarizedSpectrum m_values;
+    ScalarFloat m_max;
+
+    MI_TRAVERSE_CB(Texture, m_values)
+};
+
+/// Return the child object \c name that \c object exposes via traverse()
+static Object *traverse_child(Object *object, std::string_view name) {
+    struct ChildCallback : TraversalCallback {
+        std::string_view name;
+        Object *result = nullptr;
+
+        ChildCallback(std::string_view name) : name(name) { }
+
+        void put_value(std::string_view, void *, uint32_t,
+                       const std::type_info &) override { }
+
+        void put_object(std::string_view key, Object *obj, uint32_t) override {
+            if (key == name)
+                result = obj;
+        }
+    };
+
+    ChildCallback cb(name);
+    object->traverse(&cb);
+    return cb.result;
+}
+
+MI_VARIANT void Scene<Float, Spectrum>::coalesce_bsdfs() {
+    if constexpr (dr::is_jit_v<Float>) {
+        using Texture = mitsuba::Texture<Float, Spectrum>;
+
+        /* Collect the top-level shapes with a diffuse BSDF of constant
+           reflectance. Instances are skipped, since intersections report
+           the shapes within their shape group. */
+        std::vector<std::pair<Shape *, Texture *>> candidates;
+        std::unordered_set<BSDF *> bsdfs;
+        uint32_t max_id = 0;
+
+        for (Shape *shape : m_shapes) {
+            BSDF *bsdf = shape->bsdf();
+            if (!bsdf || shape->is_instance() ||
+                bsdf->class_name() != "SmoothDiffuse")
+                continue;
+
+            Texture *reflectance =
+                dynamic_cast<Texture *>(traverse_child(bsdf, "reflectance"));
+            if (!reflectance || !reflectance->is_constant())
+                continue;
+
+            candidates.emplace_back(shape, reflectance);
+            bsdfs.insert(bsdf);
+            max_id = std::max(max_id, jit_registry_id(shape));
+        }
+
+        if (bsdfs.size() < 2)
+            return;
+
+        // Gather the reflectances into a table (SoA layout)
+        UnpolarizedSpectrum values = dr::zeros<UnpolarizedSpectrum>(max_id + 1);
+        SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
+        ScalarFloat max_value = 0.f;
+
+        for (auto [shape, reflectance] : candidates) {
+            UnpolarizedSpectrum value = reflectance->eval(si);
+            UInt32 index = jit_registry_id(shape);
+            for (size_t i = 0; i < dr::size_v<UnpolarizedSpectrum>; ++i)
+                dr::scatter(values[i], value[i], index);
+            max_value = dr::maximum(max_value, reflectance->max());
+        }
+        dr::make_opaque(values);
+
+        Properties props("diffuse");
+        props.set("reflectance", ref<Texture>(
+            new ShapeTableTexture<Float, Spectrum>(values, max_value)));
+        ref<BSDF> bsdf = PluginManager::instance()->create_object<BSDF>(props);
+
+        for (auto &candidate : candidates)
+            candidate.first->set_bsdf(bsdf.get());
+
+        Log(Debug, "Scene: coalesced %zu diffuse BSDFs of %zu shapes.",
+            bsdfs.size(), candidates.size());
+    }
+}
+
+/**
+ * Invoke \c func(ptr, size) for the host storage of the arrays that \c objects
+ * (and their descendants) expose via their traverse() methods. This covers
+ * mesh buffers, textures and volumes. Only meaningful in non-JIT variants.
+ */
+template <typename Float, typename Spectrum, typename Func>
+static void for_each_host_buffer(const std::vector<ref<Object>> &objects,
+                                 Func &&func) {
+    MI_IMPORT_TYPES()
+
+    struct BufferCallback : TraversalCallback {
+        Func &func;
+        std::unordered_set<Object *> visited;
+
+        BufferCallback(Func &func) : func(func) { }
+
+        void put_value(std::string_view, void *value, uint32_t,
+                       const std::type_info &type) override {
+            if (type == typeid(DynamicBuffer<Float>)) {
+                auto &v = *(DynamicBuffer<Float> *) value;
+                func(v.data(), v.size() * sizeof(ScalarFloat));
+            } else if (type == typeid(DynamicBuffer<UInt32>)) {
+                auto &v = *(DynamicBuffer<UInt32> *) value;
+                func(v.data(), v.size() * sizeof(ScalarUInt32));
+            } else if (type == typeid(TensorXf)) {
+                auto &v = *(TensorXf *) value;
+                func(v.array().data(), v.array().size() * sizeof(ScalarFloat));
+            }
+        }
+
+        void put_object(std::string_view, Object *obj, uint32_t) override {
+            if (obj && visited.insert(obj).second)
+                obj->traverse(this);
+        }
+    };
+
+    BufferCallback cb(func);
+    for (auto &object : objects)
+        cb.put_object("", object.get(), 0);
+}
+
+MI_VARIANT void Scene<Float, Spectrum>::apply_huge_pages() {
+    if constexpr (!dr::is_jit_v<Float>) {
+        /* These buffers were allocated by Dr.Jit, so they cannot be remapped.
+           Request transparent huge pages for them instead, which the kernel
+           applies to the 2 MiB-aligned interior of each (large) buffer. */
+        size_t bytes = 0;
+        for_each_host_buffer<Float, Spectrum>(
+            m_children, [&](const void *ptr, size_t size) {
+                if (util::advise_huge_pages(ptr, size))
+                    bytes += size;
+            });
+
+        Log(Debug, "Scene: requested huge pages for %s of scene data.",
+            util::mem_string(bytes));
+    }
+}
+
+/**
+ * Invoke \c func(object, type, bytes) for \c objects and their descendants.
+ * Here, \c bytes is the storage of the arrays that the object exposes via
+ * traverse() plus its private storage (Object::memory_usage()), and \c type
+ * is the type of the object or of its closest ancestor with a known type.
+ */
+template <typename Float, typename Spectrum, typename Func>
+static void for_each_object_storage(const std::vector<ref<Object>> &objects,
+                                    Func &&func) {
+    MI_IMPORT_TYPES()
+
+    struct StorageCallback : TraversalCallback {
+        Func &func;
+        std::unordered_set<Object *> visited;
+        ObjectType type = ObjectType::Unknown;
+        size_t bytes = 0;
+
+        StorageCallback(Func &func) : func(func) { }
+
+        void put_value(std::string_view, void *value, uint32_t,
+                       const std::type_info &type) override {
+            if (type == typeid(DynamicBuffer<Float>))
+                bytes += dr::width(*(DynamicBuffer<Float> *) value) * sizeof(ScalarFloat);
+            else if (type == typeid(DynamicBuffer<UInt32>))
+                bytes += dr::width(*(DynamicBuffer<UInt32> *) value) * sizeof(ScalarUInt32);
+            else if (type == typeid(TensorXf))
+                bytes += dr::width(((TensorXf *) value)->array()) * sizeof(ScalarFloat);
+        }
+
+        void put_object(std::string_view, Object *obj, uint32_t) override {
+            if (!obj || !visited.insert(obj).second)
+                return;
+
+            ObjectType parent_type = type;
+            size_t parent_bytes = bytes;
+
+            if (obj->type() != ObjectType::Unknown)
+                type = obj->type();
+            bytes = obj->memory_usage();
+            obj->traverse(this);
+            func(obj, type, bytes);
+
+            type = parent_type;
+            bytes = parent_bytes;
+        }
+    };
+
+    StorageCallback cb(func);
+    for (auto &object : objects)
+        cb.put_object("", object.get(), 0);
+}
+
+/// Name of the memory report category of objects of the given type
+static const char *memory_category(ObjectType type) {
+    switch (type) {
+        case ObjectType::Shape:         return "shapes";
+        case ObjectType::Texture:       return "textures";
+        case ObjectType::Volume:        return "volumes";
+        case ObjectType::BSDF:          return "bsdfs";
+        case ObjectType::Emitter:       return "emitters";
+        case ObjectType::Medium:        return "media";
+        case ObjectType::PhaseFunction: return "media";
+        case ObjectType::Sensor:        return "sensors";
+        case ObjectType::Film:          return "film";
+        case ObjectType::Integrator:    return "integrator";
+        default:                        return "other";
+    }
+}
+
+MI_VARIANT std::map<std::string, size_t>
+Scene<Float, Spectrum>::memory_report() const {
+    std::map<std::string, size_t> report;
+
+    size_t accel_bytes = dr::is_cuda_v<Float> ? accel_memory_usage_gpu()
+                                              : accel_memory_usage_cpu();
+    for (auto &shapegroup : m_shapegroups)
+        accel_bytes += shapegroup->accel_memory_usage();
+    if (accel_bytes)
+        report["acceleration"] = accel_bytes;
+
+    // traverse() is non-const, but the callback only inspects the objects
+    for_each_object_storage<Float, Spectrum>(
+        m_children, [&](const Object *, ObjectType type, size_t bytes) {
+            if (bytes)
+                report[memory_category(type)] += bytes;
+        });
+
+    if (size_t bytes = srgb_model_memory_usage(); bytes)
+        report["spectral_tables"] = bytes;
+
+    return report;
+}
+
+MI_VARIANT void Scene<Float, Spectrum>::check_memory_budget(size_t budget) const {
+    std::map<std::string, size_t> report = memory_report();
+
+    size_t total = 0;
+    for (auto &[name, bytes] : report)
+        total += bytes;
+
+    if (total <= budget) {
+        Log(Debug, "Scene: %s of storage (budget: %s).",
+            util::mem_string(total), util::mem_string(budget));
+        return;
+    }
+
+    std::ostringstream oss;
+    for (auto &[name, bytes] : report)
+        oss << "  " << name << ": " << util::mem_string(bytes) << std::endl;
+
+    Throw("The scene requires %s of storage, which exceeds the memory budget "
+          "of %s:\n%s", util::mem_string(total), util::mem_string(budget),
+          oss.str());
+}
+
 MI_VARIANT
 void Scene<Float, Spectrum>::update_silhouette_sampling_distribution() {
     size_t n_shapes = m_shapes.size();
@@ -622,6 +975,9 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_gpu() {
 MI_VARIANT void Scene<Float, Spectrum>::accel_release_gpu() {
     NotImplementedError("accel_release_gpu");
 }
+MI_VARIANT size_t Scene<Float, Spectrum>::accel_memory_usage_gpu() const {
+    NotImplementedError("accel_memory_usage_gpu");
+}
 MI_VARIANT typename Scene<Float, Spectrum>::PreliminaryIntersection3f
 Scene<Float, Spectrum>::ray_intersect_preliminary_gpu(const Ray3f &, bool, UInt32, uint32_t, Mask) const {
     NotImplementedError("ray_intersect_preliminary_gpu");
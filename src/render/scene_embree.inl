@@ -1,5 +1,6 @@
 #include <embree3/rtcore.h>
 #include <nanothread/nanothread.h>
+#include <atomic>
 #include <thread>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -24,6 +25,14 @@ static void embree_error_callback(void * /*user_ptr */, RTCError code, const cha
     Log(Warn, "Embree device error %i: %s.", (int) code, str);
 }
 
+/// Storage currently allocated by the Embree device (shared by all scenes)
+static std::atomic<int64_t> embree_memory { 0 };
+
+static bool embree_memory_monitor(void * /* user_ptr */, ssize_t bytes, bool /* post */) {
+    embree_memory += (int64_t) bytes;
+    return true;
+}
+
 /// Wraps rtcOccluded16 when Dr.Jit operates on vectors of length 32
 void rtcOccluded32(const int *valid, RTCScene scene,
                    RTCIntersectContext *context, uint32_t *in) {
@@ -97,6 +106,7 @@ Scene<Float, Spectrum>::accel_init_cpu(const Properties &props) {
             "threads=%i,user_threads=%i", embree_threads, embree_threads);
         embree_device = rtcNewDevice(config_str.c_str());
         rtcSetDeviceErrorFunction(embree_device, embree_error_callback, nullptr);
+        rtcSetDeviceMemoryMonitorFunction(embree_device, embree_memory_monitor, nullptr);
     }
 
     Timer timer;
@@ -228,6 +238,12 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu() {
     clear_shapes_dirty();
 }
 
+MI_VARIANT size_t Scene<Float, Spectrum>::accel_memory_usage_cpu() const {
+    /* Embree only reports the allocations of the whole device, which includes
+       the acceleration data structures of all other scenes and shape groups */
+    return (size_t) std::max(embree_memory.load(), (int64_t) 0);
+}
+
 MI_VARIANT void Scene<Float, Spectrum>::accel_release_cpu() {
     if constexpr (dr::is_llvm_v<Float>) {
         // Ensure all ray tracing kernels are terminated before releasing the scene
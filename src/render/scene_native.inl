@@ -7,10 +7,16 @@ struct NativeState {
     DynamicBuffer<UInt32> shapes_registry_ids;
     void *func_ptr = nullptr;
     UInt64 func_handle;
+    void *shadow_func_ptr = nullptr;
+    UInt64 shadow_func_handle;
 };
 
 MI_VARIANT void Scene<Float, Spectrum>::accel_init_cpu(const Properties &props) {
     ShapeKDTree *kdtree = new ShapeKDTree(props);
+    /* Only the kd-tree owns its pages. Mesh buffers, textures and volumes
+       are heap allocations of Dr.Jit and keep their first-touch placement */
+    kdtree->set_numa_policy(m_numa_policy);
+    kdtree->set_huge_pages(m_huge_pages);
     kdtree->inc_ref();
 
     if constexpr (dr::is_llvm_v<Float>) {
@@ -93,12 +99,24 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu() {
         // Since the LLVM vector width should not change over the lifetime of
         // the scene, we determine the intersection function here.
         int jit_width  = jit_llvm_vector_width();
-        void *func_ptr = nullptr;
+        void *func_ptr = nullptr, *shadow_func_ptr = nullptr;
         switch (jit_width) {
-            case 1:  func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, false, 1>; break;
-            case 4:  func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, false, 4>; break;
-            case 8:  func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, false, 8>; break;
-            case 16: func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, false, 16>; break;
+            case 1:
+                func_ptr        = (void *) kdtree_trace_func_wrapper<Float, Spectrum, false, 1>;
+                shadow_func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, true, 1>;
+                break;
+            case 4:
+                func_ptr        = (void *) kdtree_trace_func_wrapper<Float, Spectrum, false, 4>;
+                shadow_func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, true, 4>;
+                break;
+            case 8:
+                func_ptr        = (void *) kdtree_trace_func_wrapper<Float, Spectrum, false, 8>;
+                shadow_func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, true, 8>;
+                break;
+            case 16:
+                func_ptr        = (void *) kdtree_trace_func_wrapper<Float, Spectrum, false, 16>;
+                shadow_func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, true, 16>;
+                break;
             default:
                 Throw("ray_intersect_preliminary_cpu(): Dr.Jit is "
                       "configured for vectors of width %u, which is not "
@@ -107,11 +125,26 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu() {
 
         s.func_ptr    = func_ptr;
         s.func_handle = UInt64::map_(func_ptr, 1, false);
+
+        /* Shadow rays use a dedicated entry point so that they benefit from
+           early termination, the occluder cache and the any-hit order */
+        s.shadow_func_ptr    = shadow_func_ptr;
+        s.shadow_func_handle = UInt64::map_(shadow_func_ptr, 1, false);
     }
 
     clear_shapes_dirty();
 }
 
+MI_VARIANT size_t Scene<Float, Spectrum>::accel_memory_usage_cpu() const {
+    ShapeKDTree *kdtree;
+    if constexpr (dr::is_llvm_v<Float>)
+        kdtree = ((NativeState<Float, Spectrum> *) m_accel)->accel;
+    else
+        kdtree = (ShapeKDTree *) m_accel;
+
+    return kdtree ? kdtree->memory_usage() : 0;
+}
+
 MI_VARIANT void Scene<Float, Spectrum>::accel_release_cpu() {
     if constexpr (dr::is_llvm_v<Float>) {
         // Ensure all ray tracing kernels are terminated before releasing the scene
@@ -287,11 +320,11 @@ Scene<Float, Spectrum>::ray_test_cpu(const Ray3f &ray,
         return kdtree->template ray_intersect_preliminary<true>(ray, active).is_valid();
     } else {
         NativeState<Float, Spectrum> &s = *(NativeState<Float, Spectrum> *) m_accel;
-        void *func_ptr = s.func_ptr,
+        void *func_ptr = s.shadow_func_ptr,
              *scene_ptr = m_accel;
 
         UInt64 func_v = UInt64::steal(
-                   jit_var_pointer(JitBackend::LLVM, func_ptr, s.func_handle.index(), 0)),
+                   jit_var_pointer(JitBackend::LLVM, func_ptr, s.shadow_func_handle.index(), 0)),
                scene_v = UInt64::steal(
                    jit_var_pointer(JitBackend::LLVM, scene_ptr, m_accel_handle.index(), 0));
 
@@ -335,6 +368,7 @@ MI_VARIANT void Scene<Float, Spectrum>::traverse_1_cb_ro_cpu(
             *(NativeState<Float, Spectrum> *) m_accel;
         drjit ::traverse_1_fn_ro(s.shapes_registry_ids, payload, fn);
         drjit ::traverse_1_fn_ro(s.func_handle, payload, fn);
+        drjit ::traverse_1_fn_ro(s.shadow_func_handle, payload, fn);
     }
 }
 
@@ -346,6 +380,7 @@ MI_VARIANT void Scene<Float, Spectrum>::traverse_1_cb_rw_cpu(
             *(NativeState<Float, Spectrum> *) m_accel;
         drjit ::traverse_1_fn_rw(s.shapes_registry_ids, payload, fn);
         drjit ::traverse_1_fn_rw(s.func_handle, payload, fn);
+        drjit ::traverse_1_fn_rw(s.shadow_func_handle, payload, fn);
     }
 }
 
@@ -25,6 +25,7 @@ struct MiOptixSceneState {
     struct InstanceData {
         void* buffer = nullptr;  // Device-visible storage for IAS
         void* inputs = nullptr;  // Device-visible storage for OptixInstance array
+        size_t size = 0;         // Total size of both buffers
     } ias_data;
     uint32_t sbt_jit_index;
 
@@ -518,6 +519,7 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_gpu() {
             ));
 
             jit_free(d_temp_buffer);
+            s.ias_data.size = ias_data_size + buffer_sizes.outputSizeInBytes;
         }
 
         /* Set up a callback on the handle variable to release the OptiX scene
@@ -549,6 +551,15 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_gpu() {
     }
 }
 
+MI_VARIANT size_t Scene<Float, Spectrum>::accel_memory_usage_gpu() const {
+    if constexpr (dr::is_cuda_v<Float>) {
+        const MiOptixSceneState &s = *(const MiOptixSceneState *) m_accel;
+        return s.accel.memory_usage() + s.ias_data.size;
+    } else {
+        return 0;
+    }
+}
+
 MI_VARIANT void Scene<Float, Spectrum>::accel_release_gpu() {
     if constexpr (dr::is_cuda_v<Float>) {
         Log(Debug, "Scene GPU acceleration release ..");
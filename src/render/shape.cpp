@@ -5,6 +5,7 @@
 #include <mitsuba/render/sensor.h>
 #include <mitsuba/render/medium.h>
 #include <mitsuba/core/plugin.h>
+#include <mutex>
 
 #if defined(MI_ENABLE_EMBREE)
 #  include <embree3/rtcore.h>
@@ -18,6 +19,12 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
+/// Process-wide registry of interned attribute names (see Shape::attribute_id())
+static std::mutex attribute_registry_lock;
+static tsl::robin_map<std::string, uint32_t, std::hash<std::string_view>,
+                      std::equal_to<>> attribute_registry_ids;
+static std::vector<std::unique_ptr<std::string>> attribute_registry_names;
+
 MI_VARIANT Shape<Float, Spectrum>::Shape(const Properties &props)
     : JitObject<Shape>(props.id()) {
     m_to_world =
@@ -435,7 +442,8 @@ std::tuple<typename Shape<Float, Spectrum>::ScalarFloat,
            typename Shape<Float, Spectrum>::ScalarPoint2f,
            typename Shape<Float, Spectrum>::ScalarUInt32,
            typename Shape<Float, Spectrum>::ScalarUInt32>
-Shape<Float, Spectrum>::ray_intersect_preliminary_scalar(const ScalarRay3f & /*ray*/) const {
+Shape<Float, Spectrum>::ray_intersect_preliminary_scalar(const ScalarRay3f & /*ray*/,
+                                                         ScalarIndex /*prim_index*/) const {
     NotImplementedError("ray_intersect_preliminary_scalar");
 }
 
@@ -467,7 +475,8 @@ Shape<Float, Spectrum>::ray_test(const Ray3f &ray, uint32_t prim_index, Mask act
 }
 
 MI_VARIANT
-bool Shape<Float, Spectrum>::ray_test_scalar(const ScalarRay3f & /*ray*/) const {
+bool Shape<Float, Spectrum>::ray_test_scalar(const ScalarRay3f & /*ray*/,
+                                             ScalarIndex /*prim_index*/) const {
     NotImplementedError("ray_intersect_test_scalar");
 }
 
@@ -581,6 +590,46 @@ Shape<Float, Spectrum>::eval_attribute_x(std::string_view /*name*/,
         NotImplementedError("eval_attribute_x");
 }
 
+MI_VARIANT uint32_t Shape<Float, Spectrum>::attribute_id(std::string_view name) {
+    std::lock_guard<std::mutex> guard(attribute_registry_lock);
+    auto it = attribute_registry_ids.find(name);
+    if (it != attribute_registry_ids.end())
+        return it->second;
+
+    uint32_t id = (uint32_t) attribute_registry_names.size();
+    attribute_registry_names.push_back(std::make_unique<std::string>(name));
+    attribute_registry_ids.insert({ std::string(name), id });
+    return id;
+}
+
+MI_VARIANT const std::string &Shape<Float, Spectrum>::attribute_name(uint32_t id) {
+    std::lock_guard<std::mutex> guard(attribute_registry_lock);
+    if (id >= attribute_registry_names.size())
+        Throw("attribute_name(): invalid attribute handle %u.", id);
+    return *attribute_registry_names[id];
+}
+
+MI_VARIANT typename Shape<Float, Spectrum>::UnpolarizedSpectrum
+Shape<Float, Spectrum>::eval_attribute_by_id(uint32_t id,
+                                             const SurfaceInteraction3f &si,
+                                             Mask active) const {
+    return eval_attribute(attribute_name(id), si, active);
+}
+
+MI_VARIANT Float
+Shape<Float, Spectrum>::eval_attribute_1_by_id(uint32_t id,
+                                               const SurfaceInteraction3f &si,
+                                               Mask active) const {
+    return eval_attribute_1(attribute_name(id), si, active);
+}
+
+MI_VARIANT typename Shape<Float, Spectrum>::Color3f
+Shape<Float, Spectrum>::eval_attribute_3_by_id(uint32_t id,
+                                               const SurfaceInteraction3f &si,
+                                               Mask active) const {
+    return eval_attribute_3(attribute_name(id), si, active);
+}
+
 MI_VARIANT Float Shape<Float, Spectrum>::surface_area() const {
     NotImplementedError("surface_area");
 }
@@ -153,6 +153,20 @@ ShapeGroup<Float, Spectrum>::primitive_count() const {
     return count;
 }
 
+MI_VARIANT size_t ShapeGroup<Float, Spectrum>::accel_memory_usage() const {
+#if defined(MI_ENABLE_CUDA)
+    if constexpr (dr::is_cuda_v<Float>)
+        return m_accel.memory_usage();
+#endif
+
+#if !defined(MI_ENABLE_EMBREE)
+    if constexpr (!dr::is_cuda_v<Float>)
+        return m_kdtree->memory_usage();
+#endif
+
+    return 0;
+}
+
 #if defined(MI_ENABLE_CUDA)
 MI_VARIANT void ShapeGroup<Float, Spectrum>::optix_prepare_ias(
     const OptixDeviceContext &context, std::vector<OptixInstance> &instances,
@@ -231,13 +245,15 @@ std::tuple<typename ShapeGroup<Float, Spectrum>::ScalarFloat,
            typename ShapeGroup<Float, Spectrum>::ScalarPoint2f,
            typename ShapeGroup<Float, Spectrum>::ScalarUInt32,
            typename ShapeGroup<Float, Spectrum>::ScalarUInt32>
-ShapeGroup<Float, Spectrum>::ray_intersect_preliminary_scalar(const ScalarRay3f &ray) const {
+ShapeGroup<Float, Spectrum>::ray_intersect_preliminary_scalar(const ScalarRay3f &ray,
+                                                              ScalarIndex /*prim_index*/) const {
     auto pi = m_kdtree->template ray_intersect_scalar<false>(ray);
     return { pi.t, pi.prim_uv, pi.shape_index, pi.prim_index };
 }
 
 MI_VARIANT
-bool ShapeGroup<Float, Spectrum>::ray_test_scalar(const ScalarRay3f &ray) const {
+bool ShapeGroup<Float, Spectrum>::ray_test_scalar(const ScalarRay3f &ray,
+                                                  ScalarIndex /*prim_index*/) const {
     return m_kdtree->template ray_intersect_scalar<true>(ray).is_valid();
 }
 #endif
@@ -34,6 +34,16 @@ dr::Array<float, 3> srgb_model_fetch(const Color<float, 3> &c) {
     return Array3f(out[0], out[1], out[2]);
 }
 
+size_t srgb_model_memory_usage() {
+    std::lock_guard<std::mutex> lock(model_mutex);
+    if (model == nullptr)
+        return 0;
+
+    // Scale table + 3 coefficients per entry of 3 tables of size res^3
+    size_t res = model->res;
+    return (res + 3 * 3 * res * res * res) * sizeof(float);
+}
+
 #if 0
 Color<float, 3> srgb_model_eval_rgb(const dr::Array<float, 3> &coeff) {
     using Array3f = dr::Array<float, 3>;
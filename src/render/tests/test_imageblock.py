@@ -257,3 +257,42 @@ def test06_error_compensation(variants_any_cuda, compensate):
         print(2**24 + 1024)
         print(2**24)
         assert ib.tensor().array[0] ==  2**24 + (1024 if compensate else 0)
+
+
+@pytest.mark.parametrize("filter_name", ['gaussian', 'box'])
+@pytest.mark.parametrize("coalesce", [ False, True ])
+@pytest.mark.parametrize("symbolic", [ False, True ])
+def test07_put_channels(variants_all, filter_name, coalesce, symbolic):
+    # Splatting a subset of channels must match a full put() with zeros
+    # in the remaining channels
+    scalar = 'scalar' in mi.variant()
+    if symbolic and scalar:
+        pytest.skip('symbolic loops only exist in JIT modes')
+
+    rfilter = mi.load_dict({ 'type' : filter_name })
+    pos = mi.Point2f(3.3, 2.8)
+
+    def make_block():
+        return mi.ImageBlock(size=[6, 6], offset=[1, 2], channel_count=6,
+                             rfilter=rfilter, coalesce=coalesce)
+
+    with dr.scoped_set_flag(dr.JitFlag.SymbolicLoops, symbolic):
+        # Channel 1 receives two values, channels 0, 2 and 5 none
+        block = make_block()
+        block.put(pos=pos, values=[1, 2, 3, 4], channels=[3, 1, 4, 1])
+
+        ref = make_block()
+        ref.put(pos=pos, values=[0, 2 + 4, 0, 1, 3, 0])
+        assert dr.allclose(block.tensor(), ref.tensor())
+
+        if not scalar:
+            # The receiving channel may differ between lanes
+            pos = mi.Point2f([3.3, 4.1], [2.8, 5.5])
+            block = make_block()
+            block.put(pos=pos, values=[mi.Float(1, 2)],
+                      channels=[mi.UInt32(2, 5)])
+
+            ref = make_block()
+            ref.put(pos=pos, values=[0, 0, mi.Float(1, 0), 0, 0,
+                                     mi.Float(0, 2)])
+            assert dr.allclose(block.tensor(), ref.tensor())
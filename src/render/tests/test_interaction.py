@@ -163,3 +163,102 @@ def test05_gather_interaction(variants_any_llvm):
     assert(dr.width(si_.shape) == 2)
     assert(dr.allclose(si_.t[0], si.t[0]))
     assert(dr.allclose(si_.t[1], si.t[2]))
+
+
+@pytest.mark.parametrize('case', ['axis_aligned', 'tilted', 'sliver'])
+def test06_spawn_ray_error_bound(variants_all_rgb, case):
+    # Count rays spawned from mesh hits that re-intersect the (planar) mesh,
+    # with and without the error bound of the hit position. The outgoing
+    # directions include grazing ones on both sides of the surface.
+    import numpy as np
+    rng = np.random.default_rng(seed=0)
+    double = 'double' in mi.variant()
+    n_samples = 256
+
+    if case == 'axis_aligned':
+        v = np.array([[0, 0, 0], [1, 0, 0], [0, 1, 0]], dtype=np.float64)
+        offset = 1e4
+    elif case == 'tilted':
+        v = np.array([[0, 0, 0], [1, 0.2, 0.7], [-0.3, 1, 0.4]])
+        offset = 1e4
+    else:
+        # Roughly 12 units long and 1e-3 units wide
+        v = np.array([[0, 0, 0], [10, 3, 6], [10, 3.001, 5.9995]])
+        offset = 1e3
+    v += offset
+
+    mesh = mi.Mesh("MyMesh", 3, 1)
+    params = mi.traverse(mesh)
+    params['vertex_positions'] = type(params['vertex_positions'])(v.ravel().tolist())
+    params['faces'] = type(params['faces'])([0, 1, 2])
+    params.update()
+    scene = mi.load_dict({'type': 'scene', 'mesh': mesh})
+
+    # Random points on the triangle and a tangent frame
+    e1, e2 = v[1] - v[0], v[2] - v[0]
+    n = np.cross(e1, e2)
+    n /= np.linalg.norm(n)
+    s = e1 / np.linalg.norm(e1)
+    t = np.cross(n, s)
+
+    b = rng.random((n_samples, 2))
+    flip = b.sum(axis=1) > 1
+    b[flip] = 1 - b[flip]
+    p = v[0] + b[:, :1] * e1 + b[:, 1:] * e2
+
+    def hemisphere(cos_theta, sign):
+        phi = rng.random(n_samples) * 2 * np.pi
+        sin_theta = np.sqrt(1 - cos_theta**2)
+        return (sign * cos_theta[:, None] * n +
+                (sin_theta * np.cos(phi))[:, None] * s +
+                (sin_theta * np.sin(phi))[:, None] * t)
+
+    w_in = hemisphere(rng.uniform(0.1, 1, n_samples), 1)
+    w_out = [hemisphere(np.logspace(-3, 0, n_samples), sign)
+             for sign in (1, -1)]
+
+    def batches(*arrays):
+        # One wavefront in JIT variants, one ray at a time in scalar variants
+        if 'scalar' in mi.variant():
+            for i in range(n_samples):
+                yield [a[i].tolist() for a in arrays]
+        else:
+            yield [[mi.Float(a[:, k].tolist()) for k in range(3)] for a in arrays]
+
+    def count(mask):
+        return int(mask) if isinstance(mask, bool) else int(dr.count(mask))
+
+    hits, n_valid = { 'bound': 0, 'eps': 0 }, 0
+    for w in w_out:
+        for o, d_in, d_out in batches(p + w_in, -w_in, w):
+            # Rays close to the edge of the sliver may miss it, skip those
+            si = scene.ray_intersect(mi.Ray3f(mi.Point3f(*o), mi.Vector3f(*d_in)))
+            valid = si.is_valid()
+            n_valid += count(valid)
+            if double:
+                assert dr.all(dr.select(valid, si.p_error, 1) > 0)
+            else:
+                assert dr.all(si.p_error == 0)
+
+            si_eps = mi.SurfaceInteraction3f(si)
+            si_eps.p_error = mi.Float(0)
+
+            d_out = mi.Vector3f(*d_out)
+            for key, it in (('bound', si), ('eps', si_eps)):
+                hits[key] += count(valid & scene.ray_test(it.spawn_ray(d_out)))
+                hits[key] += count(valid & scene.ray_test(
+                    it.spawn_ray_to(it.p + 100 * d_out)))
+
+    n_bound, n_eps = hits['bound'], hits['eps']
+    assert n_valid > 0.9 * 2 * n_samples
+
+    # The offset never drops below the epsilon-based one
+    assert n_bound <= n_eps, \
+        f'{n_bound} (error bound) vs. {n_eps} (epsilon) self-intersections'
+
+    # Sliver triangles in double precision variants are not guaranteed to be
+    # free of self-intersections, since the single precision backends do not
+    # reject hits within their own error bound
+    if not (double and case == 'sliver'):
+        assert n_bound == 0, \
+            f'{n_bound} self-intersections out of {2 * n_valid} rays'
@@ -113,3 +113,196 @@ def test02_depth_scalar_bunny(variant_scalar_rgb):
             res_shadow = scene.ray_test(r)
             assert dr.all(res_shadow == res_naive.is_valid())
             compare_results(res_naive, res)
+
+
+@pytest.mark.parametrize("occluder_cache", [False, True])
+@pytest.mark.parametrize("larger_first", [False, True])
+def test03_shadow_rays_any_hit(variant_scalar_rgb, occluder_cache, larger_first):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    n_steps = 20
+    props = mi.Properties("scene")
+    props["_unnamed_0"] = create_stairs(n_steps)
+    props["kd_occluder_cache"] = occluder_cache
+    props["kd_any_hit_larger_first"] = larger_first
+    scene = mi.Scene(props)
+
+    # Consecutive rays alternate between occluded and unoccluded segments to
+    # ensure that a stale cache entry never produces a false positive
+    n = 64
+    inv_n = 1.0 / (n - 1)
+    for x in range(n):
+        for y in range(n):
+            o = [x * inv_n, y * inv_n, 2]
+            d = [0, 0, -1]
+            r = mi.Ray3f(o, d, 0.5, [])
+            r.maxt = 100 if (x + y) % 2 == 0 else 0.5
+
+            res_naive = scene.ray_intersect_naive(r)
+            assert dr.all(scene.ray_test(r) == res_naive.is_valid())
+
+
+@pytest.mark.parametrize("numa_policy", ["none", "interleave", "replicate"])
+@pytest.mark.parametrize("huge_pages", ["none", "transparent", "explicit"])
+def test04_memory_placement(variant_scalar_rgb, numa_policy, huge_pages):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    props = mi.Properties("scene")
+    props["_unnamed_0"] = create_stairs(20)
+    props["numa_policy"] = numa_policy
+    props["huge_pages"] = huge_pages
+    scene = mi.Scene(props)
+
+    # The placement policy must never change the traversal results
+    n = 16
+    inv_n = 1.0 / (n - 1)
+    for x in range(n):
+        for y in range(n):
+            r = mi.Ray3f([x * inv_n, y * inv_n, 2], [0, 0, -1], 0.5, [])
+            res_naive = scene.ray_intersect_naive(r)
+            res = scene.ray_intersect(r)
+            assert dr.all(res.is_valid() == res_naive.is_valid())
+            if res_naive.is_valid():
+                assert dr.allclose(res.t, res_naive.t)
+            assert dr.all(scene.ray_test(r) == res_naive.is_valid())
+
+
+@pytest.mark.parametrize("name", ["numa_policy", "huge_pages"])
+def test05_memory_placement_invalid(variant_scalar_rgb, name):
+    props = mi.Properties("scene")
+    props[name] = "scatter"
+    with pytest.raises(RuntimeError, match=name):
+        mi.Scene(props)
+
+
+@fresolver_append_path
+@pytest.mark.parametrize("parallel_threshold", [0, 8])
+def test06_parallel_nlogn_build(variant_scalar_rgb, parallel_threshold):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    # Build the entire tree with the O(n log n) method
+    scene = mi.load_dict({
+        'type': 'scene',
+        'kd_exact_primitive_threshold': 1 << 30,
+        'kd_parallel_nlogn_threshold': parallel_threshold,
+        'shape': {
+            "type" : "ply",
+            "filename" : "resources/data/common/meshes/bunny_lowres.ply",
+        }
+    })
+    b = scene.bbox()
+
+    n = 64
+    inv_n = 1.0 / (n - 1)
+    for x in range(n):
+        for y in range(n):
+            o = [b.min[0] * (1 - x * inv_n) + b.max[0] * x * inv_n,
+                 b.min[1] * (1 - y * inv_n) + b.max[1] * y * inv_n,
+                 b.min[2]]
+            r = mi.Ray3f(o, [0, 0, 1], 0.5, [])
+            r.maxt = 100
+
+            res_naive = scene.ray_intersect_naive(r)
+            compare_results(res_naive, scene.ray_intersect(r))
+            assert dr.all(scene.ray_test(r) == res_naive.is_valid())
+
+
+def test07_reduced_precision_build_double(variant_scalar_rgb_double):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    # Step heights and planar faces that are not representable in single
+    # precision. Events are rounded outwards during the build, which must not
+    # cause any intersections to be missed.
+    props = mi.Properties("scene")
+    props["_unnamed_0"] = create_stairs(37)
+    props["kd_exact_primitive_threshold"] = 1 << 30
+    scene = mi.Scene(props)
+
+    n = 64
+    inv_n = 1.0 / (n - 1)
+    for x in range(n):
+        for y in range(n):
+            o = [x * inv_n, y * inv_n, 2]
+            r = mi.Ray3f(o, [0, 0, -1], 0.5, [])
+            r.maxt = 100
+
+            res_naive = scene.ray_intersect_naive(r)
+            compare_results(res_naive, scene.ray_intersect(r))
+            assert dr.all(scene.ray_test(r) == res_naive.is_valid())
+
+
+def test08_occluder_cache_instances(variant_scalar_rgb):
+    # The kd-trees of shape groups are traversed while the top-level tree is
+    # active, the occluder caches of both trees must not interfere
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    T = mi.ScalarTransform4f
+
+    def make_scene(cache):
+        return mi.load_dict({
+            'type': 'scene',
+            'kd_occluder_cache': cache,
+            'group': {
+                'type': 'shapegroup',
+                'kd_occluder_cache': cache,
+                'stairs': create_stairs(10)
+            },
+            'instance_0': {
+                'type': 'instance',
+                'shapegroup': { 'type': 'ref', 'id': 'group' }
+            },
+            'instance_1': {
+                'type': 'instance',
+                'to_world': T().translate([1, 0, 0]),
+                'shapegroup': { 'type': 'ref', 'id': 'group' }
+            },
+            # Covers x in [0, 1] and y in [1, 2]
+            'rectangle': {
+                'type': 'rectangle',
+                'to_world': T().translate([0.5, 1.5, 0.5]).scale(0.5)
+            }
+        })
+
+    scene, scene_ref = make_scene(True), make_scene(False)
+
+    # Consecutive rays alternate between instanced, top-level and no
+    # occluders as well as between short and long segments
+    n = 32
+    for x in range(n):
+        for y in range(n):
+            o = [2 * (x + 0.5) / n, 2 * (y + 0.5) / n, 2]
+            r = mi.Ray3f(o, [0, 0, -1])
+            r.maxt = 100 if (x + y) % 2 == 0 else 1.3
+            assert scene.ray_test(r) == scene_ref.ray_test(r)
+
+
+@pytest.mark.parametrize("clip", [False, True])
+def test09_parallel_nlogn_partition(variant_scalar_rgb, clip):
+    # The top nodes have enough edge events to be classified and partitioned
+    # by several threads
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    scene = mi.load_dict({
+        'type': 'scene',
+        'kd_exact_primitive_threshold': 1 << 30,
+        'kd_parallel_nlogn_threshold': 64,
+        'kd_clip': clip,
+        'stairs': create_stairs(1000)
+    })
+
+    n = 32
+    for x in range(n):
+        for y in range(n):
+            o = [(x + 0.5) / n, (y + 0.5) / n - 0.5, 2]
+            r = mi.Ray3f(o, dr.normalize(mi.ScalarVector3f(0, 0.5, -1)))
+            r.maxt = 100
+
+            res_naive = scene.ray_intersect_naive(r)
+            compare_results(res_naive, scene.ray_intersect(r))
+            assert dr.all(scene.ray_test(r) == res_naive.is_valid())
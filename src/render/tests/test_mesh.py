@@ -1467,3 +1467,37 @@ def test39_custom_vertex_normals(variants_vec_rgb):
 
     # The custom vertex normals should not have been modified.
     assert dr.allclose(params['vertex_normals'], normals)
+
+
+def test40_attribute_handles(variant_scalar_rgb):
+    m = mi.Mesh("MyMesh", 3, 1)
+
+    params = mi.traverse(m)
+    params['vertex_positions'] = [0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0]
+    params['faces'] = [0, 1, 2]
+    params.update()
+
+    m.add_attribute("vertex_color", 3, [1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0])
+    m.add_attribute("face_weight", 1, [0.25])
+
+    # Handles are stable and map back to the attribute name
+    color_id = mi.Shape.attribute_id("vertex_color")
+    assert mi.Shape.attribute_id("vertex_color") == color_id
+    assert mi.Shape.attribute_name(color_id) == "vertex_color"
+    weight_id = mi.Shape.attribute_id("face_weight")
+    assert weight_id != color_id
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    si.prim_index = 0
+    si.p = [0.2, 0.3, 0.0]
+
+    assert dr.allclose(m.eval_attribute_3_by_id(color_id, si),
+                       m.eval_attribute_3("vertex_color", si))
+    assert dr.allclose(m.eval_attribute_by_id(color_id, si),
+                       m.eval_attribute("vertex_color", si))
+    assert dr.allclose(m.eval_attribute_1_by_id(weight_id, si), 0.25)
+
+    # Removing the attribute also invalidates its handle on this mesh
+    m.remove_attribute("face_weight")
+    with pytest.raises(RuntimeError, match='face_weight'):
+        m.eval_attribute_1_by_id(weight_id, si)
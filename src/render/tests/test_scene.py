@@ -365,3 +365,74 @@ def test13_mitsuba_object_multiple_python_repr(variants_vec_rgb):
     assert type(box_as_mesh) == mi.Mesh
     assert type(box_as_shape) == mi.Shape
 
+
+
+def test14_memory_report(variants_all_rgb):
+    def create_scene(**kwargs):
+        return mi.load_dict({
+            'type': 'scene',
+            'cube': {'type': 'cube'},
+            'sensor': {
+                'type': 'perspective',
+                'to_world': mi.ScalarTransform4f().look_at(
+                    origin=(0, 0, 5), target=(0, 0, 0), up=(0, 1, 0)),
+                'film': {'type': 'hdrfilm', 'width': 16, 'height': 8},
+            },
+            **kwargs
+        })
+
+    scene = create_scene()
+    assert scene.memory_budget() == 0
+
+    report = scene.memory_report()
+    assert report['shapes'] > 0
+    assert 'textures' not in report
+
+    # The film storage (RGBAW) is estimated before the first render
+    film_bytes = report['film']
+    assert film_bytes % (16 * 8 * 5) == 0
+    mi.render(scene, spp=1)
+    assert scene.memory_report()['film'] == film_bytes
+
+    total = sum(report.values())
+    scene.check_memory_budget(total)
+    with pytest.raises(RuntimeError, match='memory budget'):
+        scene.check_memory_budget(total - 1)
+
+    # Budget (in MiB) specified as a scene property
+    assert create_scene(memory_budget=64.0).memory_budget() == 64 * 1024 * 1024
+    with pytest.raises(RuntimeError, match=r'shapes: .*'):
+        create_scene(memory_budget=1e-6)
+
+
+def test15_coalesce_bsdfs(variants_vec_backends_once_rgb):
+    colors = [[0.1, 0.2, 0.3], [0.4, 0.5, 0.6], [0.7, 0.8, 0.9]]
+
+    def create_scene(**kwargs):
+        scene = {'type': 'scene', **kwargs}
+        for i, color in enumerate(colors):
+            scene[f'rect_{i}'] = {
+                'type': 'rectangle',
+                'to_world': mi.ScalarTransform4f().translate([3 * i, 0, 0]),
+                'bsdf': {'type': 'diffuse',
+                         'reflectance': {'type': 'rgb', 'value': color}}
+            }
+        return mi.load_dict(scene)
+
+    # One ray per rectangle
+    ray = mi.Ray3f(mi.Point3f([0, 3, 6], 0, 1), mi.Vector3f(0, 0, -1))
+
+    for coalesce in [False, True]:
+        scene = create_scene(coalesce_bsdfs=coalesce)
+        bsdfs = [shape.bsdf() for shape in scene.shapes()]
+        assert all((bsdf is bsdfs[0]) == coalesce for bsdf in bsdfs[1:])
+
+        si = scene.ray_intersect(ray)
+        assert dr.all(si.is_valid())
+        value = si.bsdf().eval_diffuse_reflectance(si)
+        assert dr.allclose(value, mi.Color3f(*[[c[k] for c in colors]
+                                              for k in range(3)]))
+
+    # The reflectances are exposed as a single table
+    params = mi.traverse(create_scene(coalesce_bsdfs=True))
+    assert sum(key.endswith('bsdf.reflectance.values') for key in params.keys()) == 1
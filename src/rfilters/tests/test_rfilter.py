@@ -1,4 +1,5 @@
 import pytest
+import numpy as np
 import drjit as dr
 from drjit.scalar import ArrayXf as Float
 import mitsuba as mi
@@ -121,3 +122,24 @@ def test09_resampler_filter_only(variant_scalar_rgb):
     assert dr.allclose(b[0], (G(0) * a[0] + G(1) * (a[1] + a[2])) / (G(0) + 2*G(1)), atol=1e-4)
     assert dr.allclose(b[1], (G(0) * a[1] + G(1) * (a[0] + a[2])) / (G(0) + 2*G(1)), atol=1e-4)
     assert dr.allclose(b[2], (G(0) * a[2] + G(1) * (a[0] + a[1])) / (G(0) + 2*G(1)), atol=1e-4)
+
+
+@pytest.mark.parametrize('bc', ['Clamp', 'Zero', 'One', 'Repeat', 'Mirror'])
+def test10_resampler_rows(variant_scalar_rgb, np_rng, bc):
+    # Resampling whole rows must match resampling each column separately
+    f = mi.load_dict({'type': 'lanczos'})
+    rows, cols = 7, 5
+    a = np_rng.random((rows, cols)).astype(np.float32)
+
+    for target_res in [rows, 3, 12]:
+        resampler = mi.Resampler(f, rows, target_res)
+        resampler.set_boundary_condition(getattr(mi.FilterBoundaryCondition, bc))
+
+        b = np.zeros((target_res, cols), dtype=np.float32)
+        resampler.resample_rows(a.ravel(), b.ravel(), cols)
+
+        for c in range(cols):
+            col = np.ascontiguousarray(a[:, c])
+            ref = np.zeros(target_res, dtype=np.float32)
+            resampler.resample(col, 1, ref, 1, 1)
+            assert np.allclose(b[:, c], ref, atol=1e-6)
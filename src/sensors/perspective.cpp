@@ -2,6 +2,7 @@
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/bbox.h>
+#include <mitsuba/core/animation.h>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -21,6 +22,17 @@ Perspective pinhole camera (:monosp:`perspective`)
      (Default: none (i.e. camera space = world space))
    - |exposed|, |differentiable|, |discontinuous|
 
+ * - to_world_0, to_world_1, ...
+   - |transform|
+   - Optional keyframes of a camera-to-world transformation that changes over
+     the shutter interval (see :monosp:`time_0`, ...). Cannot be combined with
+     :monosp:`to_world`.
+
+ * - time_0, time_1, ...
+   - |float|
+   - Times associated with the keyframes :monosp:`to_world_0`, ... Must be
+     strictly increasing. (Default: keyframes evenly spaced over [0, 1])
+
  * - fov
    - |float|
    - Denotes the camera's field of view in degrees---must be between 0 and 180,
@@ -141,6 +153,15 @@ public:
         ScalarVector2i size = m_film->size();
         m_x_fov = (ScalarFloat) parse_fov(props, size.x() / (double) size.y());
 
+        m_motion = AnimatedTransform<Float>::from_properties(props);
+        if (m_motion.animated()) {
+            for (size_t i = 0; i < m_motion.size(); ++i) {
+                if (m_motion.keyframe(i).transform.has_scale())
+                    Throw("Scale factors in the camera-to-world transformation are not allowed!");
+            }
+            m_to_world = m_motion.keyframe(0).transform;
+        }
+
         if (m_to_world.scalar().has_scale())
             Throw("Scale factors in the camera-to-world transformation are not allowed!");
 
@@ -166,6 +187,10 @@ public:
             if (m_to_world.scalar().has_scale())
                 Throw("Scale factors in the camera-to-world transformation are not allowed!");
             m_to_world = m_to_world.value().update();
+            /* An explicit update of the transformation replaces the
+               animation. Empty keys, as sent by parent objects, keep it */
+            if (string::contains(keys, "to_world"))
+                m_motion = AnimatedTransform<Float>(m_to_world.scalar());
         }
 
         update_camera_transforms();
@@ -197,6 +222,13 @@ public:
                         m_image_rect, m_normalization, m_principal_point_offset);
     }
 
+    /// Camera-to-world transformation at the given time
+    AffineTransform4f to_world(const Float &time) const {
+        if (m_motion.animated())
+            return m_motion.eval(time);
+        return m_to_world.value();
+    }
+
     std::pair<Ray3f, Spectrum> sample_ray(Float time, Float wavelength_sample,
                                           const Point2f &position_sample,
                                           const Point2f & /*aperture_sample*/,
@@ -223,8 +255,9 @@ public:
         // Convert into a normalized ray direction; adjust the ray interval accordingly.
         Vector3f d = dr::normalize(Vector3f(near_p));
 
-        ray.o = m_to_world.value().translation();
-        ray.d = m_to_world.value() * d;
+        AffineTransform4f trafo = to_world(time);
+        ray.o = trafo.translation();
+        ray.d = trafo * d;
 
         Float inv_z = dr::rcp(d.z());
         Float near_t = m_near_clip * inv_z,
@@ -260,8 +293,9 @@ public:
         // Convert into a normalized ray direction; adjust the ray interval accordingly.
         Vector3f d = dr::normalize(Vector3f(near_p));
 
-        ray.o = m_to_world.value().translation();
-        ray.d = m_to_world.value() * d;
+        AffineTransform4f trafo = to_world(time);
+        ray.o = trafo.translation();
+        ray.d = trafo * d;
 
         Float inv_z = dr::rcp(d.z());
         Float near_t = m_near_clip * inv_z,
@@ -271,8 +305,8 @@ public:
 
         ray.o_x = ray.o_y = ray.o;
 
-        ray.d_x = m_to_world.value() * dr::normalize(Vector3f(near_p) + m_dx);
-        ray.d_y = m_to_world.value() * dr::normalize(Vector3f(near_p) + m_dy);
+        ray.d_x = trafo * dr::normalize(Vector3f(near_p) + m_dx);
+        ray.d_y = trafo * dr::normalize(Vector3f(near_p) + m_dy);
         ray.has_differentials = true;
 
         return { ray, wav_weight };
@@ -286,7 +320,7 @@ public:
     sample_direction(const Interaction3f &it, const Point2f & /*sample*/,
                      Mask active) const override {
         // Transform the reference point into the local coordinate system
-        AffineTransform4f trafo = m_to_world.value();
+        AffineTransform4f trafo = to_world(it.time);
         Point3f ref_p     = trafo.inverse() * it.p;
 
         // Check if it is outside of the clip range
@@ -324,6 +358,8 @@ public:
     }
 
     ScalarBoundingBox3f bbox() const override {
+        if (m_motion.animated())
+            return m_motion.transform_bbox(ScalarBoundingBox3f(ScalarPoint3f(0.f)));
         ScalarPoint3f p = m_to_world.scalar() * ScalarPoint3f(0.f);
         return ScalarBoundingBox3f(p, p);
     }
@@ -401,8 +437,10 @@ public:
             << "  resolution = " << m_resolution << "," << std::endl
             << "  shutter_open = " << m_shutter_open << "," << std::endl
             << "  shutter_open_time = " << m_shutter_open_time << "," << std::endl
-            << "  to_world = " << indent(m_to_world, 13) << std::endl
-            << "]";
+            << "  to_world = " << indent(m_to_world, 13);
+        if (m_motion.animated())
+            oss << "," << std::endl << "  motion = " << indent(m_motion);
+        oss << std::endl << "]";
         return oss.str();
     }
 
@@ -414,6 +452,7 @@ private:
     Float m_x_fov;
     Vector3f m_dx, m_dy;
     Vector2f m_principal_point_offset;
+    AnimatedTransform<Float> m_motion;
 
     MI_TRAVERSE_CB(Base, m_sample_to_camera, m_image_rect,
                    m_normalization, m_x_fov, m_dx, m_dy,
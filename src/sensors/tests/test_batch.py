@@ -104,3 +104,21 @@ def test02_sample_ray(variants_vec_spectral, s_open, s_time):
     dr.scatter(direction, mi.Vector3f(directions[0]), mi.UInt32([0, 1]))
     dr.scatter(direction, mi.Vector3f(directions[1]), mi.UInt32([2]))
     assert dr.allclose(ray.d, direction, atol=1e-7)
+
+
+def test03_keyframed_child(variant_scalar_rgb):
+    # Resizing the child films must not discard the motion of a child sensor
+    animated = mi.load_dict({
+        "type": "perspective",
+        "to_world_0": mi.ScalarTransform4f().look_at(
+            origin=[0, 0, 0], target=[0, 0, 1], up=[0, 1, 0]),
+        "to_world_1": mi.ScalarTransform4f().look_at(
+            origin=[1, 0, 0], target=[1, 0, 1], up=[0, 1, 0]),
+        "film": {"type": "hdrfilm", "width": 256, "height": 256}
+    })
+    static = create_perspective(origins[1], directions[1])
+    camera = create_batch([animated, static], s_open=0, s_close=1)
+
+    for time in [0.0, 0.5, 1.0]:
+        ray, _ = camera.sample_ray(time, 0, [0.25, 0.5], 0)
+        assert dr.allclose(ray.o, [time, 0, 0], atol=1e-5)
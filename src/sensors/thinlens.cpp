@@ -209,7 +209,8 @@ public:
         m_normalization = 1.f / m_image_rect.volume();
 
         dr::make_opaque(m_sample_to_camera, m_dx, m_dy,
-                        m_x_fov, m_image_rect, m_normalization);
+                        m_x_fov, m_image_rect, m_normalization,
+                        m_aperture_radius, m_focus_distance);
     }
 
     ProjectiveTransform4f projection_transform() const override {
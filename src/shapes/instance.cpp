@@ -3,6 +3,7 @@
 #include <mitsuba/render/fwd.h>
 #include <mitsuba/render/shape.h>
 #include <mitsuba/core/transform.h>
+#include <mitsuba/core/animation.h>
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/shapegroup.h>
@@ -31,6 +32,18 @@ Instance (:monosp:`instance`)
    - Specifies a linear object-to-world transformation. (Default: none (i.e. object space = world space))
    - |exposed|, |differentiable|, |discontinuous|
 
+ * - to_world_0, to_world_1, ...
+   - |transform|
+   - Optional keyframes of an object-to-world transformation that changes
+     over time. The instance then moves according to the time associated with
+     each ray (transformation motion blur). Cannot be combined with
+     :monosp:`to_world`.
+
+ * - time_0, time_1, ...
+   - |float|
+   - Times associated with the keyframes :monosp:`to_world_0`, ... Must be
+     strictly increasing. (Default: keyframes evenly spaced over [0, 1])
+
 This plugin implements a geometry instance used to efficiently replicate geometry many times. For
 details on how to create instances, refer to the :ref:`shape-shapegroup` plugin.
 
@@ -41,12 +54,19 @@ details on how to create instances, refer to the :ref:`shape-shapegroup` plugin.
     The Stanford bunny loaded a single time and instantiated 1365 times (equivalent to 100 million
     triangles)
 
+Between two keyframes, the scale, rotation and translation components of the
+transformation are interpolated separately. The acceleration data structure
+bounds the instance over its whole motion, hence fast moving instances can
+reduce the ray tracing performance.
+
 .. warning::
 
     - Note that it is not possible to assign a different material to each instance — the material
       assignment specified within the shape group is the one that matters.
     - Shape groups cannot be used to replicate shapes with attached emitters, sensors, or
       subsurface scattering models.
+    - Keyframed instances are not supported in CUDA variants. When Embree is used, keyframe
+      times must lie within [0, 1].
 
  */
 
@@ -76,6 +96,13 @@ public:
 
         m_shape_type = ShapeType::Instance;
 
+        m_motion = AnimatedTransform<Float>::from_properties(props);
+        if (m_motion.animated()) {
+            if constexpr (dr::is_cuda_v<Float>)
+                Throw("Keyframed instances are not supported in CUDA variants!");
+            m_to_world = m_motion.keyframe(0).transform;
+        }
+
         dr::make_opaque(m_to_world);
     }
 
@@ -86,6 +113,10 @@ public:
     void parameters_changed(const std::vector<std::string> &keys) override {
         if (keys.empty() || string::contains(keys, "to_world")) {
             m_to_world = m_to_world.value().update();
+            /* An explicit update of the transformation replaces the
+               animation. Empty keys, as sent by parent objects, keep it */
+            if (string::contains(keys, "to_world"))
+                m_motion = AnimatedTransform<Float>(m_to_world.scalar());
             mark_dirty();
         }
         Base::parameters_changed();
@@ -98,6 +129,9 @@ public:
         if (!bbox.valid())
             return bbox;
 
+        if (m_motion.animated())
+            return m_motion.transform_bbox(bbox);
+
         ScalarBoundingBox3f result;
         for (int i = 0; i < 8; ++i)
             result.expand(m_to_world.scalar() * bbox.corner(i));
@@ -125,7 +159,8 @@ public:
                                    dr::mask_t<FloatP> active) const {
         MI_MASK_ARGUMENT(active);
         if constexpr (!dr::is_array_v<FloatP>) {
-            return m_shapegroup->ray_intersect_preliminary_scalar(m_to_world.scalar().inverse() * ray);
+            return m_shapegroup->ray_intersect_preliminary_scalar(
+                to_world_scalar(ray.time).inverse() * ray, 0);
         } else {
             Throw("Instance::ray_intersect_preliminary() should only be called with scalar types.");
         }
@@ -138,7 +173,8 @@ public:
         MI_MASK_ARGUMENT(active);
 
         if constexpr (!dr::is_array_v<FloatP>) {
-            return m_shapegroup->ray_test_scalar(m_to_world.scalar().inverse() * ray);
+            return m_shapegroup->ray_test_scalar(
+                to_world_scalar(ray.time).inverse() * ray, 0);
         } else {
             Throw("Instance::ray_test_impl() should only be called with scalar types.");
         }
@@ -153,7 +189,9 @@ public:
                                                      Mask active) const override {
         MI_MASK_ARGUMENT(active);
 
-        const AffineTransform4f& to_world  = m_to_world.value();
+        AffineTransform4f to_world = m_motion.animated()
+                                         ? m_motion.eval(ray.time)
+                                         : m_to_world.value();
         AffineTransform4f to_object = to_world.inverse();
 
         constexpr bool IsDiff = dr::is_diff_v<Float>;
@@ -188,6 +226,26 @@ public:
                 recursion_depth, active);
         }
 
+        /* Carry the position error bound through the transformation: the
+           linear part scales it by at most its largest absolute row sum, and
+           the product itself adds rounding error (PBRT, Section 6.8.6) */
+        if constexpr (std::is_same_v<ScalarFloat, double>) {
+            Float row_max = 0.f, p_max = 0.f;
+            for (size_t i = 0; i < 3; ++i) {
+                Float row = dr::abs(to_world.matrix(i, 0)) +
+                            dr::abs(to_world.matrix(i, 1)) +
+                            dr::abs(to_world.matrix(i, 2));
+                row_max = dr::maximum(row_max, row);
+                p_max = dr::maximum(p_max, dr::fmadd(row, dr::max(dr::abs(si.p)),
+                                                     dr::abs(to_world.matrix(i, 3))));
+            }
+            Float gamma = math::error_gamma(3, math::TraceEpsilon<Float>);
+            si.p_error = dr::detach(dr::select(
+                si.p_error > 0.f,
+                dr::fmadd(si.p_error, row_max * (1.f + gamma), gamma * p_max),
+                0.f));
+        }
+
         // Hit point `si.p` is only attached to the surface motion
         si.p = to_world * si.p;
         si.n = dr::normalize(dr::detach(to_world) * si.n);
@@ -249,8 +307,10 @@ public:
         std::ostringstream oss;
             oss << "Instance[" << std::endl
                 << "  shapegroup = " << string::indent(m_shapegroup) << std::endl
-                << "  to_world = " << string::indent(m_to_world, 13) << "," << std::endl
-                << "]";
+                << "  to_world = " << string::indent(m_to_world, 13) << "," << std::endl;
+            if (m_motion.animated())
+                oss << "  motion = " << string::indent(m_motion) << "," << std::endl;
+            oss << "]";
         return oss.str();
     }
 
@@ -259,9 +319,29 @@ public:
         DRJIT_MARK_USED(device);
         if constexpr (!dr::is_cuda_v<Float>) {
             RTCGeometry instance = m_shapegroup->embree_geometry(device);
-            rtcSetGeometryTimeStepCount(instance, 1);
-            dr::Matrix<ScalarFloat32, 4> matrix(dr::transpose(m_to_world.scalar().matrix));
-            rtcSetGeometryTransform(instance, 0, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR, matrix.data());
+            if (!m_motion.animated()) {
+                rtcSetGeometryTimeStepCount(instance, 1);
+                dr::Matrix<ScalarFloat32, 4> matrix(dr::transpose(m_to_world.scalar().matrix));
+                rtcSetGeometryTransform(instance, 0, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR, matrix.data());
+            } else {
+                /* Embree interpolates linearly between uniformly spaced time
+                   steps over the shutter interval [0, 1]. Resample the
+                   animation densely enough to approximate the rotations. */
+                if (m_motion.keyframe(0).time < 0.f ||
+                    m_motion.keyframe(m_motion.size() - 1).time > 1.f)
+                    Throw("Keyframe times of instances must lie within [0, 1] "
+                          "when using Embree!");
+                uint32_t steps = (uint32_t) std::min<size_t>(
+                    RTC_MAX_TIME_STEP_COUNT, 16 * (m_motion.size() - 1) + 1);
+                rtcSetGeometryTimeStepCount(instance, steps);
+                for (uint32_t i = 0; i < steps; ++i) {
+                    ScalarAffineTransform4f trafo =
+                        m_motion.eval_scalar((ScalarFloat) i / (ScalarFloat) (steps - 1));
+                    dr::Matrix<ScalarFloat32, 4> matrix(dr::transpose(trafo.matrix));
+                    rtcSetGeometryTransform(instance, i, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR,
+                                            matrix.data());
+                }
+            }
             rtcCommitGeometry(instance);
             return instance;
         } else {
@@ -285,6 +365,13 @@ public:
     virtual void optix_prepare_geometry() override { /* no op */ }
 #endif
 
+    /// Object-to-world transformation at the given (scalar) time
+    ScalarAffineTransform4f to_world_scalar(ScalarFloat time) const {
+        if (m_motion.animated())
+            return m_motion.eval_scalar(time);
+        return m_to_world.scalar();
+    }
+
     bool parameters_grad_enabled() const override {
         return dr::grad_enabled(m_to_world) || m_shapegroup->parameters_grad_enabled();
     }
@@ -292,6 +379,7 @@ public:
     MI_DECLARE_CLASS(Instance)
 private:
    ref<ShapeGroup_> m_shapegroup;
+   AnimatedTransform<Float> m_motion;
 
    MI_TRAVERSE_CB(Base, m_shapegroup)
 };
@@ -0,0 +1,515 @@
+#include <mitsuba/core/fwd.h>
+#include <mitsuba/core/math.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/struct.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/render/fwd.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/shape.h>
+#include <drjit/tensor.h>
+
+#include "ply.h"
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _shape-spheres:
+
+Spheres (:monosp:`spheres`)
+-------------------------------------------------
+
+.. pluginparameters::
+
+ * - filename
+   - |string|
+   - Specifies the PLY file containing the sphere centers (``x``, ``y``, ``z``)
+     and optionally their radii (``radius``) as a ``vertex`` element.
+     This parameter cannot be used if `centers` is provided.
+
+ * - centers
+   - |tensor|
+   - A tensor of shape (N, 3) specifying the sphere centers.
+     This parameter cannot be used if `filename` is provided.
+
+ * - radii
+   - |tensor|
+   - A tensor of shape (N) or (N, 1) specifying the sphere radii. Only
+     used together with `centers`.
+
+ * - radius
+   - |float|
+   - Radius of all spheres that don't specify their own radius. (Default: 1.0)
+
+ * - to_world
+   - |transform|
+   - Specifies an optional linear object-to-world transformation to apply to
+     all spheres when loading them from a PLY file. Radii are scaled by the
+     mean scaling factor of the transformation.
+
+ * - data
+   - |tensor|
+   - Packed sphere data, i.e. the center and radius of each sphere stored as
+     four consecutive values.
+   - |exposed|, |differentiable|, |discontinuous|
+
+This shape plugin describes a large collection of spheres (e.g. a particle
+system) as a single shape. All spheres are stored contiguously in one buffer
+(four floats per sphere), and every sphere is exposed to the acceleration data
+structure as an individual primitive. Compared to instantiating one
+:ref:`sphere <shape-sphere>` shape per particle, this avoids the per-shape
+overheads (plugin instance, transformation, BSDF references) and keeps the
+primitive data that is accessed during traversal tightly packed in memory.
+
+Sampling routines are not implemented, hence this shape cannot be used as an
+area emitter. It is currently not supported in CUDA variants.
+
+.. tabs::
+    .. code-tab:: xml
+        :name: spheres
+
+        <shape type="spheres">
+            <string name="filename" value="particles.ply"/>
+            <float name="radius" value="0.01"/>
+        </shape>
+
+    .. code-tab:: python
+
+        'particles': {
+            'type': 'spheres',
+            'filename': 'particles.ply',
+            'radius': 0.01
+        }
+ */
+
+template <typename Float, typename Spectrum>
+class Spheres final : public Shape<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Shape, m_to_world, m_is_instance, initialize, mark_dirty,
+                   get_children_string)
+    MI_IMPORT_TYPES()
+
+    using typename Base::ScalarSize;
+    using typename Base::ScalarIndex;
+    using FloatStorage  = DynamicBuffer<dr::replace_scalar_t<Float, float>>;
+    using UInt32Storage = DynamicBuffer<UInt32>;
+
+    /// Number of floats per sphere (center and radius)
+    static constexpr uint32_t SphereStructSize = 4u;
+
+    Spheres(const Properties &props) : Base(props) {
+        if constexpr (dr::is_cuda_v<Float>)
+            Throw("The \"spheres\" shape is not supported in CUDA variants!");
+
+        Timer timer;
+        ScalarFloat radius = props.get<ScalarFloat>("radius", 1.f);
+
+        if (props.has_property("filename")) {
+            if (props.has_property("centers"))
+                Throw("Cannot specify both \"centers\" and \"filename\".");
+            if (props.has_property("radii"))
+                Throw("\"radii\" can only be specified together with \"centers\".");
+            load_ply(props, radius);
+        } else if (props.has_property("centers")) {
+            if (props.has_property("to_world"))
+                Throw("\"to_world\" is only supported when loading PLY file!");
+
+            const TensorXf32 &centers = props.get_any<TensorXf32>("centers");
+            if (centers.ndim() != 2 || centers.shape(1) != 3)
+                Throw("TensorXf centers must have shape (N, 3)!");
+
+            size_t count = centers.shape(0);
+            UInt32Storage idx = dr::arange<UInt32Storage>(count);
+
+            m_data = dr::full<FloatStorage>((float) radius, count * SphereStructSize);
+            for (uint32_t i = 0; i < 3; i++)
+                dr::scatter(m_data, dr::gather<FloatStorage>(centers.array(), idx * 3 + i),
+                            idx * SphereStructSize + i);
+
+            if (props.has_property("radii")) {
+                const TensorXf32 &radii = props.get_any<TensorXf32>("radii");
+                if (dr::width(radii.array()) != count ||
+                    (radii.ndim() == 2 && radii.shape(1) != 1) || radii.ndim() > 2)
+                    Throw("TensorXf radii must have shape (N) or (N, 1)!");
+                dr::scatter(m_data, radii.array(), idx * SphereStructSize + 3);
+            }
+        } else {
+            Throw("Must specify either \"filename\" or \"centers\".");
+        }
+
+        dr::eval(m_data);
+        m_data_pointer = m_data.data();
+
+        Log(Debug, "Read %i spheres (%s in %s)", primitive_count(),
+            util::mem_string(primitive_count() * SphereStructSize * sizeof(float)),
+            util::time_string((float) timer.value()));
+
+        recompute_bbox();
+        initialize();
+    }
+
+    void traverse(TraversalCallback *cb) override {
+        Base::traverse(cb);
+        cb->put("data", m_data, ParamFlags::Differentiable | ParamFlags::Discontinuous);
+    }
+
+    void parameters_changed(const std::vector<std::string> &keys) override {
+        if (keys.empty() || string::contains(keys, "data")) {
+            if (dr::width(m_data) % SphereStructSize != 0)
+                Throw("Sphere data must contain %u values per sphere!", SphereStructSize);
+            dr::eval(m_data);
+            m_data_pointer = m_data.data();
+            recompute_bbox();
+            mark_dirty();
+        }
+
+        Base::parameters_changed(keys);
+    }
+
+    ScalarSize primitive_count() const override {
+        return (ScalarSize) (dr::width(m_data) / SphereStructSize);
+    }
+
+    ScalarBoundingBox3f bbox() const override { return m_bbox; }
+
+    ScalarBoundingBox3f bbox(ScalarIndex index) const override {
+        Assert(index < primitive_count());
+        const float *ptr = m_data_pointer + index * SphereStructSize;
+        ScalarPoint3f center(ptr[0], ptr[1], ptr[2]);
+        ScalarFloat radius = ptr[3];
+        return ScalarBoundingBox3f(center - radius, center + radius);
+    }
+
+    ScalarFloat surface_area() const override {
+        ScalarFloat area = 0.f;
+        for (ScalarSize i = 0; i < primitive_count(); ++i)
+            area += 4.f * dr::Pi<ScalarFloat> *
+                    dr::square((ScalarFloat) m_data_pointer[i * SphereStructSize + 3]);
+        return area;
+    }
+
+    // =============================================================
+    //! @{ \name Sampling routines (not implemented!)
+    // =============================================================
+
+    PositionSample3f sample_position(Float, const Point2f &, Mask) const override { return dr::zeros<PositionSample3f>(); }
+
+    Float pdf_position(const PositionSample3f &, Mask) const override { return 0; }
+
+    DirectionSample3f sample_direction(const Interaction3f &, const Point2f &, Mask) const override { return dr::zeros<DirectionSample3f>(); }
+
+    Float pdf_direction(const Interaction3f &, const DirectionSample3f &, Mask) const override { return 0; }
+
+    SurfaceInteraction3f eval_parameterization(const Point2f &, uint32_t, Mask) const override { return dr::zeros<SurfaceInteraction3f>(); }
+
+    //! @}
+    // =============================================================
+
+    // =============================================================
+    //! @{ \name Ray tracing routines
+    // =============================================================
+
+    template <typename FloatP, typename Ray3fP>
+    std::tuple<FloatP, Point<FloatP, 2>, dr::uint32_array_t<FloatP>,
+               dr::uint32_array_t<FloatP>>
+    ray_intersect_preliminary_impl(const Ray3fP &ray,
+                                   ScalarIndex prim_index,
+                                   dr::mask_t<FloatP> active) const {
+        MI_MASK_ARGUMENT(active);
+        using Value = std::conditional_t<dr::is_cuda_v<FloatP> || dr::is_diff_v<Float>,
+                                         dr::float32_array_t<FloatP>,
+                                         dr::float64_array_t<FloatP>>;
+        using Value3 = Vector<Value, 3>;
+
+        auto [center, radius] = sphere<Value>(index_array<FloatP>(prim_index), active);
+
+        Value maxt = Value(ray.maxt);
+
+        // Same plane-based reformulation as in the 'sphere' plugin to improve
+        // the numerical robustness of the quadratic solve
+        Value3 l = ray.o - center;
+        Value3 d(ray.d);
+        Value plane_t = dot(-l, d) / norm(d);
+        Value3 plane_p = ray(FloatP(plane_t));
+
+        Value3 o = plane_p - center;
+
+        Value A = dr::squared_norm(d);
+        Value B = dr::scalar_t<Value>(2.f) * dr::dot(o, d);
+        Value C = dr::squared_norm(o) - dr::square(radius);
+        auto [solution_found, near_t, far_t] = math::solve_quadratic(A, B, C);
+
+        near_t += plane_t;
+        far_t += plane_t;
+
+        // Sphere doesn't intersect with the segment on the ray
+        dr::mask_t<FloatP> out_bounds = !(near_t <= maxt && far_t >= Value(0.0)); // NaN-aware conditionals
+
+        // Sphere fully contains the segment of the ray
+        dr::mask_t<FloatP> in_bounds = near_t < Value(0.0) && far_t > maxt;
+
+        active &= solution_found && !out_bounds && !in_bounds;
+
+        FloatP t = dr::select(near_t < Value(0.0), FloatP(far_t), FloatP(near_t));
+        t = dr::select(active, t, dr::Infinity<FloatP>);
+
+        return { t, dr::zeros<Point<FloatP, 2>>(), ((uint32_t) -1), prim_index };
+    }
+
+    template <typename FloatP, typename Ray3fP>
+    dr::mask_t<FloatP> ray_test_impl(const Ray3fP &ray,
+                                     ScalarIndex prim_index,
+                                     dr::mask_t<FloatP> active) const {
+        MI_MASK_ARGUMENT(active);
+        using Value = std::conditional_t<dr::is_cuda_v<FloatP> || dr::is_diff_v<Float>,
+                                         dr::float32_array_t<FloatP>,
+                                         dr::float64_array_t<FloatP>>;
+        using Value3 = Vector<Value, 3>;
+
+        auto [center, radius] = sphere<Value>(index_array<FloatP>(prim_index), active);
+
+        Value maxt = Value(ray.maxt);
+
+        Value3 o = Value3(ray.o) - center;
+        Value3 d(ray.d);
+
+        Value A = dr::squared_norm(d);
+        Value B = dr::scalar_t<Value>(2.f) * dr::dot(o, d);
+        Value C = dr::squared_norm(o) - dr::square(radius);
+
+        auto [solution_found, near_t, far_t] = math::solve_quadratic(A, B, C);
+
+        // Sphere doesn't intersect with the segment on the ray
+        dr::mask_t<FloatP> out_bounds = !(near_t <= maxt && far_t >= Value(0.0)); // NaN-aware conditionals
+
+        // Sphere fully contains the segment of the ray
+        dr::mask_t<FloatP> in_bounds  = near_t < Value(0.0) && far_t > maxt;
+
+        return solution_found && !out_bounds && !in_bounds && active;
+    }
+
+    MI_SHAPE_DEFINE_RAY_INTERSECT_METHODS()
+
+    SurfaceInteraction3f compute_surface_interaction(const Ray3f &ray,
+                                                     const PreliminaryIntersection3f &pi,
+                                                     uint32_t ray_flags,
+                                                     uint32_t recursion_depth,
+                                                     Mask active) const override {
+        MI_MASK_ARGUMENT(active);
+
+        // Early exit when tracing isn't necessary
+        if (!m_is_instance && recursion_depth > 0)
+            return dr::zeros<SurfaceInteraction3f>();
+
+        bool need_dn_duv  = has_flag(ray_flags, RayFlags::dNSdUV) ||
+                            has_flag(ray_flags, RayFlags::dNGdUV);
+        bool need_dp_duv  = has_flag(ray_flags, RayFlags::dPdUV) || need_dn_duv;
+        bool need_uv      = has_flag(ray_flags, RayFlags::UV) || need_dp_duv;
+        bool detach_shape = has_flag(ray_flags, RayFlags::DetachShape);
+
+        /* If necessary, temporally suspend gradient tracking for all shape
+           parameters to construct a surface interaction completely detach from
+           the shape. */
+        dr::suspend_grad<Float> scope(detach_shape, m_data);
+
+        auto [center, radius] = sphere<Float>(pi.prim_index, active);
+
+        SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
+        si.t = dr::select(active, pi.t, dr::Infinity<Float>);
+        si.sh_frame.n = dr::normalize(ray(pi.t) - center);
+
+        // Re-project onto the sphere to improve accuracy
+        si.p = dr::fmadd(si.sh_frame.n, radius, center);
+        si.n = si.sh_frame.n;
+
+        if (likely(need_uv)) {
+            Vector3f local(si.sh_frame.n);
+            Point2f angles = dir_to_sph(local);
+            Float theta = angles.x();
+            Float phi = angles.y();
+
+            dr::masked(phi, phi < 0.f) += 2.f * dr::Pi<Float>;
+            si.uv = Point2f(phi * dr::InvTwoPi<Float>, theta * dr::InvPi<Float>);
+
+            if (likely(need_dp_duv)) {
+                Float rd      = dr::sqrt(dr::square(local.x()) + dr::square(local.y())),
+                      inv_rd  = dr::rcp(rd),
+                      cos_phi = local.x() * inv_rd,
+                      sin_phi = local.y() * inv_rd;
+
+                si.dp_du = Vector3f(-local.y(), local.x(), 0.f) *
+                           (radius * 2.f * dr::Pi<Float>);
+                si.dp_dv = Vector3f(local.z() * cos_phi, local.z() * sin_phi, -rd) *
+                           (radius * dr::Pi<Float>);
+
+                Mask singularity_mask = active && (rd == 0.f);
+                if (unlikely(dr::any_or<true>(singularity_mask)))
+                    si.dp_dv[singularity_mask] = Vector3f(1.f, 0.f, 0.f);
+            }
+        }
+
+        if (need_dn_duv) {
+            Float inv_radius = dr::rcp(radius);
+            si.dn_du = si.dp_du * inv_radius;
+            si.dn_dv = si.dp_dv * inv_radius;
+        }
+
+        si.prim_index = pi.prim_index;
+        si.shape      = this;
+        si.instance   = nullptr;
+
+        return si;
+    }
+
+    //! @}
+    // =============================================================
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "Spheres[" << std::endl
+            << "  bbox = " << string::indent(m_bbox) << "," << std::endl
+            << "  sphere_count = " << primitive_count() << "," << std::endl
+            << "  " << string::indent(get_children_string()) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS(Spheres)
+
+private:
+    /// Load the sphere centers (and optionally radii) from a PLY file
+    void load_ply(const Properties &props, ScalarFloat radius) {
+        /// Process vertex records in large batches
+        constexpr size_t elements_per_packet = 1024;
+
+        FileResolver *fs = mitsuba::file_resolver();
+        fs::path file_path = fs->resolve(props.get<std::string_view>("filename"));
+        std::string name = file_path.filename().string();
+
+        auto fail = [&](const char *descr) {
+            Throw("Error while loading PLY file \"%s\": %s!", name, descr);
+        };
+
+        Log(Debug, "Loading spheres from \"%s\" ..", name);
+        if (!fs::exists(file_path))
+            fail("file not found");
+
+        ref<Stream> stream = new FileStream(file_path);
+        ScopedPhase phase(ProfilerPhase::LoadGeometry);
+
+        PLYHeader header;
+        try {
+            header = parse_ply_header(stream, name);
+            if (header.ascii) {
+                if (stream->size() > 100 * 1024)
+                    Log(Warn,
+                        "\"%s\": performance warning -- this file uses the ASCII PLY format, which "
+                        "is slow to parse. Consider converting it to the binary PLY format.",
+                        name);
+                stream = parse_ascii((FileStream *) stream.get(), header.elements, name);
+            }
+        } catch (const std::exception &e) {
+            fail(e.what());
+        }
+
+        if (header.elements.empty() || header.elements[0].name != "vertex")
+            fail("the first element must be \"vertex\"");
+        const PLYElement &el = header.elements[0];
+
+        // The converted records directly match the packed sphere layout
+        ref<Struct> sphere_struct = new Struct();
+        for (auto field : { "x", "y", "z" })
+            sphere_struct->append(field, struct_type_v<InputFloat>);
+        sphere_struct->append("radius", struct_type_v<InputFloat>,
+                              +Struct::Flags::Default, radius);
+
+        ref<StructConverter> conv;
+        try {
+            conv = new StructConverter(el.struct_, sphere_struct);
+        } catch (const std::exception &e) {
+            fail(e.what());
+        }
+
+        ScalarAffineTransform4f to_world = m_to_world.scalar();
+        auto [to_world_S, to_world_Q, to_world_T] = transform_decompose(to_world.matrix, 25);
+        float to_world_scale = (float) dr::mean(dr::diag(to_world_S));
+
+        std::unique_ptr<float[]> data(new float[el.count * SphereStructSize]);
+
+        size_t i_struct_size    = el.struct_->size();
+        size_t packet_count     = el.count / elements_per_packet;
+        size_t remainder_count  = el.count % elements_per_packet;
+        std::unique_ptr<uint8_t[]> buf(new uint8_t[i_struct_size * elements_per_packet]);
+
+        float *ptr = data.get();
+        for (size_t i = 0; i <= packet_count; ++i) {
+            size_t count = (i != packet_count) ? elements_per_packet : remainder_count;
+            stream->read(buf.get(), i_struct_size * count);
+            if (unlikely(!conv->convert(count, buf.get(), ptr)))
+                fail("incompatible contents -- is this a point cloud?");
+
+            for (size_t j = 0; j < count; ++j, ptr += SphereStructSize) {
+                ScalarPoint3f p = to_world * ScalarPoint3f(dr::load<dr::Array<float, 3>>(ptr));
+                if (unlikely(!dr::all(dr::isfinite(p))))
+                    fail("file contains invalid sphere center data");
+                dr::store(ptr, dr::Array<float, 3>(p));
+                ptr[3] *= to_world_scale;
+            }
+        }
+
+        m_data = dr::load<FloatStorage>(data.get(), el.count * SphereStructSize);
+    }
+
+    /// Convert a primitive index into the index type used to fetch sphere data
+    template <typename FloatP>
+    auto index_array(ScalarIndex prim_index) const {
+        if constexpr (dr::is_jit_v<FloatP>)
+            return dr::uint32_array_t<FloatP>(prim_index);
+        else
+            return prim_index;
+    }
+
+    /// Fetch the center and radius of the sphere(s) with the given index
+    template <typename Value, typename Index, typename Mask_>
+    std::pair<Point<Value, 3>, Value> sphere(const Index &index,
+                                             const Mask_ &active) const {
+        if constexpr (!dr::is_jit_v<Index>) {
+            DRJIT_MARK_USED(active);
+            auto tmp = dr::load<dr::Array<float, SphereStructSize>>(
+                m_data_pointer + index * SphereStructSize);
+            return { Point<Value, 3>((Value) tmp[0], (Value) tmp[1], (Value) tmp[2]),
+                     (Value) tmp[3] };
+        } else {
+            using Float32 = dr::float32_array_t<Index>;
+            auto tmp = dr::gather<dr::Array<Float32, SphereStructSize>>(
+                m_data, index, dr::mask_t<Index>(active));
+            return { Point<Value, 3>(Value(tmp[0]), Value(tmp[1]), Value(tmp[2])),
+                     Value(tmp[3]) };
+        }
+    }
+
+    /// Recompute the overall bounding box on the host
+    void recompute_bbox() {
+        m_bbox.reset();
+        for (ScalarSize i = 0; i < primitive_count(); ++i)
+            m_bbox.expand(bbox(i));
+    }
+
+private:
+    /// Packed sphere data (center and radius of each sphere)
+    FloatStorage m_data;
+
+    /// Host pointer to the data above (used by the CPU ray tracing kernels)
+    const float *m_data_pointer = nullptr;
+
+    /// The bounding box of the overall shape
+    ScalarBoundingBox3f m_bbox;
+};
+
+MI_EXPORT_PLUGIN(Spheres)
+NAMESPACE_END(mitsuba)
@@ -216,3 +216,45 @@ def test03_ray_intersect_instance(variants_all_rgb, width):
         assert 'instance=0x0' in str(pi)
     else:
         assert ('instance=[' + '0x0, ' * (width - 1) + '0x0]') in str(pi)
+
+
+def test04_keyframed_instance(variant_scalar_rgb):
+    from mitsuba import ScalarTransform4f as T
+
+    scene = mi.load_dict({
+        'type' : 'scene',
+        'group_0' : {
+            'type' : 'shapegroup',
+            'shape' : { 'type' : 'rectangle' }
+        },
+        'instance' : {
+            'type' : 'instance',
+            'group' : { 'type' : 'ref', 'id' : 'group_0' },
+            'to_world_0' : T().translate([0, 0, 0]),
+            'to_world_1' : T().translate([3, 0, 0]),
+        }
+    })
+
+    # The bounding box covers the whole motion
+    bbox = scene.bbox()
+    assert dr.allclose(bbox.min.x, -1) and dr.allclose(bbox.max.x, 4)
+
+    for time, x, hit in [(0.0, 0.0, True), (1.0, 0.0, False),
+                         (1.0, 3.0, True), (0.5, 1.5, True), (0.5, 3.0, False)]:
+        ray = mi.Ray3f(o=[x + 0.2, 0.1, -8], d=[0.0, 0.0, 1.0],
+                       time=time, wavelengths=[])
+        assert scene.ray_test(ray) == hit
+
+        si = scene.ray_intersect(ray)
+        assert si.is_valid() == hit
+        if hit:
+            assert dr.allclose(si.p, [x + 0.2, 0.1, 0], atol=1e-5)
+            assert dr.allclose(si.uv, [0.6, 0.55], atol=1e-5)
+
+    with pytest.raises(RuntimeError, match='cannot be specified'):
+        mi.load_dict({
+            'type' : 'instance',
+            'group' : { 'type' : 'shapegroup', 'shape' : { 'type' : 'rectangle' } },
+            'to_world' : T(),
+            'to_world_0' : T(),
+        })
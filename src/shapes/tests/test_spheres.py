@@ -0,0 +1,72 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def create_spheres():
+    return mi.load_dict({
+        "type": "spheres",
+        "centers": mi.TensorXf([[0, 0, 0], [3, 0, 0], [0, 4, 0]]),
+        "radii": mi.TensorXf([1, 0.5, 2]),
+    })
+
+
+def test01_create(variant_scalar_rgb):
+    s = create_spheres()
+    assert s.primitive_count() == 3
+    assert dr.allclose(s.surface_area(), 4 * dr.pi * (1 + 0.25 + 4))
+
+    bbox = s.bbox()
+    assert dr.allclose(bbox.min, [-2, -1, -2])
+    assert dr.allclose(bbox.max, [3.5, 6, 2])
+    assert dr.allclose(s.bbox(1).min, [2.5, -0.5, -0.5])
+
+    with pytest.raises(RuntimeError, match="centers"):
+        mi.load_dict({"type": "spheres", "centers": mi.TensorXf([1, 2, 3, 4])})
+
+
+def test02_ray_intersect(variant_scalar_rgb):
+    scene = mi.load_dict({"type": "scene", "spheres": create_spheres()})
+
+    for prim_index, (o, t) in enumerate([([0, 0, -5], 4.0),
+                                         ([3, 0, -5], 4.5),
+                                         ([0, 4, -5], 3.0)]):
+        ray = mi.Ray3f(o, [0, 0, 1])
+        assert scene.ray_test(ray)
+
+        si = scene.ray_intersect(ray)
+        assert si.is_valid()
+        assert si.prim_index == prim_index
+        assert dr.allclose(si.t, t)
+        assert dr.allclose(si.n, [0, 0, -1])
+
+    assert not scene.ray_test(mi.Ray3f([1.6, 0, -5], [0, 0, 1]))
+
+    # Normal derivatives are those of the position, scaled by 1 / radius
+    si = scene.ray_intersect(mi.Ray3f([-5, 4, 0], [1, 0, 0]))
+    assert si.prim_index == 2
+    assert dr.allclose(si.dp_du, [0, -4 * dr.pi, 0])
+    assert dr.allclose(si.dn_du, [0, -2 * dr.pi, 0])
+    assert dr.allclose(si.dn_dv, [0, 0, -dr.pi])
+
+
+def test03_load_ply(variant_scalar_rgb, tmp_path):
+    filename = str(tmp_path / "spheres.ply")
+    with open(filename, "w") as f:
+        f.write("ply\nformat ascii 1.0\nelement vertex 2\n"
+                "property float x\nproperty float y\nproperty float z\n"
+                "end_header\n0 0 0\n1 2 3\n")
+
+    s = mi.load_dict({
+        "type": "spheres",
+        "filename": filename,
+        "radius": 0.5,
+        "to_world": mi.ScalarTransform4f().scale(2),
+    })
+
+    assert s.primitive_count() == 2
+    assert dr.allclose(s.bbox(1).min, [1, 3, 5])
+    assert dr.allclose(s.bbox(1).max, [3, 5, 7])
+
+    params = mi.traverse(s)
+    assert dr.allclose(params["data"], [0, 0, 0, 1, 2, 4, 6, 1])
@@ -24,9 +24,27 @@ Irregular spectrum (:monosp:`irregular`)
    - Values of the spectral function at the specified wavelengths.
    - |exposed|, |differentiable|
 
+ * - resample
+   - |float|
+   - When set to a positive wavelength spacing (in nanometers), the spectrum is
+     resampled at load time onto a regular grid with at most this spacing. (Default: 0, i.e.
+     no resampling)
+
 This spectrum returns linearly interpolated reflectance or emission values from *irregularly*
 placed samples.
 
+Evaluating an irregular spectrum requires a binary search over its wavelength
+nodes, i.e. a logarithmic number of dependent memory lookups per wavelength
+sample. Measured spectra (e.g. index of refraction or reflectance data) often
+have hundreds of nodes and are evaluated at every interaction in spectral
+variants. The ``resample`` parameter trades this search for the direct
+indexing used by the :ref:`regular <spectrum-regular>` spectrum (two lookups per
+sample). The maximum deviation of the resampled spectrum from the original
+data is reported in the log. Since the resampled spectrum is stored in the same
+way as a regular spectrum, it then exposes the ``range`` and ``values``
+parameters of the latter, and is only intended for spectra that are not
+differentiated.
+
 .. tabs::
     .. code-tab:: xml
         :name: irregular
@@ -50,6 +68,10 @@ public:
 
 public:
     IrregularSpectrum(const Properties &props) : Texture(props) {
+        m_resample = props.get<ScalarFloat>("resample", 0.f);
+        if (m_resample < 0.f)
+            Throw("The \"resample\" parameter must be non-negative!");
+
         if (props.has_property("value")) {
             const Properties::Spectrum *spec = props.try_get<Properties::Spectrum>("value");
             if (!spec)
@@ -67,6 +89,11 @@ public:
     }
 
     void init(const Properties::Spectrum &spec) {
+        if (m_resample > 0.f) {
+            resample(spec);
+            return;
+        }
+
         if constexpr (std::is_same_v<ScalarFloat, double>) {
             m_distr = IrregularContinuousDistribution<Wavelength>(
                 spec.wavelengths.data(), spec.values.data(), spec.values.size());
@@ -82,20 +109,84 @@ public:
         }
     }
 
+    /**
+     * \brief Linearly interpolate the spectrum onto a regular grid of
+     * wavelengths with a spacing of at most \c m_resample nanometers
+     *
+     * The resampled function is piecewise linear, hence its deviation from
+     * the (also piecewise linear) input is largest at the original nodes,
+     * where it is measured and logged.
+     */
+    void resample(const Properties::Spectrum &spec) {
+        const std::vector<double> &wavelengths = spec.wavelengths,
+                                  &values      = spec.values;
+        if (wavelengths.size() < 2 || wavelengths.size() != values.size())
+            Throw("IrregularSpectrum: expected at least two wavelength/value pairs!");
+
+        double lambda_min = wavelengths.front(), lambda_max = wavelengths.back();
+        if (!(lambda_max > lambda_min))
+            Throw("IrregularSpectrum: wavelengths must be increasing!");
+
+        size_t size = std::max((size_t) 2,
+            (size_t) std::ceil((lambda_max - lambda_min) / (double) m_resample) + 1);
+        double spacing = (lambda_max - lambda_min) / (double) (size - 1);
+
+        // Linear interpolation of the input at the regular grid positions
+        std::vector<double> resampled(size);
+        for (size_t i = 0, j = 0; i < size; ++i) {
+            double lambda = i + 1 < size ? lambda_min + i * spacing : lambda_max;
+            while (j + 2 < wavelengths.size() && wavelengths[j + 1] < lambda)
+                ++j;
+            double width = wavelengths[j + 1] - wavelengths[j],
+                   t = width > 0.0 ? (lambda - wavelengths[j]) / width : 0.0;
+            resampled[i] = dr::lerp(values[j], values[j + 1], dr::clip(t, 0.0, 1.0));
+        }
+
+        double error = 0.0, peak = 0.0;
+        for (size_t k = 0; k < wavelengths.size(); ++k) {
+            double pos = (wavelengths[k] - lambda_min) / spacing;
+            size_t idx = std::min((size_t) std::max(pos, 0.0), size - 2);
+            double value = dr::lerp(resampled[idx], resampled[idx + 1],
+                                    dr::clip(pos - (double) idx, 0.0, 1.0));
+            error = dr::maximum(error, dr::abs(value - values[k]));
+            peak  = dr::maximum(peak, dr::abs(values[k]));
+        }
+
+        Log(Info, "Resampled irregular spectrum with %zu nodes onto a regular "
+                  "grid of %zu samples (%.3g nm spacing), max. abs. error: %g "
+                  "(%.3g%% of the peak value)", wavelengths.size(), size, spacing,
+            error, peak > 0.0 ? 100.0 * error / peak : 0.0);
+
+        std::vector<ScalarFloat> resampled_f(resampled.begin(), resampled.end());
+        m_regular = ContinuousDistribution<Wavelength>(
+            ScalarVector2f((ScalarFloat) lambda_min, (ScalarFloat) lambda_max),
+            resampled_f.data(), resampled_f.size());
+    }
+
     void traverse(TraversalCallback *cb) override {
-        cb->put("wavelengths", m_distr.nodes(), ParamFlags::Differentiable);
-        cb->put("values",      m_distr.pdf(),   ParamFlags::Differentiable);
+        if (m_resample > 0.f) {
+            cb->put("range",  m_regular.range(), ParamFlags::NonDifferentiable);
+            cb->put("values", m_regular.pdf(),   ParamFlags::NonDifferentiable);
+        } else {
+            cb->put("wavelengths", m_distr.nodes(), ParamFlags::Differentiable);
+            cb->put("values",      m_distr.pdf(),   ParamFlags::Differentiable);
+        }
     }
 
     void parameters_changed(const std::vector<std::string> &/*keys*/) override {
-        m_distr.update();
+        if (m_resample > 0.f)
+            m_regular.update();
+        else
+            m_distr.update();
     }
 
     UnpolarizedSpectrum eval(const SurfaceInteraction3f &si, Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
 
         if constexpr (is_spectral_v<Spectrum>)
-            return m_distr.eval_pdf(si.wavelengths, active);
+            return dispatch([&](const auto &distr) {
+                return distr.eval_pdf(si.wavelengths, active);
+            });
         else {
             DRJIT_MARK_USED(si);
             NotImplementedError("eval");
@@ -106,7 +197,9 @@ public:
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
 
         if constexpr (is_spectral_v<Spectrum>)
-            return m_distr.eval_pdf_normalized(si.wavelengths, active);
+            return dispatch([&](const auto &distr) {
+                return distr.eval_pdf_normalized(si.wavelengths, active);
+            });
         else {
             DRJIT_MARK_USED(si);
             NotImplementedError("pdf");
@@ -119,7 +212,10 @@ public:
         MI_MASKED_FUNCTION(ProfilerPhase::TextureSample, active);
 
         if constexpr (is_spectral_v<Spectrum>)
-            return { m_distr.sample(sample, active), m_distr.integral() };
+            return dispatch([&](const auto &distr) {
+                return std::pair<Wavelength, UnpolarizedSpectrum>(
+                    distr.sample(sample, active), distr.integral());
+            });
         else {
             DRJIT_MARK_USED(sample);
             NotImplementedError("sample");
@@ -127,35 +223,54 @@ public:
     }
 
     Float mean() const override {
-        ScalarVector2f range = m_distr.range();
-        return m_distr.integral() / (range[1] - range[0]);
+        return dispatch([](const auto &distr) {
+            ScalarVector2f range = distr.range();
+            return distr.integral() / (range[1] - range[0]);
+        });
     }
 
     ScalarVector2f wavelength_range() const override {
-        return m_distr.range();
+        return dispatch([](const auto &distr) { return distr.range(); });
     }
 
     ScalarFloat spectral_resolution() const override {
-        return m_distr.interval_resolution();
+        return dispatch([](const auto &distr) { return distr.interval_resolution(); });
     }
 
     ScalarFloat max() const override {
-        return m_distr.max();
+        return dispatch([](const auto &distr) { return distr.max(); });
     }
 
     std::string to_string() const override {
         std::ostringstream oss;
-        oss << "IrregularSpectrum[" << std::endl
-            << "  distr = " << string::indent(m_distr) << std::endl
-            << "]";
+        oss << "IrregularSpectrum[" << std::endl;
+        if (m_resample > 0.f)
+            oss << "  resample = " << m_resample << "," << std::endl
+                << "  distr = " << string::indent(m_regular) << std::endl;
+        else
+            oss << "  distr = " << string::indent(m_distr) << std::endl;
+        oss << "]";
         return oss.str();
     }
 
     MI_DECLARE_CLASS(IrregularSpectrum)
+private:
+    /// Invoke \c func with the distribution used for evaluation
+    template <typename Func> auto dispatch(Func func) const {
+        if (m_resample > 0.f)
+            return func(m_regular);
+        else
+            return func(m_distr);
+    }
+
 private:
     IrregularContinuousDistribution<Wavelength> m_distr;
 
-    MI_TRAVERSE_CB(Texture, m_distr)
+    /// Regularly resampled spectrum (only used when \c m_resample > 0)
+    ContinuousDistribution<Wavelength> m_regular;
+    ScalarFloat m_resample;
+
+    MI_TRAVERSE_CB(Texture, m_distr, m_regular)
 };
 
 MI_EXPORT_PLUGIN(IrregularSpectrum)
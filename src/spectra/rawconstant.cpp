@@ -108,6 +108,10 @@ public:
         return dr::max_nested(m_value);
     }
 
+    bool is_constant() const override {
+        return dr::size_v<UnpolarizedSpectrum> == Channels || Channels == 1;
+    }
+
     void traverse(TraversalCallback *cb) override {
         cb->put("value", m_value, ParamFlags::Differentiable);
     }
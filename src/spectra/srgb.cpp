@@ -128,6 +128,9 @@ public:
             return dr::max_nested(m_value);
     }
 
+    // Spectral variants evaluate the upsampling model per wavelength
+    bool is_constant() const override { return !is_spectral_v<Spectrum>; }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "SRGBReflectanceSpectrum[" << std::endl
@@ -41,3 +41,36 @@ def test02_sample_spectrum(variant_scalar_spectral, obj):
         obj.sample_spectrum(si, .5),
         [576.777, 212.5]
     )
+
+
+def test03_resample(variant_scalar_spectral):
+    wavelengths = [400, 413, 450, 462.5, 530, 600, 655, 700]
+    values = [0.1, 0.7, 0.3, 0.9, 0.2, 0.5, 0.45, 0.8]
+
+    def load(**kwargs):
+        return mi.load_dict({
+            "type" : "irregular",
+            "wavelengths" : ", ".join(str(w) for w in wavelengths),
+            "values" : ", ".join(str(v) for v in values),
+            **kwargs
+        })
+
+    ref = load()
+    obj = load(resample=0.5)
+    assert 'range' in mi.traverse(obj)
+    assert dr.allclose(obj.wavelength_range(), ref.wavelength_range())
+
+    # The resampled grid contains all input nodes, hence the result is exact
+    si = mi.SurfaceInteraction3f()
+    for i in range(31):
+        si.wavelengths = 400 + 10 * i
+        assert dr.allclose(obj.eval(si), ref.eval(si), atol=1e-5)
+    assert dr.allclose(obj.mean(), ref.mean(), rtol=1e-4)
+
+    # A coarse grid smooths the sharp features
+    coarse = load(resample=50)
+    si.wavelengths = 413
+    assert not dr.allclose(coarse.eval(si), ref.eval(si))
+
+    with pytest.raises(RuntimeError, match='resample'):
+        load(resample=-1)
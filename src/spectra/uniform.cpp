@@ -123,6 +123,8 @@ public:
         return dr::slice(dr::max(m_value));
     }
 
+    bool is_constant() const override { return true; }
+
     std::string to_string() const override {
         return tfm::format("UniformSpectrum[value=%f]", m_value);
     }
@@ -59,6 +59,7 @@ public:
         m_color0 = props.get_texture<Texture>("color0", .4f);
         m_color1 = props.get_texture<Texture>("color1", .2f);
         m_transform = props.get<ScalarAffineTransform3f>("to_uv", ScalarAffineTransform3f());
+        parameters_changed();
     }
 
     void traverse(TraversalCallback *cb) override {
@@ -67,11 +68,30 @@ public:
         cb->put("color1", m_color1,    ParamFlags::Differentiable);
     }
 
+    void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override {
+        /* Fold constant colors, so that eval() reduces to a select instead
+           of two branches with virtual calls. JIT variants trace the nested
+           evaluations into the kernel anyway, and keep them to track
+           gradients of parameters that are enabled after loading. */
+        m_constant = !dr::is_jit_v<Float> && m_color0->is_constant() &&
+                     m_color1->is_constant();
+        if (m_constant) {
+            SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
+            m_value0 = m_color0->eval(si);
+            m_value1 = m_color1->eval(si);
+            dr::make_opaque(m_value0, m_value1);
+        }
+    }
+
     UnpolarizedSpectrum eval(const SurfaceInteraction3f &it, Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
 
         Point2f uv = m_transform * it.uv;
         dr::mask_t<Point2f> mask = uv - dr::floor(uv) > .5f;
+
+        if (m_constant)
+            return dr::select(mask.x() == mask.y(), m_value0, m_value1) & active;
+
         UnpolarizedSpectrum result = dr::zeros<UnpolarizedSpectrum>();
 
         Mask m0 = mask.x() == mask.y(),
@@ -131,6 +151,10 @@ protected:
     ref<Texture> m_color1;
     ScalarAffineTransform3f m_transform;
 
+    /// Folded values of 'm_color0' and 'm_color1' when both are constant
+    bool m_constant;
+    UnpolarizedSpectrum m_value0, m_value1;
+
     MI_TRAVERSE_CB(Texture, m_color0, m_color1)
 };
 
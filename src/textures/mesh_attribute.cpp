@@ -83,6 +83,9 @@ public:
             Throw("Invalid mesh attribute name: must be start with either \"vertex_\" or \"face_\" but was \"%s\".", m_name.c_str());
 
         m_scale = props.get<ScalarFloat>("scale", 1.f);
+
+        // Resolve the attribute name once instead of hashing it per query
+        m_id = Shape::attribute_id(m_name);
     }
 
     void traverse(TraversalCallback *cb) override {
@@ -93,17 +96,17 @@ public:
 
     UnpolarizedSpectrum eval(const SurfaceInteraction3f &si, Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
-        return si.shape->eval_attribute(m_name, si, active) * m_scale;
+        return si.shape->eval_attribute_by_id(m_id, si, active) * m_scale;
     }
 
     Float eval_1(const SurfaceInteraction3f &si, Mask active = true) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
-        return si.shape->eval_attribute_1(m_name, si, active) * m_scale;
+        return si.shape->eval_attribute_1_by_id(m_id, si, active) * m_scale;
     }
 
     Color3f eval_3(const SurfaceInteraction3f &si, Mask active = true) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
-        return si.shape->eval_attribute_3(m_name, si, active) * m_scale;
+        return si.shape->eval_attribute_3_by_id(m_id, si, active) * m_scale;
     }
 
     std::string to_string() const override {
@@ -118,6 +121,7 @@ public:
     MI_DECLARE_CLASS(MeshAttribute)
 protected:
     std::string m_name;
+    uint32_t m_id;
     float m_scale;
 };
 